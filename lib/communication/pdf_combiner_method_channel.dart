@@ -1,7 +1,14 @@
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
+import 'package:pdf_combiner/models/image_format.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 
 import '../models/pdf_from_multiple_image_config.dart';
 import 'pdf_combiner_platform_interface.dart';
@@ -17,6 +24,53 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
   @visibleForTesting
   final MethodChannel methodChannel = const MethodChannel('pdf_combiner');
 
+  /// The event channel on which the native platform reports progress.
+  @visibleForTesting
+  final EventChannel progressChannel =
+      const EventChannel('pdf_combiner/progress');
+
+  /// The Linux implementation loads PDFs straight from the channel buffers.
+  @override
+  bool get supportsInMemoryInputs =>
+      !kIsWeb && defaultTargetPlatform == TargetPlatform.linux;
+
+  /// The Linux and Windows implementations copy only the selected pages.
+  @override
+  bool get supportsPageRanges =>
+      !kIsWeb &&
+      (defaultTargetPlatform == TargetPlatform.linux ||
+          defaultTargetPlatform == TargetPlatform.windows);
+
+  /// Encodes an input for the channel: its bytes for a [BytesMergeInput],
+  /// its path otherwise.
+  Object? _channelValue(MergeInput input) => switch (input) {
+        BytesMergeInput(:final bytes) => bytes,
+        _ => input.path,
+      };
+
+  /// Adds the page selection of every input to a merge call, only when at
+  /// least one input has one, and the options of `config` that are set.
+  Map<String, Object?> _mergeArguments(List<MergeInput> inputs,
+      MergeConfig config, Map<String, Object?> arguments) {
+    if (inputs.any((input) => input.pages != null)) {
+      arguments['pageRanges'] = inputs.map((input) => input.pages).toList();
+    }
+    if (config.linearize) arguments['linearize'] = true;
+    if (config.streaming) arguments['streaming'] = true;
+    if (config.deduplicate) arguments['deduplicate'] = true;
+    if (config.compact) arguments['compact'] = true;
+    if (config.maxImageDpi != null || config.targetBytes != null) {
+      if (config.maxImageDpi != null) {
+        arguments['maxImageDpi'] = config.maxImageDpi;
+      }
+      if (config.targetBytes != null) {
+        arguments['targetBytes'] = config.targetBytes;
+      }
+      arguments['imageQuality'] = config.imageQuality;
+    }
+    return arguments;
+  }
+
   /// Merges multiple PDF files into a single PDF.
   ///
   /// This method sends a request to the native platform to merge the PDF files
@@ -24,7 +78,14 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
   ///
   /// Parameters:
   /// - `inputs`: A list of [MergeInput] objects representing the PDFs to be merged.
+  ///   [BytesMergeInput]s are sent as bytes, which only platforms with
+  ///   [supportsInMemoryInputs] can load. [MergeInput.pages] selections are
+  ///   sent as `pageRanges`.
   /// - `outputPath`: The directory path where the merged PDF should be saved.
+  /// - `config`: A configuration object that specifies how to write the merged
+  ///   PDF. `linearize`, `streaming`, `deduplicate` and `compact` are
+  ///   sent only when set; `maxImageDpi` and `targetBytes` only when given,
+  ///   along with `imageQuality`.
   ///
   /// Returns:
   /// - A `Future<String?>` representing the result of the operation. If the operation
@@ -33,11 +94,39 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) async {
-    final inputPaths = inputs.map((input) => input.path).toList();
+    final inputPaths = inputs.map(_channelValue).toList();
     final result = await methodChannel.invokeMethod<String>(
       'mergeMultiplePDF',
-      {'paths': inputPaths, 'outputDirPath': outputPath},
+      _mergeArguments(inputs, config,
+          {'paths': inputPaths, 'outputDirPath': outputPath}),
+    );
+    return result;
+  }
+
+  /// Merges multiple PDF files into a single PDF returned as bytes.
+  ///
+  /// This method sends the inputs to the native platform, which loads byte
+  /// inputs from memory and returns the merged document without writing it
+  /// to disk.
+  ///
+  /// Parameters:
+  /// - `inputs`: A list of [PathMergeInput] or [BytesMergeInput] objects representing the PDFs to be merged.
+  /// - `config`: A configuration object that specifies how to write the merged PDF.
+  ///
+  /// Returns:
+  /// - A `Future<Uint8List?>` with the bytes of the merged PDF, or `null` if
+  ///   the native platform returned nothing.
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) async {
+    final result = await methodChannel.invokeMethod<Uint8List>(
+      'mergeMultiplePDFToBytes',
+      _mergeArguments(
+          inputs, config, {'paths': inputs.map(_channelValue).toList()}),
     );
     return result;
   }
@@ -64,19 +153,23 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
     required String outputPath,
     PdfFromMultipleImageConfig config = const PdfFromMultipleImageConfig(),
   }) async {
-    final inputPaths = inputs.map((input) => input.path).toList();
     final result = await methodChannel.invokeMethod<String>(
       'createPDFFromMultipleImage',
+      _pdfFromImagesArguments(inputs, outputPath, config),
+    );
+    return result;
+  }
+
+  /// The arguments of a `createPDFFromMultipleImage` call.
+  Map<String, Object?> _pdfFromImagesArguments(List<MergeInput> inputs,
+          String outputPath, PdfFromMultipleImageConfig config) =>
       {
-        'paths': inputPaths,
+        'paths': inputs.map((input) => input.path).toList(),
         'outputDirPath': outputPath,
         'height': config.rescale.height,
         'width': config.rescale.width,
         'keepAspectRatio': config.keepAspectRatio,
-      },
-    );
-    return result;
-  }
+      };
 
   /// Creates images from a PDF file.
   ///
@@ -90,6 +183,9 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
   ///   - `rescale`: The scaling configuration for the images (default is the original image).
   ///   - `compression`: The image compression level for the images, affecting file size, quality and clarity (default is [ImageCompression.none]).
   ///   - `createOneImage`: Indicates whether to create a single image or separate images for each page (default is `true`).
+  ///   - `render`: The dpi or scale of the pages and the limits of their size in pixels.
+  ///   - `outputFormat`: The file format of the images (default is [ImageFormat.png]).
+  ///   - `jobId`: An optional identifier that allows the operation to be cancelled with [cancel].
   ///
   /// Returns:
   /// - A `Future<List<String>?>` representing a list of image file paths. If the operation
@@ -102,6 +198,14 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
   }) async {
     final result = await methodChannel.invokeMethod<List<dynamic>>(
       'createImageFromPDF',
+      _imagesFromPdfArguments(input, outputPath, config),
+    );
+    return result?.cast<String>();
+  }
+
+  /// The arguments of a `createImageFromPDF` call.
+  Map<String, Object?> _imagesFromPdfArguments(
+          MergeInput input, String outputPath, ImageFromPdfConfig config) =>
       {
         'path': input.path,
         'outputDirPath': outputPath,
@@ -109,8 +213,212 @@ class MethodChannelPdfCombiner extends PdfCombinerPlatform {
         'width': config.rescale.width,
         'compression': config.compression.value,
         'createOneImage': config.createOneImage,
+        ...config.render.toMap(),
+        if (config.outputFormat != ImageFormat.png)
+          'outputFormat': config.outputFormat.value,
+        if (config.jobId != null) 'jobId': config.jobId,
+      };
+
+  /// Renders the pages of a PDF file to images returned in memory.
+  ///
+  /// The Linux implementation encodes the pages on background threads and
+  /// sends them back in the response, without writing any file.
+  ///
+  /// Parameters:
+  /// - `input`: The [MergeInput] object representing the PDF.
+  /// - `config`: The size, compression and format of the images; `createOneImage` is ignored.
+  /// - `pages`: The pages to render, like `1-3,7` (default is all of them).
+  ///
+  /// Returns:
+  /// - A `Future<List<RenderedPage>>` with one image per page, in the order
+  ///   of `pages`.
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) async {
+    final arguments = _imagesFromPdfArguments(input, '', config)
+      ..remove('outputDirPath')
+      ..remove('createOneImage');
+    final result = await methodChannel.invokeMethod<List<dynamic>>(
+      'createImageFromPDFToBytes',
+      {...arguments, if (pages != null) 'pages': pages},
+    );
+    return (result ?? const [])
+        .map((item) => RenderedPage.fromMap(item as Map))
+        .toList();
+  }
+
+  /// Creates a thumbnail of each page of a PDF file.
+  ///
+  /// The Linux implementation uses the thumbnail images a PDF may store for
+  /// its pages, and only renders the pages that have none.
+  ///
+  /// Parameters:
+  /// - `input`: The [MergeInput] object representing the PDF.
+  /// - `outputPath`: The directory path where the thumbnails should be saved.
+  /// - `config`: A configuration object that specifies the thumbnails.
+  ///   - `maxSize`: The largest side of a thumbnail in pixels (default is `256`).
+  ///   - `compression`: The image compression level for the thumbnails (default is [ImageCompression.none]).
+  ///   - `pages`: The pages to create thumbnails of, like `1-3,7` (default is all of them).
+  ///   - `jobId`: An optional identifier that allows the operation to be cancelled with [cancel].
+  ///
+  /// Returns:
+  /// - A `Future<List<String>?>` with the paths of the thumbnails, in page order.
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) async {
+    final result = await methodChannel.invokeMethod<List<dynamic>>(
+      'createThumbnailsFromPDF',
+      {
+        'path': input.path,
+        'outputDirPath': outputPath,
+        'maxSize': config.maxSize,
+        'compression': config.compression.value,
+        if (config.pages != null) 'pages': config.pages,
+        if (config.jobId != null) 'jobId': config.jobId,
       },
     );
     return result?.cast<String>();
   }
+
+  /// Runs several operations in one `runBatch` call.
+  ///
+  /// Each job is sent as the method and arguments of the call it stands for,
+  /// and the Linux implementation opens an input file used by several jobs
+  /// only once. Platforms without `runBatch` fall back to running the jobs
+  /// one by one.
+  ///
+  /// Parameters:
+  /// - `jobs`: The operations to run, in order.
+  /// - `jobId`: An optional identifier that allows the jobs that have not
+  ///   started yet to be cancelled with [cancel].
+  ///
+  /// Returns:
+  /// - A `Future<List<BatchJobResult>>` with one result per job.
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) async {
+    try {
+      final result = await methodChannel.invokeMethod<List<dynamic>>(
+        'runBatch',
+        {
+          'jobs': jobs.map(_batchJobValue).toList(),
+          if (jobId != null) 'jobId': jobId,
+        },
+      );
+      return (result ?? const [])
+          .map((item) => BatchJobResult.fromMap(item as Map))
+          .toList();
+    } on MissingPluginException {
+      return super.runBatch(jobs, jobId: jobId);
+    }
+  }
+
+  /// Encodes a job as the method and arguments of its own call.
+  Map<String, Object?> _batchJobValue(BatchJob job) => switch (job) {
+        MergeBatchJob() => {
+            'method': 'mergeMultiplePDF',
+            'arguments': _mergeArguments(job.inputs, job.config, {
+              'paths': job.inputs.map(_channelValue).toList(),
+              'outputDirPath': job.outputPath,
+            }),
+          },
+        MergeToBytesBatchJob() => {
+            'method': 'mergeMultiplePDFToBytes',
+            'arguments': _mergeArguments(job.inputs, job.config,
+                {'paths': job.inputs.map(_channelValue).toList()}),
+          },
+        PdfFromImagesBatchJob() => {
+            'method': 'createPDFFromMultipleImage',
+            'arguments':
+                _pdfFromImagesArguments(job.inputs, job.outputPath, job.config),
+          },
+        ImagesFromPdfBatchJob() => {
+            'method': 'createImageFromPDF',
+            'arguments':
+                _imagesFromPdfArguments(job.input, job.outputDirPath, job.config),
+          },
+      };
+
+  /// Progress events of the running native operations.
+  ///
+  /// The native side sends at most one event every 100 ms per operation,
+  /// plus a last one with [PdfCombinerProgress.finished] set. Operations only
+  /// report progress while the stream has a listener.
+  @override
+  Stream<PdfCombinerProgress> get progressStream => progressChannel
+      .receiveBroadcastStream()
+      .map((event) => PdfCombinerProgress.fromMap(event as Map));
+
+  /// Cancels the running operation started with the given `jobId`.
+  ///
+  /// The native side stops between pages and the cancelled call completes
+  /// with a `cancelled` error; partial output files are removed.
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if a running operation was found, and
+  ///   `false` otherwise or if the native platform does not support it.
+  @override
+  Future<bool> cancel(String jobId) async {
+    try {
+      final result = await methodChannel.invokeMethod<bool>(
+        'cancel',
+        {'jobId': jobId},
+      );
+      return result ?? false;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+
+  /// Sets the budget of the cache of open input documents.
+  ///
+  /// Only the options given are sent; the native side uses its defaults for
+  /// the others. A `maxDocuments` of 0 disables the cache.
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if the platform has a document cache.
+  @override
+  Future<bool> configureDocumentCache(
+      {int? maxDocuments, int? maxBytes}) async {
+    try {
+      final result = await methodChannel.invokeMethod<bool>(
+        'configureDocumentCache',
+        {
+          if (maxDocuments != null) 'maxDocuments': maxDocuments,
+          if (maxBytes != null) 'maxBytes': maxBytes,
+        },
+      );
+      return result ?? false;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+
+  /// Returns diagnostic counters from the native platform.
+  ///
+  /// On Linux the map contains the state of the worker pool that runs the
+  /// method calls (`workers`, `queueDepth`, `queueCapacity` and `runningJobs`)
+  /// and of the document cache (`documentCacheHits`, `documentCacheMisses`,
+  /// `documentCacheEvictions`, `documentCacheDocuments` and
+  /// `documentCacheBytes`).
+  ///
+  /// Returns:
+  /// - A `Future<Map<String, Object?>?>` with the counters, or `null` if the
+  ///   native platform does not report any.
+  @override
+  Future<Map<String, Object?>?> getNativeStats() async {
+    try {
+      return await methodChannel.invokeMapMethod<String, Object?>(
+        'getNativeStats',
+      );
+    } on MissingPluginException {
+      return null;
+    }
+  }
 }
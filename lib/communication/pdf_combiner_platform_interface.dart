@@ -1,5 +1,14 @@
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
 import '../models/pdf_from_multiple_image_config.dart';
@@ -33,6 +42,18 @@ abstract class PdfCombinerPlatform extends PlatformInterface {
     _instance = instance;
   }
 
+  /// Whether [mergeMultiplePDFs] accepts [BytesMergeInput]s directly.
+  ///
+  /// When `true`, byte inputs are handed to the platform as they are instead
+  /// of being written to temporary files first. Defaults to `false`.
+  bool get supportsInMemoryInputs => false;
+
+  /// Whether [mergeMultiplePDFs] honors [MergeInput.pages].
+  ///
+  /// When `false`, merges with a page selection are rejected instead of
+  /// silently taking every page. Defaults to `false`.
+  bool get supportsPageRanges => false;
+
   /// Combines multiple PDFs into a single PDF.
   ///
   /// Platform-specific implementations should override this method to merge
@@ -41,6 +62,14 @@ abstract class PdfCombinerPlatform extends PlatformInterface {
   /// Parameters:
   /// - `inputs`: A list of [MergeInput] objects representing the PDFs to be merged.
   /// - `outputPath`: The directory path where the merged PDF should be saved.
+  /// - `config`: A configuration object that specifies how to write the merged PDF.
+  ///   - `linearize`: Indicates whether to write a linearized PDF (default is `false`).
+  ///   - `streaming`: Indicates whether to write the PDF while merging (default is `false`).
+  ///   - `deduplicate`: Indicates whether to store identical streams once (default is `false`).
+  ///   - `compact`: Indicates whether to use object streams and drop unused objects (default is `false`).
+  ///   - `maxImageDpi`: The highest resolution kept for raster images (default is `null`).
+  ///   - `targetBytes`: The size the merged PDF should fit in by recompressing images (default is `null`).
+  ///   - `imageQuality`: The JPEG quality of recompressed images (default is `75`).
   ///
   /// Returns:
   /// - A `Future<String?>` representing the result of the operation. By default,
@@ -48,10 +77,31 @@ abstract class PdfCombinerPlatform extends PlatformInterface {
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) {
     throw UnimplementedError('mergeMultiplePDF() has not been implemented.');
   }
 
+  /// Combines multiple PDFs into a single PDF kept in memory.
+  ///
+  /// Platform-specific implementations should override this method to merge
+  /// the inputs without writing the result to disk.
+  ///
+  /// Parameters:
+  /// - `inputs`: A list of [PathMergeInput] or [BytesMergeInput] objects representing the PDFs to be merged.
+  /// - `config`: A configuration object that specifies how to write the merged PDF.
+  ///
+  /// Returns:
+  /// - A `Future<Uint8List?>` with the bytes of the merged PDF. By default,
+  ///   this throws an [UnimplementedError].
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    throw UnimplementedError(
+        'mergeMultiplePDFToBytes() has not been implemented.');
+  }
+
   /// Creates a PDF from multiple image files.
   ///
   /// This method sends a request to the native platform to create a PDF from the
@@ -100,4 +150,137 @@ abstract class PdfCombinerPlatform extends PlatformInterface {
   }) {
     throw UnimplementedError('createImageFromPDF() has not been implemented.');
   }
+
+  /// Renders the pages of a PDF file to images in memory.
+  ///
+  /// Platform-specific implementations should override this method to return
+  /// the images instead of writing them to files.
+  ///
+  /// Parameters:
+  /// - `input`: The [MergeInput] object representing the PDF.
+  /// - `config`: The size and format of the images, as for
+  ///   [createImageFromPDF]; `createOneImage` is ignored.
+  /// - `pages`: The pages to render, like `1-3,7`, or all of them when `null`.
+  ///
+  /// Returns:
+  /// - A `Future<List<RenderedPage>>` with one image per page. By default,
+  ///   this throws an [UnimplementedError].
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    throw UnimplementedError(
+        'createImageFromPDFToBytes() has not been implemented.');
+  }
+
+  /// Creates a small image of each page of a PDF file.
+  ///
+  /// Platform-specific implementations should override this method to save
+  /// one thumbnail per page, preferring the thumbnails stored in the PDF to
+  /// rendering the pages.
+  ///
+  /// Parameters:
+  /// - `input`: The [MergeInput] object representing the PDF.
+  /// - `outputPath`: The directory path where the thumbnails should be saved.
+  /// - `config`: A [ThumbnailConfig] with the size, compression and pages of
+  ///   the thumbnails.
+  ///
+  /// Returns:
+  /// - A `Future<List<String>?>` representing a list of image file paths. By default,
+  ///   this throws an [UnimplementedError].
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    throw UnimplementedError(
+        'createThumbnailsFromPDF() has not been implemented.');
+  }
+
+  /// Runs several operations in one call, returning one result per job in
+  /// the same order.
+  ///
+  /// Platform-specific implementations may override this method to run the
+  /// jobs natively in a single round-trip. By default the jobs are run one by
+  /// one with the methods above, and the error of a failed job is reported in
+  /// its result.
+  ///
+  /// Parameters:
+  /// - `jobs`: The operations to run, in order.
+  /// - `jobId`: An optional identifier that allows the jobs that have not
+  ///   started yet to be cancelled with [cancel], where supported.
+  ///
+  /// Returns:
+  /// - A `Future<List<BatchJobResult>>` with one result per job.
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) async {
+    final results = <BatchJobResult>[];
+    for (final job in jobs) {
+      try {
+        results.add(BatchJobResult.success(await switch (job) {
+          MergeBatchJob() => mergeMultiplePDFs(
+              inputs: job.inputs,
+              outputPath: job.outputPath,
+              config: job.config),
+          MergeToBytesBatchJob() =>
+            mergeMultiplePDFsToBytes(inputs: job.inputs, config: job.config),
+          PdfFromImagesBatchJob() => createPDFFromMultipleImages(
+              inputs: job.inputs,
+              outputPath: job.outputPath,
+              config: job.config),
+          ImagesFromPdfBatchJob() => createImageFromPDF(
+              input: job.input,
+              outputPath: job.outputDirPath,
+              config: job.config),
+        }));
+      } on PlatformException catch (e) {
+        results.add(BatchJobResult.failure(e.code, e.message));
+      } catch (e) {
+        results.add(BatchJobResult.failure('error', e.toString()));
+      }
+    }
+    return results;
+  }
+
+  /// Progress events of the running native operations.
+  ///
+  /// Returns:
+  /// - A broadcast `Stream<PdfCombinerProgress>`. By default, this throws an
+  ///   [UnimplementedError].
+  Stream<PdfCombinerProgress> get progressStream {
+    throw UnimplementedError('progressStream has not been implemented.');
+  }
+
+  /// Cancels the running operation started with the given `jobId`.
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if an operation was cancelled. By default,
+  ///   this throws an [UnimplementedError].
+  Future<bool> cancel(String jobId) {
+    throw UnimplementedError('cancel() has not been implemented.');
+  }
+
+  /// Sets how many input documents the native implementation keeps open
+  /// between calls, and how many bytes of input files they may map.
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if the platform has such a cache. By
+  ///   default, this throws an [UnimplementedError].
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) {
+    throw UnimplementedError(
+        'configureDocumentCache() has not been implemented.');
+  }
+
+  /// Returns diagnostic counters from the native implementation.
+  ///
+  /// Platform-specific implementations may override this method to report
+  /// their internal state, such as the number of queued operations.
+  ///
+  /// Returns:
+  /// - A `Future<Map<String, Object?>?>` with the counters. By default,
+  ///   this throws an [UnimplementedError].
+  Future<Map<String, Object?>?> getNativeStats() {
+    throw UnimplementedError('getNativeStats() has not been implemented.');
+  }
 }
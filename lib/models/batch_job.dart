@@ -0,0 +1,93 @@
+import 'image_from_pdf_config.dart';
+import 'merge_config.dart';
+import 'merge_input.dart';
+import 'pdf_from_multiple_image_config.dart';
+
+/// One operation of a batch run with `PdfCombiner.runBatch`.
+///
+/// Each kind of job takes the same parameters as the call it stands for.
+/// Inputs are sent as they are: use [MergeInput.path] inputs, or
+/// [MergeInput.bytes] ones for merges on platforms with
+/// `PdfCombinerPlatform.supportsInMemoryInputs`.
+sealed class BatchJob {
+  const BatchJob();
+
+  /// A job merging PDFs into [outputPath], like `PdfCombiner.mergeMultiplePDFs`.
+  const factory BatchJob.merge({
+    required List<MergeInput> inputs,
+    required String outputPath,
+    MergeConfig config,
+  }) = MergeBatchJob;
+
+  /// A job merging PDFs into bytes, like `PdfCombiner.mergeMultiplePDFsToBytes`.
+  const factory BatchJob.mergeToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config,
+  }) = MergeToBytesBatchJob;
+
+  /// A job creating a PDF from images, like
+  /// `PdfCombiner.createPDFFromMultipleImages`.
+  const factory BatchJob.createPDFFromMultipleImages({
+    required List<MergeInput> inputs,
+    required String outputPath,
+    PdfFromMultipleImageConfig config,
+  }) = PdfFromImagesBatchJob;
+
+  /// A job rendering the pages of a PDF to images, like
+  /// `PdfCombiner.createImageFromPDF`.
+  const factory BatchJob.createImageFromPDF({
+    required MergeInput input,
+    required String outputDirPath,
+    ImageFromPdfConfig config,
+  }) = ImagesFromPdfBatchJob;
+}
+
+/// A [BatchJob] merging PDFs into a file.
+class MergeBatchJob extends BatchJob {
+  final List<MergeInput> inputs;
+  final String outputPath;
+  final MergeConfig config;
+
+  const MergeBatchJob({
+    required this.inputs,
+    required this.outputPath,
+    this.config = const MergeConfig(),
+  });
+}
+
+/// A [BatchJob] merging PDFs into bytes.
+class MergeToBytesBatchJob extends BatchJob {
+  final List<MergeInput> inputs;
+  final MergeConfig config;
+
+  const MergeToBytesBatchJob({
+    required this.inputs,
+    this.config = const MergeConfig(),
+  });
+}
+
+/// A [BatchJob] creating a PDF from images.
+class PdfFromImagesBatchJob extends BatchJob {
+  final List<MergeInput> inputs;
+  final String outputPath;
+  final PdfFromMultipleImageConfig config;
+
+  const PdfFromImagesBatchJob({
+    required this.inputs,
+    required this.outputPath,
+    this.config = const PdfFromMultipleImageConfig(),
+  });
+}
+
+/// A [BatchJob] rendering the pages of a PDF to images.
+class ImagesFromPdfBatchJob extends BatchJob {
+  final MergeInput input;
+  final String outputDirPath;
+  final ImageFromPdfConfig config;
+
+  const ImagesFromPdfBatchJob({
+    required this.input,
+    required this.outputDirPath,
+    this.config = const ImageFromPdfConfig(),
+  });
+}
@@ -0,0 +1,44 @@
+import 'batch_job.dart';
+
+/// The outcome of one [BatchJob] of a batch.
+///
+/// A failed job does not stop the batch: its error is reported here and the
+/// next jobs still run.
+class BatchJobResult {
+  /// Whether the job succeeded.
+  final bool success;
+
+  /// What the equivalent single call returns: the output path (`String`) of
+  /// merges and PDFs created from images, the merged bytes (`Uint8List`) of
+  /// merges to bytes, and the image paths (`List<String>`) of renders.
+  final Object? result;
+
+  /// The error code of a failed job, such as `document_loading_failed` or
+  /// `cancelled`.
+  final String? errorCode;
+
+  /// The error message of a failed job.
+  final String? errorMessage;
+
+  /// Creates the result of a job that succeeded.
+  const BatchJobResult.success(this.result)
+      : success = true,
+        errorCode = null,
+        errorMessage = null;
+
+  /// Creates the result of a job that failed.
+  const BatchJobResult.failure(String this.errorCode, [this.errorMessage])
+      : success = false,
+        result = null;
+
+  /// Creates an instance of [BatchJobResult] from a platform result.
+  factory BatchJobResult.fromMap(Map<Object?, Object?> map) {
+    if (map['success'] == true) {
+      final result = map['result'];
+      return BatchJobResult.success(
+          result is List ? result.cast<String>() : result);
+    }
+    return BatchJobResult.failure(
+        map['code'] as String? ?? 'error', map['message'] as String?);
+  }
+}
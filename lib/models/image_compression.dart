@@ -1,4 +1,7 @@
 /// Represents the compression level of an image, which affects quality and file size.
+///
+/// PNG output stays lossless: on Linux and Windows the value selects how much
+/// effort the encoder spends, from fastest ([none]) to smallest files ([high]).
 class ImageCompression {
   /// The compression value, typically ranging from 0 to 100.
   final int value;
@@ -0,0 +1,25 @@
+import 'image_compression.dart';
+
+/// The file format of the images created from the pages of a PDF.
+enum ImageFormat {
+  /// Lossless PNG with transparency, the default.
+  png('png'),
+
+  /// JPEG on a white background. [ImageCompression] sets its quality, from
+  /// 95 for [ImageCompression.none] down to 40 for [ImageCompression.high].
+  jpeg('jpeg'),
+
+  /// The rendered BGRA pixels without a header, as `image_<page>_<width>x<height>.bgra`.
+  bgra('bgra'),
+
+  /// Binary RGB portable pixmap (PPM) on a white background.
+  ppm('ppm'),
+
+  /// Binary grayscale portable graymap (PGM) on a white background.
+  pgm('pgm');
+
+  /// The name sent to the native platform.
+  final String value;
+
+  const ImageFormat(this.value);
+}
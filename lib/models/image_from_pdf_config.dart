@@ -1,25 +1,43 @@
 import 'image_compression.dart';
+import 'image_format.dart';
 import 'image_scale.dart';
+import 'render_config.dart';
 
 /// Configuration for generating images from a PDF.
 class ImageFromPdfConfig {
   /// The scale to apply to the images when generating the PDF.
   final ImageScale rescale;
 
+  /// The resolution and pixel limits of the rendered pages, used when
+  /// [rescale] is [ImageScale.original] (Linux).
+  final RenderConfig render;
+
   /// The image compression level for compression, affecting file size, quality and clarity.
   final ImageCompression compression;
 
   /// Indicates whether to create a single image or separate images for each page.
   final bool createOneImage;
 
+  /// The file format of the images (Linux; other platforms write PNG).
+  final ImageFormat outputFormat;
+
+  /// Identifies the operation so it can be stopped with [PdfCombiner.cancel].
+  final String? jobId;
+
   /// Creates an instance of [ImageFromPdfConfig].
   ///
   /// [rescale] allows specifying a scaling option for the images.
+  /// [render] sets the dpi or scale of the pages and limits their size, keeping their aspect ratio.
   /// [compression] sets the compression level for the images, affecting file size and quality, defaulting to [ImageCompression.none].
   /// [createOneImage] determines if a single image should be created or separate images for each page. Default is `false`.
+  /// [outputFormat] sets the file format of the images, defaulting to [ImageFormat.png].
+  /// [jobId] is an optional identifier used to cancel the operation while it runs.
   const ImageFromPdfConfig({
     ImageScale? rescale,
+    this.render = const RenderConfig(),
     this.compression = ImageCompression.none,
     this.createOneImage = false,
+    this.outputFormat = ImageFormat.png,
+    this.jobId,
   }) : rescale = rescale ?? ImageScale.original;
 }
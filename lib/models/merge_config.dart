@@ -0,0 +1,80 @@
+/// Configuration for merging PDFs.
+class MergeConfig {
+  /// Indicates whether to write a linearized ("fast web view") PDF.
+  ///
+  /// A linearized file starts with its first page and carries hint tables, so
+  /// viewers can show it, and seek to any other page, before the whole file
+  /// has been downloaded. Honored on Linux; other platforms write a regular
+  /// PDF.
+  final bool linearize;
+
+  /// Indicates whether to write the merged PDF while it is being merged.
+  ///
+  /// Each page is copied from its input and written to the output right
+  /// away, instead of building the whole merged document in memory first, so
+  /// memory use stays flat however many inputs there are. Outlines and forms
+  /// of the inputs are not carried over, as with a regular merge. A
+  /// [linearize]d output is still laid out in memory once merged. Honored on
+  /// Linux; other platforms merge in memory.
+  final bool streaming;
+
+  /// Indicates whether to store identical streams only once.
+  ///
+  /// Inputs made by the same generator usually embed the same fonts, images
+  /// and ICC profiles. With this set, each such stream is written once and
+  /// shared by every page that uses it, which can make merges of many similar
+  /// documents much smaller and faster to write. Implies [streaming]. Honored
+  /// on Linux; other platforms keep every copy.
+  final bool deduplicate;
+
+  /// Indicates whether to write a compact PDF.
+  ///
+  /// Objects are packed into compressed object streams with a compressed
+  /// cross-reference stream (PDF 1.5), and objects nothing refers to are
+  /// dropped. This mostly helps merges of many small PDFs, whose output is
+  /// dominated by small dictionaries. Ignored when [linearize] is set.
+  /// Honored on Linux; other platforms write a regular PDF.
+  final bool compact;
+
+  /// The highest resolution, in dots per inch at the size they are drawn,
+  /// kept for raster images, or `null` to keep them as they are.
+  ///
+  /// Larger photos and scans are downsampled and re-encoded as JPEG at
+  /// [imageQuality]. Black and white scans, palette images and images with
+  /// transparency are left as they are. Implies [streaming]. Honored on
+  /// Linux; other platforms keep the images.
+  final int? maxImageDpi;
+
+  /// The size, in bytes, the merged PDF should fit in, or `null` for no
+  /// target.
+  ///
+  /// When the inputs add up to more, raster images are re-encoded as JPEG and
+  /// downsampled evenly, down to 72 dpi, until the output should fit. Text,
+  /// fonts and vector graphics are not touched, so the target may still be
+  /// missed. Implies [streaming]. Honored on Linux; other platforms keep the
+  /// images.
+  final int? targetBytes;
+
+  /// The JPEG quality, from 1 to 100, of images re-encoded for [maxImageDpi]
+  /// or [targetBytes].
+  final int imageQuality;
+
+  /// Creates an instance of [MergeConfig].
+  ///
+  /// [linearize] determines if the merged PDF is linearized, defaulting to `false`.
+  /// [streaming] determines if the merged PDF is written incrementally, defaulting to `false`.
+  /// [deduplicate] determines if identical streams are stored once, defaulting to `false`.
+  /// [compact] determines if the merged PDF uses object streams, defaulting to `false`.
+  /// [maxImageDpi] determines the highest image resolution kept, defaulting to `null`.
+  /// [targetBytes] determines the size the merged PDF should fit in, defaulting to `null`.
+  /// [imageQuality] determines the quality of re-encoded images, defaulting to `75`.
+  const MergeConfig({
+    this.linearize = false,
+    this.streaming = false,
+    this.deduplicate = false,
+    this.compact = false,
+    this.maxImageDpi,
+    this.targetBytes,
+    this.imageQuality = 75,
+  }) : assert(imageQuality >= 1 && imageQuality <= 100);
+}
@@ -10,17 +10,27 @@ enum MergeInputType {
 /// A class representing an input for merging PDFs.
 ///
 /// It can be created from a file path, a byte array, or a URL.
+///
+/// A merge can take only some pages of an input with [pages], a selection such
+/// as `"1-3,7,10-"`: pages are numbered from 1, `"10-"` runs to the last page
+/// and `"-3"` starts at the first one. Only the selected pages are copied, in
+/// the order given.
 sealed class MergeInput {
-  const MergeInput();
+  const MergeInput({this.pages});
 
   /// Creates a [MergeInput] from a file path.
-  factory MergeInput.path(String path) = PathMergeInput;
+  factory MergeInput.path(String path, {String? pages}) = PathMergeInput;
 
   /// Creates a [MergeInput] from a byte array.
-  factory MergeInput.bytes(Uint8List bytes) = BytesMergeInput;
+  factory MergeInput.bytes(Uint8List bytes, {String? pages}) = BytesMergeInput;
 
   /// Creates a [MergeInput] from a URL.
-  factory MergeInput.url(String url) = UrlMergeInput;
+  factory MergeInput.url(String url, {String? pages}) = UrlMergeInput;
+
+  /// The pages to take from this input when merging, or `null` for all of
+  /// them. Honored on platforms with `PdfCombinerPlatform.supportsPageRanges`,
+  /// currently Linux and Windows.
+  final String? pages;
 
   /// Gets the type of input.
   MergeInputType get type;
@@ -40,7 +50,7 @@ class PathMergeInput extends MergeInput {
   @override
   final String path;
 
-  const PathMergeInput(this.path);
+  const PathMergeInput(this.path, {super.pages});
 
   @override
   MergeInputType get type => MergeInputType.path;
@@ -54,7 +64,7 @@ class BytesMergeInput extends MergeInput {
   @override
   final Uint8List bytes;
 
-  const BytesMergeInput(this.bytes);
+  const BytesMergeInput(this.bytes, {super.pages});
 
   @override
   MergeInputType get type => MergeInputType.bytes;
@@ -68,7 +78,7 @@ class UrlMergeInput extends MergeInput {
   @override
   final String url;
 
-  const UrlMergeInput(this.url);
+  const UrlMergeInput(this.url, {super.pages});
 
   @override
   MergeInputType get type => MergeInputType.url;
@@ -0,0 +1,62 @@
+/// Progress of a running native operation, as sent on the progress stream.
+class PdfCombinerProgress {
+  /// The method channel call being reported, such as `mergeMultiplePDF`.
+  final String method;
+
+  /// The identifier given to the operation, if any.
+  final String? jobId;
+
+  /// The number of input documents (or images) processed so far.
+  final int documentsDone;
+
+  /// The number of input documents (or images) of the operation.
+  final int documentCount;
+
+  /// The number of pages processed so far.
+  final int pagesDone;
+
+  /// The number of pages of the inputs opened so far. For merges it grows as
+  /// each input is opened.
+  final int totalPages;
+
+  /// The number of output bytes written so far.
+  final int bytesWritten;
+
+  /// The time since the operation started.
+  final Duration elapsed;
+
+  /// Whether this is the last event of the operation.
+  final bool finished;
+
+  /// Creates an instance of [PdfCombinerProgress].
+  const PdfCombinerProgress({
+    required this.method,
+    this.jobId,
+    this.documentsDone = 0,
+    this.documentCount = 0,
+    this.pagesDone = 0,
+    this.totalPages = 0,
+    this.bytesWritten = 0,
+    this.elapsed = Duration.zero,
+    this.finished = false,
+  });
+
+  /// Creates an instance of [PdfCombinerProgress] from a platform event.
+  factory PdfCombinerProgress.fromMap(Map<Object?, Object?> map) {
+    return PdfCombinerProgress(
+      method: map['method'] as String? ?? '',
+      jobId: map['jobId'] as String?,
+      documentsDone: map['documentsDone'] as int? ?? 0,
+      documentCount: map['documentCount'] as int? ?? 0,
+      pagesDone: map['pagesDone'] as int? ?? 0,
+      totalPages: map['totalPages'] as int? ?? 0,
+      bytesWritten: map['bytesWritten'] as int? ?? 0,
+      elapsed: Duration(microseconds: map['elapsedMicros'] as int? ?? 0),
+      finished: map['finished'] as bool? ?? false,
+    );
+  }
+
+  /// The fraction of pages processed, between 0 and 1, or `null` while the
+  /// total is unknown.
+  double? get fraction => totalPages > 0 ? pagesDone / totalPages : null;
+}
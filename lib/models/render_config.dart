@@ -0,0 +1,50 @@
+/// How large the pages of a PDF are rendered, in pixels.
+///
+/// A page is rendered at [dpi] (or [scale] times its size in points, which is
+/// 72 dpi), then shrunk, keeping its aspect ratio, to fit [maxWidth] x
+/// [maxHeight] and to have at most [maxPixels] pixels. Limits only shrink
+/// pages.
+class RenderConfig {
+  /// The resolution to render at, in dots per inch. Takes precedence over
+  /// [scale].
+  final double? dpi;
+
+  /// The number of pixels per PDF point, `1` when neither this nor [dpi] is set.
+  final double? scale;
+
+  /// The largest width of a rendered page, in pixels.
+  final int? maxWidth;
+
+  /// The largest height of a rendered page, in pixels.
+  final int? maxHeight;
+
+  /// The largest number of pixels of a rendered page.
+  final int? maxPixels;
+
+  /// Creates an instance of [RenderConfig].
+  ///
+  /// Every value is optional and must be greater than 0 when set.
+  const RenderConfig({
+    this.dpi,
+    this.scale,
+    this.maxWidth,
+    this.maxHeight,
+    this.maxPixels,
+  })  : assert(dpi == null || dpi > 0, 'dpi must be greater than 0.'),
+        assert(scale == null || scale > 0, 'scale must be greater than 0.'),
+        assert(maxWidth == null || maxWidth > 0,
+            'maxWidth must be greater than 0.'),
+        assert(maxHeight == null || maxHeight > 0,
+            'maxHeight must be greater than 0.'),
+        assert(maxPixels == null || maxPixels > 0,
+            'maxPixels must be greater than 0.');
+
+  /// The arguments of the native render size, only those that are set.
+  Map<String, Object> toMap() => {
+        if (dpi != null) 'dpi': dpi!,
+        if (scale != null) 'scale': scale!,
+        if (maxWidth != null) 'maxWidth': maxWidth!,
+        if (maxHeight != null) 'maxHeight': maxHeight!,
+        if (maxPixels != null) 'maxPixels': maxPixels!,
+      };
+}
@@ -0,0 +1,47 @@
+import 'dart:typed_data';
+
+import 'image_format.dart';
+
+/// A page of a PDF rendered to an image in memory.
+class RenderedPage {
+  /// The page number, starting at 1.
+  final int page;
+
+  /// The width of the image in pixels.
+  final int width;
+
+  /// The height of the image in pixels.
+  final int height;
+
+  /// The format of [bytes].
+  final ImageFormat format;
+
+  /// The bytes between the starts of two rows of an [ImageFormat.bgra]
+  /// image, `null` for encoded formats.
+  final int? stride;
+
+  /// The encoded image, or the pixels of an [ImageFormat.bgra] image.
+  final Uint8List bytes;
+
+  /// Creates an instance of [RenderedPage].
+  const RenderedPage({
+    required this.page,
+    required this.width,
+    required this.height,
+    required this.format,
+    required this.bytes,
+    this.stride,
+  });
+
+  /// Creates an instance of [RenderedPage] from a platform result.
+  factory RenderedPage.fromMap(Map<Object?, Object?> map) => RenderedPage(
+        page: map['page'] as int,
+        width: map['width'] as int,
+        height: map['height'] as int,
+        format: ImageFormat.values.firstWhere(
+            (format) => format.value == map['format'],
+            orElse: () => ImageFormat.png),
+        stride: map['stride'] as int?,
+        bytes: map['bytes'] as Uint8List,
+      );
+}
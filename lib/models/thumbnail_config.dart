@@ -0,0 +1,30 @@
+import 'image_compression.dart';
+
+/// Configuration for generating page thumbnails from a PDF.
+class ThumbnailConfig {
+  /// The size, in pixels, of the square each thumbnail fits in.
+  final int maxSize;
+
+  /// The image compression level for compression, affecting file size, quality and clarity.
+  final ImageCompression compression;
+
+  /// The pages to create thumbnails of, as a range like `1-3,7`, or all the
+  /// pages when `null`.
+  final String? pages;
+
+  /// Identifies the operation so it can be stopped with [PdfCombiner.cancel].
+  final String? jobId;
+
+  /// Creates an instance of [ThumbnailConfig].
+  ///
+  /// [maxSize] is the largest side of a thumbnail in pixels, defaulting to `256`.
+  /// [compression] sets the compression level for the thumbnails, defaulting to [ImageCompression.none].
+  /// [pages] selects the pages, 1-based, defaulting to all of them.
+  /// [jobId] is an optional identifier used to cancel the operation while it runs.
+  const ThumbnailConfig({
+    this.maxSize = 256,
+    this.compression = ImageCompression.none,
+    this.pages,
+    this.jobId,
+  }) : assert(maxSize > 0, 'maxSize must be greater than 0.');
+}
@@ -1,10 +1,17 @@
 import 'dart:async';
+import 'dart:typed_data';
 
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:pdf_combiner/responses/pdf_combiner_messages.dart';
 import 'package:pdf_combiner/utils/document_utils.dart';
 
@@ -102,12 +109,21 @@ class PdfCombiner {
   /// Parameters:
   /// - `inputs`: A list of [MergeInput] representing the paths of the PDF files to be combined.
   /// - `outputPath`: A string representing the directory where the combined PDF should be saved.
+  /// - `config`: A configuration object that specifies how to write the combined PDF.
+  ///   - `linearize`: Indicates whether to write a linearized ("fast web view") PDF (default is `false`).
+  ///   - `streaming`: Indicates whether to write the PDF page by page while merging, with flat memory use (default is `false`).
+  ///   - `deduplicate`: Indicates whether fonts, images and other streams repeated across inputs are stored once (default is `false`).
+  ///   - `compact`: Indicates whether to write a smaller PDF with compressed object and cross-reference streams (default is `false`).
+  ///   - `maxImageDpi`: The highest resolution, in dots per inch, kept for photos and scans, which are re-encoded as JPEG above it (default is `null`).
+  ///   - `targetBytes`: The size the merged PDF should fit in, reached by downsampling images (default is `null`).
+  ///   - `imageQuality`: The JPEG quality, from 1 to 100, of recompressed images (default is `75`).
   ///
   /// Returns:
   /// - A `Future<String>` representing the result of the operation (either the success message or an error message).
   static Future<String> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) async {
     if (inputs.isEmpty) {
       throw PdfCombinerException(
@@ -130,13 +146,20 @@ class PdfCombiner {
         if (!outputPathIsPDF) {
           throw PdfCombinerException(
               PdfCombinerMessages.errorMessageInvalidOutputPath(outputPath));
+        } else if (!_canSelectPages(inputs)) {
+          throw PdfCombinerException(
+              PdfCombinerMessages.errorMessagePageRangesUnsupported);
         } else if (!success) {
           throw PdfCombinerException(
               PdfCombinerMessages.errorMessagePDF(failedInputStr));
         } else {
-          final inputPaths = await Future.wait(
+          final inMemory = PdfCombinerPlatform.instance.supportsInMemoryInputs;
+          final preparedInputs = await Future.wait(
             inputs.map(
               (input) async {
+                if (inMemory) {
+                  return await _resolveInMemory(input);
+                }
                 final result = await DocumentUtils.prepareInput(input);
                 switch (input) {
                   case BytesMergeInput() || UrlMergeInput():
@@ -144,15 +167,16 @@ class PdfCombiner {
                   case PathMergeInput():
                     break;
                 }
-                return result;
+                return MergeInput.path(result, pages: input.pages);
               },
             ),
           );
 
           final String? response =
               await PdfCombinerPlatform.instance.mergeMultiplePDFs(
-            inputs: inputPaths.map((path) => MergeInput.path(path)).toList(),
+            inputs: preparedInputs,
             outputPath: outputPath,
+            config: config,
           );
 
           if (response != null &&
@@ -173,6 +197,75 @@ class PdfCombiner {
     }
   }
 
+  /// Combines multiple PDF files into a single PDF returned as bytes.
+  ///
+  /// Byte and URL inputs are handed to the native platform in memory and the
+  /// merged document is returned without touching the file system, which
+  /// avoids writing every input to a temporary file and reading the result
+  /// back. Currently supported on Linux.
+  ///
+  /// Parameters:
+  /// - `inputs`: A list of [MergeInput] representing the PDF files to be combined.
+  /// - `config`: A configuration object that specifies how to write the combined PDF.
+  ///
+  /// Returns:
+  /// - A `Future<Uint8List>` with the bytes of the merged PDF.
+  ///
+  /// ### Errors:
+  /// - Throws a [PdfCombinerException] if `inputs` is empty, if an input is
+  ///   not a PDF or if the merging process fails.
+  static Future<Uint8List> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) async {
+    if (inputs.isEmpty) {
+      throw PdfCombinerException(
+          PdfCombinerMessages.emptyParameterMessage("inputPaths"));
+    }
+    try {
+      if (!_canSelectPages(inputs)) {
+        throw PdfCombinerException(
+            PdfCombinerMessages.errorMessagePageRangesUnsupported);
+      }
+      for (MergeInput input in inputs) {
+        if (!await DocumentUtils.isPDF(input)) {
+          throw PdfCombinerException(
+              PdfCombinerMessages.errorMessagePDF(input.toString()));
+        }
+      }
+
+      final resolvedInputs = await Future.wait(inputs.map(_resolveInMemory));
+      final Uint8List? response = await PdfCombinerPlatform.instance
+          .mergeMultiplePDFsToBytes(inputs: resolvedInputs, config: config);
+
+      if (response == null || response.isEmpty) {
+        throw PdfCombinerException(PdfCombinerMessages.errorMessage);
+      }
+      return response;
+    } catch (e) {
+      throw e is Exception ? e : PdfCombinerException(e.toString());
+    } finally {
+      DocumentUtils.clearCache();
+    }
+  }
+
+  /// Whether the platform can honor the page selections of `inputs`.
+  static bool _canSelectPages(List<MergeInput> inputs) =>
+      PdfCombinerPlatform.instance.supportsPageRanges ||
+      inputs.every((input) => input.pages == null);
+
+  /// Turns an input into one the native side can load from memory: URLs are
+  /// downloaded, paths and bytes are kept as they are.
+  static Future<MergeInput> _resolveInMemory(MergeInput input) async {
+    switch (input) {
+      case UrlMergeInput(:final url, :final pages):
+        return MergeInput.bytes(await DocumentUtils.getUrlBytes(url),
+            pages: pages);
+      case PathMergeInput() || BytesMergeInput():
+        return input;
+    }
+  }
+
   /// Creates a PDF from multiple image files.
   ///
   /// This method sends a request to the native platform to create a PDF from the
@@ -337,4 +430,196 @@ class PdfCombiner {
       DocumentUtils.clearCache();
     }
   }
+
+  /// Renders the pages of a PDF to images in memory, without writing files.
+  ///
+  /// Each [RenderedPage] has the page number, the image size and its bytes:
+  /// an encoded image for `ImageFormat.png`, `ImageFormat.jpeg` and the
+  /// portable formats, or the pixels with their row stride for
+  /// `ImageFormat.bgra`, which skips encoding altogether. Use [pages] to
+  /// render only the pages about to be shown (Linux).
+  ///
+  /// Parameters:
+  /// - `input`: The PDF to render.
+  /// - `config`: The size, compression and format of the images, as for [createImageFromPDF]; `createOneImage` is ignored.
+  /// - `pages`: The pages to render, like `1-3,7`, or all of them when `null`.
+  ///
+  /// Returns:
+  /// - A `Future<List<RenderedPage>>` with one image per page, in the order of `pages`.
+  static Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) async {
+    String? temportalFilePath;
+    try {
+      if (!await DocumentUtils.isPDF(input)) {
+        final inputTypeMessage = switch (input) {
+          BytesMergeInput() => "File in bytes",
+          PathMergeInput(:final path) => path,
+          UrlMergeInput(:final url) => url,
+        };
+        throw PdfCombinerException(PdfCombinerMessages.errorMessagePDF(
+          inputTypeMessage,
+        ));
+      }
+      final inputPath = await DocumentUtils.prepareInput(input);
+      if (input is! PathMergeInput) temportalFilePath = inputPath;
+      final response =
+          await PdfCombinerPlatform.instance.createImageFromPDFToBytes(
+        input: MergeInput.path(inputPath),
+        config: config,
+        pages: pages,
+      );
+      if (response.isEmpty) {
+        throw PdfCombinerException(PdfCombinerMessages.errorMessage);
+      }
+      return response;
+    } catch (e) {
+      throw e is Exception ? e : PdfCombinerException(e.toString());
+    } finally {
+      if (temportalFilePath != null) {
+        DocumentUtils.removeTemporalFiles([temportalFilePath]);
+      }
+      DocumentUtils.clearCache();
+    }
+  }
+
+  /// Creates a thumbnail of each page of a PDF.
+  ///
+  /// Thumbnails are saved as `thumbnail_<page>.png` in `outputDirPath`, each
+  /// fitting a square of [ThumbnailConfig.maxSize] pixels. On Linux the
+  /// thumbnail images stored in the PDF are used when there are any, which
+  /// avoids rendering those pages; the others are rendered at thumbnail size.
+  ///
+  /// Parameters:
+  /// - `input`: The PDF to create thumbnails of.
+  /// - `outputDirPath`: A string representing the directory where the thumbnails should be saved.
+  /// - `config`: A [ThumbnailConfig] with the size, compression and pages of the thumbnails.
+  ///
+  /// Returns:
+  /// - A `Future<List<String>>` with the paths of the thumbnails, in page order.
+  static Future<List<String>> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputDirPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) async {
+    String? temportalFilePath;
+    try {
+      if (!await DocumentUtils.isPDF(input)) {
+        final inputTypeMessage = switch (input) {
+          BytesMergeInput() => "File in bytes",
+          PathMergeInput(:final path) => path,
+          UrlMergeInput(:final url) => url,
+        };
+        throw PdfCombinerException(PdfCombinerMessages.errorMessagePDF(
+          inputTypeMessage,
+        ));
+      }
+      final inputPath = await DocumentUtils.prepareInput(input);
+      if (input is! PathMergeInput) temportalFilePath = inputPath;
+      final response =
+          await PdfCombinerPlatform.instance.createThumbnailsFromPDF(
+        input: MergeInput.path(inputPath),
+        outputPath: outputDirPath,
+        config: config,
+      );
+      if (response == null || response.isEmpty) {
+        throw PdfCombinerException(PdfCombinerMessages.errorMessage);
+      }
+      return response;
+    } catch (e) {
+      throw e is Exception ? e : PdfCombinerException(e.toString());
+    } finally {
+      if (temportalFilePath != null) {
+        DocumentUtils.removeTemporalFiles([temportalFilePath]);
+      }
+      DocumentUtils.clearCache();
+    }
+  }
+
+  /// Runs many operations in one platform call.
+  ///
+  /// Each [BatchJob] takes the same parameters as the method it stands for,
+  /// but its inputs are sent as they are, without the checks and the
+  /// temporary files of the single calls: use path inputs, or byte inputs for
+  /// merges where [PdfCombinerPlatform.supportsInMemoryInputs] is `true`.
+  ///
+  /// On Linux the whole batch is a single channel round-trip, and an input
+  /// file used by several jobs is opened once for all of them (a file written
+  /// by an earlier job of the batch is read again). Other platforms run the
+  /// jobs one by one. A failed job does not stop the others.
+  ///
+  /// Parameters:
+  /// - `jobs`: The operations to run, in order.
+  /// - `jobId`: An optional identifier that allows the jobs that have not
+  ///   started yet to be cancelled with [cancel]. Each job can also be
+  ///   cancelled with its own `jobId`.
+  ///
+  /// Returns:
+  /// - A `Future<List<BatchJobResult>>` with one result per job, in order.
+  static Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) async {
+    if (jobs.isEmpty) return [];
+    try {
+      return await PdfCombinerPlatform.instance.runBatch(jobs, jobId: jobId);
+    } catch (e) {
+      throw e is Exception ? e : PdfCombinerException(e.toString());
+    }
+  }
+
+  /// Progress of the running operations on Linux and Windows.
+  ///
+  /// Each event carries the pages and input documents processed, the output
+  /// bytes written and the elapsed time. Events are throttled to one every
+  /// 100 ms per operation, and the last one has
+  /// [PdfCombinerProgress.finished] set.
+  static Stream<PdfCombinerProgress> get progressStream =>
+      PdfCombinerPlatform.instance.progressStream;
+
+  /// Cancels a [createImageFromPDF] or [createThumbnailsFromPDF] call started
+  /// with the same [ImageFromPdfConfig.jobId] or [ThumbnailConfig.jobId].
+  ///
+  /// The cancelled call fails with a `PlatformException` whose code is
+  /// `cancelled`, and leaves no partial images behind. Cancellation is
+  /// supported on Linux; other platforms return `false`.
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if a running operation was found.
+  static Future<bool> cancel(String jobId) async {
+    return await PdfCombinerPlatform.instance.cancel(jobId);
+  }
+
+  /// Sets the budget of the native cache of open input documents (Linux).
+  ///
+  /// Input PDFs are kept open between calls, so rendering and then merging
+  /// the same file does not parse it twice. A file changed since it was
+  /// opened is opened again. The least recently used documents are closed to
+  /// keep at most [maxDocuments] open, and their files within [maxBytes];
+  /// both default to 16 documents and 512 MB. A [maxDocuments] of 0 disables
+  /// the cache. Hits and misses are reported by [getNativeStats].
+  ///
+  /// Returns:
+  /// - A `Future<bool>` that is `true` if the platform has a document cache.
+  static Future<bool> configureDocumentCache(
+      {int? maxDocuments, int? maxBytes}) async {
+    assert(maxDocuments == null || maxDocuments >= 0);
+    assert(maxBytes == null || maxBytes >= 0);
+    return await PdfCombinerPlatform.instance.configureDocumentCache(
+        maxDocuments: maxDocuments, maxBytes: maxBytes);
+  }
+
+  /// Returns diagnostic counters reported by the native implementation.
+  ///
+  /// The content depends on the platform. On Linux it describes the worker
+  /// pool that runs the operations off the UI thread (`workers`, `queueDepth`,
+  /// `queueCapacity` and `runningJobs`) and the document cache
+  /// (`documentCacheHits`, `documentCacheMisses` and others).
+  ///
+  /// Returns:
+  /// - A `Future<Map<String, Object?>>` with the counters, empty when the
+  ///   platform does not report any.
+  static Future<Map<String, Object?>> getNativeStats() async {
+    return await PdfCombinerPlatform.instance.getNativeStats() ?? {};
+  }
 }
@@ -9,6 +9,7 @@ import 'package:web/web.dart';
 
 import 'communication/pdf_combiner_platform_interface.dart';
 import 'models/image_from_pdf_config.dart';
+import 'models/merge_config.dart';
 import 'models/pdf_from_multiple_image_config.dart';
 import 'utils/document_utils.dart';
 
@@ -87,6 +88,7 @@ class PdfCombinerWeb extends PdfCombinerPlatform {
   /// Parameters:
   /// - `inputs`: A list of file paths of the PDFs to be merged.
   /// - `outputPath`: The directory path where the merged PDF should be saved.
+  /// - `config`: Ignored on the web, the merged PDF is never linearized.
   ///
   /// Returns:
   /// - A `Future<String?>` representing the result of the operation. If the operation
@@ -95,6 +97,7 @@ class PdfCombinerWeb extends PdfCombinerPlatform {
   Future<String> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) async {
     await _ensureScriptsLoaded();
     final inputPaths = await Future.wait(inputs.map(
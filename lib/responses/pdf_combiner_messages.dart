@@ -9,6 +9,10 @@ class PdfCombinerMessages {
   /// Message indicating that processing has started.
   static const processingMessage = "Processing start";
 
+  /// Message indicating that the platform cannot merge only some pages of an input.
+  static const errorMessagePageRangesUnsupported =
+      "Page selection with MergeInput.pages is not supported on this platform";
+
   /// Returns an error message when a required parameter is empty.
   ///
   /// - [parameterName] The name of the parameter that cannot be empty.
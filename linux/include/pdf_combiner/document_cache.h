@@ -0,0 +1,190 @@
+#ifndef PDF_COMBINER_DOCUMENT_CACHE_H_
+#define PDF_COMBINER_DOCUMENT_CACHE_H_
+
+#include <sys/stat.h>
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "../pdfium/fpdfview.h"
+#include "mapped_file.h"
+#include "native_stats.h"
+
+// Input files kept mapped, and loaded by PDFium, across method calls, so the
+// cross-reference table of a file used again is not parsed again.
+//
+// A file is checked with stat() every time it is asked for: if it was
+// replaced or modified since it was mapped (by another app, or as the output
+// of a previous call), it is mapped and loaded again. The least recently used
+// files are closed to stay within a number of documents and a number of
+// mapped bytes; a file larger than the byte budget is kept alone.
+//
+// The cache owns what it returns: documents must not be closed by the
+// caller (see Owns()), and a mapping or document is only valid until the
+// next call to Map() or Open(), which may evict it. Hits, misses and
+// evictions are added to native_stats().
+//
+// A cached file stays mapped across calls, and stat() only notices changes
+// made between them. Like any MappedFile, it must not be truncated in place
+// while it is mapped: PDFium reading a page past the new end of the file gets
+// a SIGBUS, which ends the app. Files replaced by a new file (saved to a
+// temporary file and renamed, as most apps do) are safe, the mapping keeps
+// the old one.
+class DocumentCache {
+public:
+    enum { kDefaultMaxDocuments = 16, kDefaultMaxBytes = 512 << 20 };
+
+    explicit DocumentCache(size_t max_documents = kDefaultMaxDocuments, uint64_t max_bytes = kDefaultMaxBytes)
+        : max_documents_(max_documents), max_bytes_(max_bytes) {}
+
+    ~DocumentCache() { Clear(); }
+
+    DocumentCache(const DocumentCache&) = delete;
+    DocumentCache& operator=(const DocumentCache&) = delete;
+
+    // Changes the budget, closing files at once if it shrank. With no
+    // documents allowed the cache is disabled: Map() and Open() fail.
+    void SetBudget(size_t max_documents, uint64_t max_bytes) {
+        max_documents_ = max_documents;
+        max_bytes_ = max_bytes;
+        while (!entries_.empty() && (entries_.size() > max_documents_ || bytes_ > max_bytes_)) Evict();
+    }
+
+    bool Enabled() const { return max_documents_ > 0; }
+
+    // The mapping of the file at `path`, or null if it cannot be mapped.
+    MappedFile* Map(const char* path) {
+        Entry* entry = Find(path);
+        return entry && entry->file->IsOpen() ? entry->file.get() : nullptr;
+    }
+
+    // The file at `path` loaded as a document, or null if it is not a PDF
+    // PDFium can open without a password.
+    FPDF_DOCUMENT Open(const char* path) {
+        Entry* entry = Find(path);
+        if (!entry) return nullptr;
+        if (!entry->doc && !entry->load_failed) {
+            entry->doc = entry->file->LoadDocument();
+            entry->load_failed = entry->doc == nullptr;
+        }
+        return entry->doc;
+    }
+
+    // Whether `doc` was returned by Open()
+    bool Owns(FPDF_DOCUMENT doc) const { return FileOf(doc) != nullptr; }
+
+    // The mapping `doc` was loaded from, or null if it was not returned by
+    // Open(). Unlike Map(), it does not look at the file again.
+    const MappedFile* FileOf(FPDF_DOCUMENT doc) const {
+        if (!doc) return nullptr;
+        for (const Entry& entry : entries_) {
+            if (entry.doc == doc) return entry.file.get();
+        }
+        return nullptr;
+    }
+
+    // Closes every document and unmaps every file.
+    void Clear() {
+        while (!entries_.empty()) Remove(entries_.begin());
+    }
+
+    size_t Size() const { return entries_.size(); }
+    uint64_t Bytes() const { return bytes_; }
+
+    // Calls that found their file open, those that had to map it, and the
+    // files closed to stay within the budget
+    uint64_t Hits() const { return hits_; }
+    uint64_t Misses() const { return misses_; }
+    uint64_t Evictions() const { return evictions_; }
+
+private:
+    // What identifies a version of a file
+    struct Stamp {
+        dev_t device = 0;
+        ino_t inode = 0;
+        off_t size = 0;
+        int64_t mtime_ns = 0;
+
+        bool operator==(const Stamp& other) const {
+            return device == other.device && inode == other.inode && size == other.size && mtime_ns == other.mtime_ns;
+        }
+    };
+
+    struct Entry {
+        std::string path;
+        Stamp stamp;
+        std::unique_ptr<MappedFile> file;
+        FPDF_DOCUMENT doc = nullptr;
+        bool load_failed = false;
+    };
+
+    static bool GetStamp(const char* path, Stamp& stamp) {
+        struct stat st;
+        if (stat(path, &st) != 0) return false;
+        stamp.device = st.st_dev;
+        stamp.inode = st.st_ino;
+        stamp.size = st.st_size;
+        stamp.mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+        return true;
+    }
+
+    // The entry of the current version of `path`, moved to the front and
+    // mapped if needed, or null if the file does not exist.
+    Entry* Find(const char* path) {
+        Stamp stamp;
+        if (!Enabled() || !GetStamp(path, stamp)) return nullptr;
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->path != path) continue;
+            if (it->stamp == stamp) {
+                entries_.splice(entries_.begin(), entries_, it);
+                hits_++;
+                native_stats().document_cache_hits++;
+                return &entries_.front();
+            }
+            Remove(it);
+            break;
+        }
+        misses_++;
+        native_stats().document_cache_misses++;
+
+        // Make room before mapping the file
+        uint64_t size = stamp.size > 0 ? (uint64_t)stamp.size : 0;
+        while (!entries_.empty() && (entries_.size() >= max_documents_ || bytes_ + size > max_bytes_)) Evict();
+        entries_.emplace_front();
+        Entry& entry = entries_.front();
+        entry.path = path;
+        entry.stamp = stamp;
+        entry.file.reset(new MappedFile(path));
+        bytes_ += entry.file->size();
+        native_stats().document_cache_documents++;
+        native_stats().document_cache_bytes += (int64_t)entry.file->size();
+        return &entry;
+    }
+
+    void Remove(std::list<Entry>::iterator it) {
+        if (it->doc) FPDF_CloseDocument(it->doc);
+        bytes_ -= it->file->size();
+        native_stats().document_cache_documents--;
+        native_stats().document_cache_bytes -= (int64_t)it->file->size();
+        entries_.erase(it);
+    }
+
+    // Closes the least recently used file
+    void Evict() {
+        Remove(std::prev(entries_.end()));
+        evictions_++;
+        native_stats().document_cache_evictions++;
+    }
+
+    size_t max_documents_;
+    uint64_t max_bytes_;
+    std::list<Entry> entries_;  // most recently used first
+    uint64_t bytes_ = 0;        // size of the mapped files
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+};
+
+#endif  // PDF_COMBINER_DOCUMENT_CACHE_H_
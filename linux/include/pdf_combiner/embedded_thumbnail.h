@@ -0,0 +1,71 @@
+#ifndef PDF_COMBINER_EMBEDDED_THUMBNAIL_H_
+#define PDF_COMBINER_EMBEDDED_THUMBNAIL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "../pdfium/fpdf_thumbnail.h"
+#include "../pdfium/fpdfview.h"
+#include "stb_image_resize2.h"
+
+// Fits a `width` x `height` page in a `max_size` square, keeping its aspect
+// ratio; neither side is below one pixel.
+inline void fit_thumbnail_size(double width, double height, int max_size, int& out_width, int& out_height) {
+    double scale = width > 0 && height > 0 ? max_size / std::max(width, height) : 0;
+    out_width = std::max(1, (int)std::lround(width * scale));
+    out_height = std::max(1, (int)std::lround(height * scale));
+}
+
+// Reads the thumbnail image a PDF writer may have stored with `page` (its
+// /Thumb entry) into `bgra`, tightly packed and opaque, scaled down to fit a
+// `max_size` square if it is larger. FPDFPage_GetThumbnailAsBitmap decodes it
+// with its size and color space, which FPDFPage_GetDecodedThumbnailData does
+// not give. Returns false if the page has none.
+inline bool read_embedded_thumbnail(FPDF_PAGE page, int max_size, int& width, int& height,
+                                    std::vector<uint8_t>& bgra) {
+    FPDF_BITMAP bitmap = FPDFPage_GetThumbnailAsBitmap(page);
+    if (!bitmap) return false;
+    int source_width = FPDFBitmap_GetWidth(bitmap);
+    int source_height = FPDFBitmap_GetHeight(bitmap);
+    int stride = FPDFBitmap_GetStride(bitmap);
+    int format = FPDFBitmap_GetFormat(bitmap);
+    const uint8_t* buffer = static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+    if (!buffer || source_width <= 0 || source_height <= 0 || format == FPDFBitmap_Unknown) {
+        FPDFBitmap_Destroy(bitmap);
+        return false;
+    }
+
+    // Convert to BGRA
+    std::vector<uint8_t> pixels((size_t)source_width * source_height * 4);
+    for (int y = 0; y < source_height; ++y) {
+        const uint8_t* src = buffer + (size_t)y * stride;
+        uint8_t* dst = pixels.data() + (size_t)y * source_width * 4;
+        for (int x = 0; x < source_width; ++x, dst += 4) {
+            if (format == FPDFBitmap_Gray) {
+                dst[0] = dst[1] = dst[2] = src[x];
+            } else {
+                const uint8_t* pixel = src + x * (format == FPDFBitmap_BGR ? 3 : 4);
+                dst[0] = pixel[0];
+                dst[1] = pixel[1];
+                dst[2] = pixel[2];
+            }
+            dst[3] = 255;
+        }
+    }
+    FPDFBitmap_Destroy(bitmap);
+
+    if (source_width <= max_size && source_height <= max_size) {
+        width = source_width;
+        height = source_height;
+        bgra.swap(pixels);
+        return true;
+    }
+    fit_thumbnail_size(source_width, source_height, max_size, width, height);
+    bgra.resize((size_t)width * height * 4);
+    return stbir_resize_uint8_linear(pixels.data(), source_width, source_height, 0, bgra.data(), width, height, 0,
+                                     STBIR_BGRA) != nullptr;
+}
+
+#endif  // PDF_COMBINER_EMBEDDED_THUMBNAIL_H_
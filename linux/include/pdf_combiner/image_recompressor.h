@@ -0,0 +1,336 @@
+#ifndef PDF_COMBINER_IMAGE_RECOMPRESSOR_H_
+#define PDF_COMBINER_IMAGE_RECOMPRESSOR_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../pdfium/fpdf_edit.h"
+#include "../pdfium/fpdfview.h"
+#include "pdf_object.h"
+#include "sha256.h"
+#include "stb_image_resize2.h"
+#include "stb_image_write.h"
+
+// Re-encodes the raster images of the PDFs being merged as smaller JPEGs.
+// Each image is downsampled to at most `max_dpi` at the largest size it is
+// drawn and encoded at `quality` (1-100); with `target_bytes`, the resolution
+// is lowered further, evenly across images and down to kMinDpi, until the
+// output should fit (re-measured up to kRescalePasses times). PDFium decodes the images; the new JPEGs are then put in
+// place by Replace() as the objects are copied (see PdfStreamMerger), so an
+// image drawn on several pages is replaced once for all of them.
+//
+// The inputs are read in passes, every input in each pass:
+//
+//   do {
+//       for each input: recompressor.AddDocument(doc, pages, size);
+//   } while (recompressor.NextPass());
+//
+// Only images drawn directly on a page are handled, not those inside form
+// XObjects. Bilevel and indexed images (scans of text, screenshots), CMYK and
+// other color spaces, and images drawn with transparency (a mask or a soft
+// mask) are left as they are: JPEG would enlarge or alter them. A JPEG that
+// is not smaller than the image it would replace is dropped.
+class ImageRecompressor {
+public:
+    enum { kMinDpi = 72, kRescalePasses = 3 };
+
+    ImageRecompressor() = default;
+
+    ImageRecompressor(const ImageRecompressor&) = delete;
+    ImageRecompressor& operator=(const ImageRecompressor&) = delete;
+
+    int max_dpi = 0;            // 0 for no limit
+    uint64_t target_bytes = 0;  // 0 for no target
+    int quality = 75;
+
+    // Reads the images drawn on `pages` (0-based, all of them if empty) of an
+    // input of `size` bytes. False if a page cannot be loaded.
+    bool AddDocument(FPDF_DOCUMENT doc, const std::vector<int>& pages, uint64_t size) {
+        int page_count = FPDF_GetPageCount(doc);
+        std::vector<int> selection = pages;
+        if (selection.empty()) {
+            for (int i = 0; i < page_count; ++i) selection.push_back(i);
+        }
+        if (!encoding_ && page_count > 0) input_bytes_ += size * selection.size() / page_count;
+        for (int index : selection) {
+            FPDF_PAGE page = FPDF_LoadPage(doc, index);
+            if (!page) return false;
+            int object_count = FPDFPage_CountObjects(page);
+            for (int i = 0; i < object_count; ++i) {
+                FPDF_PAGEOBJECT object = FPDFPage_GetObject(page, i);
+                if (FPDFPageObj_GetType(object) != FPDF_PAGEOBJ_IMAGE) continue;
+                std::string digest;
+                uint64_t raw_size = 0;
+                if (!Digest(object, digest, raw_size)) continue;
+                if (encoding_) {
+                    auto found = images_.find(digest);
+                    if (found != images_.end() && found->second.planned && !found->second.encoded) {
+                        found->second.encoded = true;
+                        Encode(object, found->second);
+                    }
+                } else {
+                    Survey(doc, page, object, digest, raw_size);
+                }
+            }
+            FPDF_ClosePage(page);
+        }
+        return true;
+    }
+
+    // Plans the next pass once every input has been added. False when done.
+    bool NextPass() {
+        if (!encoding_) {
+            encoding_ = true;
+            return Plan();
+        }
+        if (rescales_ == kRescalePasses || !over_budget_) return false;
+        uint64_t encoded = 0;
+        for (const auto& entry : images_) {
+            const Image& image = entry.second;
+            if (image.planned) encoded += image.jpeg.empty() ? image.raw_size : image.jpeg.size();
+        }
+        if (encoded <= budget_) return false;
+
+        // JPEG size grows slower than the pixel count, about as its 0.7th
+        // power, so the side is scaled by a bit more than the square root
+        rescales_++;
+        double factor = std::pow((double)budget_ / (double)encoded, 0.75);
+        bool lowered = false;
+        for (auto& entry : images_) {
+            Image& image = entry.second;
+            if (!image.planned) continue;
+            double floor = std::min(image.scale, kMinDpi / image.dpi);
+            double scale = std::max(image.scale * factor, floor);
+            if (scale >= image.scale) continue;
+            std::string().swap(image.jpeg);
+            image.encoded = false;
+            image.scale = scale;
+            lowered = true;
+        }
+        return lowered;
+    }
+
+    // If `object` is an image stream with a new JPEG, swaps the JPEG in. The
+    // same pixels may also be stored with a mask, which is kept as it is.
+    // stb writes YCbCr JPEGs, 3 components even for gray images, from pixels
+    // PDFium has already converted out of any ICC profile, so the color space
+    // becomes DeviceRGB.
+    bool Replace(PdfIndirectObject& object) {
+        if (!object.has_stream || images_.empty()) return false;
+        const PdfValue* subtype = object.value.Find("Subtype");
+        if (!subtype || !subtype->IsName("Image")) return false;
+        for (const char* key : {"SMask", "Mask", "ImageMask"}) {
+            if (object.value.Find(key)) return false;
+        }
+        Sha256 hash;
+        hash.Update(object.stream);
+        auto found = images_.find(hash.Finish());
+        if (found == images_.end() || found->second.jpeg.empty()) return false;
+        const Image& image = found->second;
+        for (const char* key : {"DecodeParms", "Decode", "Length"}) object.value.Erase(key);
+        object.value.Set("Width", PdfValue::Integer(image.width));
+        object.value.Set("Height", PdfValue::Integer(image.height));
+        object.value.Set("BitsPerComponent", PdfValue::Integer(8));
+        object.value.Set("ColorSpace", PdfValue::Name("DeviceRGB"));
+        object.value.Set("Filter", PdfValue::Name("DCTDecode"));
+        replaced_count_++;
+        bytes_before_ += object.stream.size();
+        bytes_after_ += image.jpeg.size();
+        object.stream = image.jpeg;
+        return true;
+    }
+
+    int ReplacedCount() const { return replaced_count_; }
+
+    // The size of the image streams replaced, before and after
+    uint64_t BytesBefore() const { return bytes_before_; }
+    uint64_t BytesAfter() const { return bytes_after_; }
+
+private:
+    // An image, however many times it is drawn
+    struct Image {
+        bool eligible = false;
+        double dpi = 0;         // the lowest it is drawn at
+        uint64_t raw_size = 0;  // its stream as stored
+        bool planned = false;
+        bool encoded = false;
+        double scale = 1.0;     // of its pixel size
+        std::string jpeg;       // empty if not smaller than the stream
+        int width = 0;
+        int height = 0;
+    };
+
+    // The SHA-256 of the image stream as stored, which identifies the image
+    // on every page and in the copied objects.
+    static bool Digest(FPDF_PAGEOBJECT object, std::string& digest, uint64_t& size) {
+        unsigned long length = FPDFImageObj_GetImageDataRaw(object, nullptr, 0);
+        if (length == 0) return false;
+        std::vector<uint8_t> raw(length);
+        if (FPDFImageObj_GetImageDataRaw(object, raw.data(), length) != length) return false;
+        Sha256 hash;
+        hash.Update(raw.data(), raw.size());
+        digest = hash.Finish();
+        size = length;
+        return true;
+    }
+
+    // Records the image with the lowest resolution it is drawn at, and
+    // whether it can be turned into a JPEG.
+    void Survey(FPDF_DOCUMENT doc, FPDF_PAGE page, FPDF_PAGEOBJECT object, const std::string& digest, uint64_t raw_size) {
+        FPDF_IMAGEOBJ_METADATA metadata;
+        bool drawn = FPDFImageObj_GetImageMetadata(object, page, &metadata) != 0;
+        double dpi = drawn ? std::min(metadata.horizontal_dpi, metadata.vertical_dpi) : 0;
+        auto inserted = images_.insert({digest, Image()});
+        Image& image = inserted.first->second;
+        if (inserted.second) {
+            image.raw_size = raw_size;
+            image.dpi = dpi;
+            image.eligible = dpi > 0 && HasJpegColors(metadata) && !IsTransparent(doc, page, object);
+        } else {
+            image.eligible = image.eligible && dpi > 0;
+            image.dpi = std::min(image.dpi, dpi);
+        }
+    }
+
+    // Picks the images to encode and at which scale, after the survey.
+    bool Plan() {
+        uint64_t images_bytes = 0;
+        for (const auto& entry : images_) {
+            if (entry.second.eligible) images_bytes += entry.second.raw_size;
+        }
+        over_budget_ = target_bytes > 0 && input_bytes_ > target_bytes;
+        if (over_budget_) {
+            uint64_t others = input_bytes_ > images_bytes ? input_bytes_ - images_bytes : 0;
+            // The rest of the output is only estimated, keep 5% spare
+            budget_ = target_bytes > others ? (target_bytes - others) / 20 * 19 : 0;
+        }
+        bool any = false;
+        for (auto& entry : images_) {
+            Image& image = entry.second;
+            if (!image.eligible) continue;
+            image.scale = max_dpi > 0 && image.dpi > max_dpi ? max_dpi / image.dpi : 1.0;
+            image.planned = image.scale < 1.0 || over_budget_;
+            any = any || image.planned;
+        }
+        return any;
+    }
+
+    // Gray or RGB, 8 bits per component
+    static bool HasJpegColors(const FPDF_IMAGEOBJ_METADATA& metadata) {
+        switch (metadata.colorspace) {
+            case FPDF_COLORSPACE_DEVICEGRAY:
+            case FPDF_COLORSPACE_CALGRAY:
+                return metadata.bits_per_pixel == 8;
+            case FPDF_COLORSPACE_DEVICERGB:
+            case FPDF_COLORSPACE_CALRGB:
+                return metadata.bits_per_pixel == 24;
+            case FPDF_COLORSPACE_ICCBASED:
+                return metadata.bits_per_pixel == 8 || metadata.bits_per_pixel == 24;
+            default:
+                return false;
+        }
+    }
+
+    // Whether the image, drawn with its mask, leaves anything uncovered.
+    // FPDFPageObj_HasTransparency() does not look at image masks. The edge
+    // pixels are ignored, they may be partly covered.
+    static bool IsTransparent(FPDF_DOCUMENT doc, FPDF_PAGE page, FPDF_PAGEOBJECT object) {
+        FPDF_BITMAP bitmap = FPDFImageObj_GetRenderedBitmap(doc, page, object);
+        if (!bitmap) return true;
+        bool transparent = false;
+        if (FPDFBitmap_GetFormat(bitmap) == FPDFBitmap_BGRA) {
+            int width = FPDFBitmap_GetWidth(bitmap);
+            int height = FPDFBitmap_GetHeight(bitmap);
+            int stride = FPDFBitmap_GetStride(bitmap);
+            const uint8_t* pixels = static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+            for (int y = 1; y < height - 1 && !transparent; ++y) {
+                const uint8_t* row = pixels + (size_t)y * stride;
+                for (int x = 1; x < width - 1; ++x) {
+                    if (row[x * 4 + 3] != 255) {
+                        transparent = true;
+                        break;
+                    }
+                }
+            }
+        }
+        FPDFBitmap_Destroy(bitmap);
+        return transparent;
+    }
+
+    // Decodes the image, resizes it by its scale and encodes it as a JPEG,
+    // kept if smaller than the stream it replaces.
+    bool Encode(FPDF_PAGEOBJECT object, Image& image) {
+        FPDF_BITMAP bitmap = FPDFImageObj_GetBitmap(object);
+        if (!bitmap) return false;
+        int width = FPDFBitmap_GetWidth(bitmap);
+        int height = FPDFBitmap_GetHeight(bitmap);
+        int stride = FPDFBitmap_GetStride(bitmap);
+        int format = FPDFBitmap_GetFormat(bitmap);
+        if (format == FPDFBitmap_Unknown || width <= 0 || height <= 0) {
+            FPDFBitmap_Destroy(bitmap);
+            return false;
+        }
+
+        // Packed RGB or gray, as stb expects
+        int pixel_size = format == FPDFBitmap_Gray ? 1 : format == FPDFBitmap_BGR ? 3 : 4;
+        int channels = format == FPDFBitmap_Gray ? 1 : 3;
+        std::vector<uint8_t> pixels((size_t)width * height * channels);
+        const uint8_t* buffer = static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* source = buffer + (size_t)y * stride;
+            uint8_t* target = pixels.data() + (size_t)y * width * channels;
+            if (channels == 1) {
+                memcpy(target, source, width);
+                continue;
+            }
+            for (int x = 0; x < width; ++x, source += pixel_size, target += 3) {
+                target[0] = source[2];
+                target[1] = source[1];
+                target[2] = source[0];
+            }
+        }
+        FPDFBitmap_Destroy(bitmap);
+
+        int new_width = std::min(width, std::max(1, (int)std::lround(width * image.scale)));
+        int new_height = std::min(height, std::max(1, (int)std::lround(height * image.scale)));
+        if (new_width < width || new_height < height) {
+            std::vector<uint8_t> resized((size_t)new_width * new_height * channels);
+            if (!stbir_resize_uint8_linear(pixels.data(), width, height, 0, resized.data(), new_width, new_height, 0,
+                                           channels == 1 ? STBIR_1CHANNEL : STBIR_RGB)) {
+                return false;
+            }
+            pixels.swap(resized);
+        }
+
+        std::string jpeg;
+        auto append = [](void* context, void* data, int size) {
+            static_cast<std::string*>(context)->append(static_cast<const char*>(data), size);
+        };
+        int jpeg_quality = std::min(100, std::max(1, quality));
+        if (!stbi_write_jpg_to_func(append, &jpeg, new_width, new_height, channels, pixels.data(), jpeg_quality)) {
+            return false;
+        }
+        if (jpeg.size() >= image.raw_size) return false;
+        image.jpeg.swap(jpeg);
+        image.width = new_width;
+        image.height = new_height;
+        return true;
+    }
+
+    std::unordered_map<std::string, Image> images_;  // by SHA-256 of their stream
+    bool encoding_ = false;     // past the survey
+    int rescales_ = 0;          // passes lowered for target_bytes
+    bool over_budget_ = false;
+    uint64_t input_bytes_ = 0;  // of the pages selected, estimated
+    uint64_t budget_ = 0;       // for the images, under target_bytes
+    int replaced_count_ = 0;
+    uint64_t bytes_before_ = 0;
+    uint64_t bytes_after_ = 0;
+};
+
+#endif  // PDF_COMBINER_IMAGE_RECOMPRESSOR_H_
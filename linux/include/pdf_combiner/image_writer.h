@@ -0,0 +1,257 @@
+#ifndef PDF_COMBINER_IMAGE_WRITER_H_
+#define PDF_COMBINER_IMAGE_WRITER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "png_writer.h"
+#include "stb_image_write.h"
+#include "swizzle.h"
+
+// The file formats rendered pages can be saved in
+enum class ImageFormat {
+    kPng,   // RGBA, see PngWriter
+    kJpeg,  // RGB over white, quality from the ImageCompression value
+    kBgra,  // the rendered pixels as they are, without a header
+    kPpm,   // binary RGB portable pixmap (P6) over white
+    kPgm,   // binary gray portable graymap (P5) over white
+};
+
+// Parses the `outputFormat` argument: "png", "jpeg", "bgra", "ppm" or "pgm".
+inline bool parse_image_format(const std::string& name, ImageFormat& format) {
+    if (name == "png") format = ImageFormat::kPng;
+    else if (name == "jpeg") format = ImageFormat::kJpeg;
+    else if (name == "bgra") format = ImageFormat::kBgra;
+    else if (name == "ppm") format = ImageFormat::kPpm;
+    else if (name == "pgm") format = ImageFormat::kPgm;
+    else return false;
+    return true;
+}
+
+// The name parse_image_format() reads back
+inline const char* image_format_name(ImageFormat format) {
+    switch (format) {
+        case ImageFormat::kPng: return "png";
+        case ImageFormat::kJpeg: return "jpeg";
+        case ImageFormat::kBgra: return "bgra";
+        case ImageFormat::kPpm: return "ppm";
+        case ImageFormat::kPgm: return "pgm";
+    }
+    return "png";
+}
+
+// The path of an image named `base` in `format`. Raw BGRA files have no
+// header, so their size is part of the name: "image_1_612x792.bgra".
+inline std::string image_file_name(const std::string& base, ImageFormat format, int width, int height) {
+    switch (format) {
+        case ImageFormat::kPng: return base + ".png";
+        case ImageFormat::kJpeg: return base + ".jpg";
+        case ImageFormat::kPpm: return base + ".ppm";
+        case ImageFormat::kPgm: return base + ".pgm";
+        case ImageFormat::kBgra: break;
+    }
+    return base + "_" + std::to_string(width) + "x" + std::to_string(height) + ".bgra";
+}
+
+// The JPEG quality for an ImageCompression value: 95 for none down to 40 for
+// high.
+inline int jpeg_quality(int compression) {
+    if (compression < 0) compression = 0;
+    if (compression > 100) compression = 100;
+    return 95 - compression * 55 / 100;
+}
+
+// Writes a `width` x `height` image in any ImageFormat, fed BGRA rows as
+// PDFium renders them.
+//
+// PNG, BGRA and the portable formats are streamed to the file row by row.
+// JPEG rows are kept, as RGB, until Finish() encodes them with
+// stbi_write_jpg, so a JPEG holds the whole image in memory. Formats without
+// alpha are composited over white, since pages are rendered on a transparent
+// background. The image goes to a file, or is appended to a buffer in memory.
+class ImageWriter {
+public:
+    ImageWriter(const std::string& path, int width, int height, ImageFormat format, int compression)
+        : path_(path), width_(width), height_(height), format_(format), compression_(compression) {
+        Open();
+    }
+
+    ImageWriter(std::vector<uint8_t>* output, int width, int height, ImageFormat format, int compression)
+        : path_("memory"), width_(width), height_(height), format_(format), compression_(compression),
+          memory_(output) {
+        Open();
+    }
+
+    ~ImageWriter() {
+        if (file_) fclose(file_);
+    }
+
+    ImageWriter(const ImageWriter&) = delete;
+    ImageWriter& operator=(const ImageWriter&) = delete;
+
+    bool ok() const { return ok_; }
+
+    // Appends `rows` rows of BGRA pixels, `stride` bytes apart.
+    bool WriteRows(const uint8_t* bgra, int rows, int stride) {
+        if (!ok_ || rows_written_ + rows > height_) return false;
+        for (int y = 0; y < rows && ok_; ++y, ++rows_written_) {
+            const uint8_t* src = bgra + (size_t)y * stride;
+            switch (format_) {
+                case ImageFormat::kPng:
+                    swizzle_rgba_bgra(src, (size_t)stride, row_.data(), row_.size(), width_, 1, false);
+                    ok_ = png_->WriteRow(row_.data());
+                    break;
+                case ImageFormat::kBgra:
+                    ok_ = Write(src, row_.size());
+                    break;
+                case ImageFormat::kPgm:
+                    for (int x = 0; x < width_; ++x) {
+                        const uint8_t* pixel = src + x * 4;
+                        // Rec. 601 luma, in 8-bit fixed point
+                        int luma = (OverWhite(pixel[2], pixel[3]) * 77 + OverWhite(pixel[1], pixel[3]) * 150 +
+                                    OverWhite(pixel[0], pixel[3]) * 29) >> 8;
+                        row_[x] = (uint8_t)luma;
+                    }
+                    ok_ = Write(row_.data(), row_.size());
+                    break;
+                case ImageFormat::kJpeg:
+                case ImageFormat::kPpm:
+                    for (int x = 0; x < width_; ++x) {
+                        const uint8_t* pixel = src + x * 4;
+                        row_[x * 3] = OverWhite(pixel[2], pixel[3]);
+                        row_[x * 3 + 1] = OverWhite(pixel[1], pixel[3]);
+                        row_[x * 3 + 2] = OverWhite(pixel[0], pixel[3]);
+                    }
+                    if (format_ == ImageFormat::kPpm) {
+                        ok_ = Write(row_.data(), row_.size());
+                    } else {
+                        pixels_.insert(pixels_.end(), row_.begin(), row_.end());
+                    }
+                    break;
+            }
+        }
+        return ok_;
+    }
+
+    // Closes the file without completing it.
+    void Abort() {
+        if (png_) png_->Abort();
+        if (file_) fclose(file_);
+        file_ = nullptr;
+        ok_ = false;
+    }
+
+    // Ends the image and closes the file. Every row must have been written.
+    bool Finish() {
+        if (!ok_ || rows_written_ != height_) return false;
+        if (png_) {
+            ok_ = png_->Finish();
+            bytes_written_ = png_->bytes_written();
+        } else {
+            if (format_ == ImageFormat::kJpeg) {
+                auto write = [](void* context, void* data, int size) {
+                    ImageWriter* writer = static_cast<ImageWriter*>(context);
+                    writer->ok_ = writer->Write(data, (size_t)size) && writer->ok_;
+                };
+                ok_ = stbi_write_jpg_to_func(write, this, width_, height_, 3, pixels_.data(),
+                                             jpeg_quality(compression_)) &&
+                      ok_;
+                pixels_ = std::vector<uint8_t>();
+            }
+            if (file_) ok_ = (fclose(file_) == 0) && ok_;
+            file_ = nullptr;
+        }
+        if (!ok_) return false;
+        encode_micros_ = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+        return true;
+    }
+
+    uint64_t bytes_written() const { return bytes_written_; }
+    uint64_t encode_micros() const { return encode_micros_; }
+
+private:
+    void Open() {
+        start_ = std::chrono::steady_clock::now();
+        if (width_ <= 0 || height_ <= 0) return;
+        if (format_ == ImageFormat::kPng) {
+            png_.reset(memory_ ? new PngWriter(memory_, width_, height_, compression_)
+                               : new PngWriter(path_, width_, height_, compression_));
+            ok_ = png_->ok();
+            row_.resize((size_t)width_ * 4);
+            return;
+        }
+        if (format_ == ImageFormat::kJpeg) {
+            // Sizes are 16-bit in JPEG headers
+            if (width_ > 65535 || height_ > 65535) return;
+            pixels_.reserve((size_t)width_ * height_ * 3);
+        }
+        if (!memory_) {
+            file_ = fopen(path_.c_str(), "wb");
+            if (!file_) return;
+        }
+        row_.resize((size_t)width_ * (format_ == ImageFormat::kPgm ? 1 : format_ == ImageFormat::kBgra ? 4 : 3));
+        ok_ = true;
+        if (format_ == ImageFormat::kPpm || format_ == ImageFormat::kPgm) {
+            std::string header = (format_ == ImageFormat::kPpm ? "P6\n" : "P5\n") + std::to_string(width_) + " " +
+                                 std::to_string(height_) + "\n255\n";
+            ok_ = Write(header.data(), header.size());
+        }
+    }
+
+    // A color channel with its alpha composited over white
+    static uint8_t OverWhite(int value, int alpha) { return (uint8_t)((value * alpha + 255 * (255 - alpha)) / 255); }
+
+    bool Write(const void* data, size_t size) {
+        if (memory_) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            memory_->insert(memory_->end(), bytes, bytes + size);
+        } else if (fwrite(data, 1, size, file_) != size) {
+            return false;
+        }
+        bytes_written_ += size;
+        return true;
+    }
+
+    std::string path_;
+    int width_;
+    int height_;
+    ImageFormat format_;
+    int compression_;
+    bool ok_ = false;
+    int rows_written_ = 0;
+    std::unique_ptr<PngWriter> png_;
+    FILE* file_ = nullptr;
+    std::vector<uint8_t>* memory_ = nullptr;  // written to instead of file_ when set
+    std::vector<uint8_t> row_;     // one converted row
+    std::vector<uint8_t> pixels_;  // the RGB rows of a JPEG
+    uint64_t bytes_written_ = 0;
+    uint64_t encode_micros_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Saves a BGRA buffer, as rendered by PDFium, in `format`. The file size is
+// stored in `bytes_written` when given.
+inline bool save_bgra_image(const uint8_t* bgra, int width, int height, int stride, const std::string& output_path,
+                            ImageFormat format, int compression, uint64_t* bytes_written = nullptr) {
+    if (!bgra || width <= 0 || height <= 0) return false;
+    ImageWriter writer(output_path, width, height, format, compression);
+    if (!writer.WriteRows(bgra, height, stride) || !writer.Finish()) return false;
+    if (bytes_written) *bytes_written = writer.bytes_written();
+    return true;
+}
+
+// Encodes a BGRA buffer in `format`, appending the image to `output`.
+inline bool encode_bgra_image(const uint8_t* bgra, int width, int height, int stride, ImageFormat format,
+                              int compression, std::vector<uint8_t>& output) {
+    if (!bgra || width <= 0 || height <= 0) return false;
+    ImageWriter writer(&output, width, height, format, compression);
+    return writer.WriteRows(bgra, height, stride) && writer.Finish();
+}
+
+#endif  // PDF_COMBINER_IMAGE_WRITER_H_
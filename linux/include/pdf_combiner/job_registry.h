@@ -0,0 +1,56 @@
+#ifndef PDF_COMBINER_JOB_REGISTRY_H_
+#define PDF_COMBINER_JOB_REGISTRY_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Cancellation flags of the method calls that carry a `jobId`.
+//
+// A job is registered on the main thread when its call is queued, so a
+// cancel() arriving before a worker picks it up is not lost. The worker
+// unregisters it once the response is ready.
+class JobRegistry {
+public:
+    typedef std::shared_ptr<std::atomic<bool>> CancelFlag;
+
+    CancelFlag Register(const std::string& job_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        CancelFlag& flag = jobs_[job_id];
+        if (!flag) flag = std::make_shared<std::atomic<bool>>(false);
+        return flag;
+    }
+
+    void Unregister(const std::string& job_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.erase(job_id);
+    }
+
+    // Returns the flag of a registered job, or null.
+    CancelFlag Find(const std::string& job_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(job_id);
+        return it != jobs_.end() ? it->second : CancelFlag();
+    }
+
+    // Returns false if no such job is queued or running.
+    bool Cancel(const std::string& job_id) {
+        CancelFlag flag = Find(job_id);
+        if (!flag) return false;
+        flag->store(true);
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, CancelFlag> jobs_;
+};
+
+inline JobRegistry& job_registry() {
+    static JobRegistry registry;
+    return registry;
+}
+
+#endif  // PDF_COMBINER_JOB_REGISTRY_H_
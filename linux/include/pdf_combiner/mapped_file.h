@@ -0,0 +1,111 @@
+#ifndef PDF_COMBINER_MAPPED_FILE_H_
+#define PDF_COMBINER_MAPPED_FILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../pdfium/fpdfview.h"
+#include "native_stats.h"
+
+// Read-only memory mapping of an input file, exposed to PDFium as an
+// FPDF_FILEACCESS.
+//
+// PDFium only asks for the byte ranges it parses, so with the mapping only
+// those pages are faulted in: rendering two pages of a huge scanned PDF no
+// longer reads the whole file. The kernel readahead is disabled because
+// PDFium jumps between the cross-reference table and the objects it needs.
+//
+// The file must not be truncated while it is mapped.
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data_ = static_cast<const uint8_t*>(mapping);
+                size_ = (size_t)st.st_size;
+                madvise(mapping, size_, MADV_RANDOM);
+            }
+        }
+        close(fd);
+
+        page_size_ = (size_t)sysconf(_SC_PAGESIZE);
+        touched_pages_.resize((size_ + page_size_ - 1) / page_size_, false);
+
+        memset(&file_access_, 0, sizeof(file_access_));
+        file_access_.m_FileLen = (unsigned long)size_;
+        file_access_.m_GetBlock = GetBlock;
+        file_access_.m_Param = this;
+    }
+
+    ~MappedFile() {
+        if (!data_) return;
+        NativeStats& stats = native_stats();
+        stats.mapped_file_bytes += size_;
+        stats.mapped_bytes_read += bytes_read_;
+        stats.mapped_bytes_touched += BytesTouched();
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool IsOpen() const { return data_ != nullptr; }
+
+    // Loads the mapped file as a document. The mapping must outlive it.
+    FPDF_DOCUMENT LoadDocument(FPDF_BYTESTRING password = nullptr) {
+        if (!data_) return nullptr;
+        return FPDF_LoadCustomDocument(&file_access_, password);
+    }
+
+    // For APIs taking a file, like FPDFImageObj_LoadJpegFileInline
+    FPDF_FILEACCESS* file_access() { return data_ ? &file_access_ : nullptr; }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Sum of the ranges PDFium asked for, re-reads included.
+    uint64_t bytes_read() const { return bytes_read_; }
+
+    // Distinct file pages PDFium asked for, i.e. the pages faulted in.
+    uint64_t BytesTouched() const {
+        uint64_t pages = 0;
+        for (bool touched : touched_pages_) pages += touched ? 1 : 0;
+        uint64_t bytes = pages * page_size_;
+        return bytes < size_ ? bytes : size_;
+    }
+
+private:
+    static int GetBlock(void* param, unsigned long position, unsigned char* buffer, unsigned long size) {
+        MappedFile* self = static_cast<MappedFile*>(param);
+        if (position > self->size_ || size > self->size_ - position) {
+            return 0;  // out of bounds
+        }
+        memcpy(buffer, self->data_ + position, size);
+        self->bytes_read_ += size;
+        if (size > 0) {
+            size_t first = position / self->page_size_;
+            size_t last = (position + size - 1) / self->page_size_;
+            for (size_t page = first; page <= last; ++page) self->touched_pages_[page] = true;
+        }
+        return 1;
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t page_size_ = 4096;
+    FPDF_FILEACCESS file_access_;
+    uint64_t bytes_read_ = 0;
+    std::vector<bool> touched_pages_;
+};
+
+#endif  // PDF_COMBINER_MAPPED_FILE_H_
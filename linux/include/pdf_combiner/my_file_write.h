@@ -1,27 +1,168 @@
+#ifndef PDF_COMBINER_MY_FILE_WRITE_H_
+#define PDF_COMBINER_MY_FILE_WRITE_H_
+
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../pdfium/fpdf_save.h"
+#include "native_stats.h"
+#include "progress_reporter.h"
+
+// FPDF_FILEWRITE sink used by FPDF_SaveAsCopy.
+//
+// The output is opened once and written through a large user-space buffer,
+// so PDFium's many small blocks turn into a few big write() calls. Data goes
+// to a temporary file next to the target, which replaces the target only
+// when Commit() succeeds: an existing file is overwritten, never appended
+// to, and a failed save leaves it untouched.
+class MyFileWrite : public FPDF_FILEWRITE {
+public:
+    static const size_t kBufferSize = 1 << 20;
+
+    explicit MyFileWrite(const char* filename) : filename(filename) {
+        static std::atomic<unsigned> sequence{0};
+        version = 1;
+        WriteBlock = MyWriteBlock;
+        temp_filename = this->filename + ".tmp." + std::to_string(getpid()) + "." +
+                        std::to_string(sequence++);
+        fd = open(temp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        buffer.reserve(kBufferSize);
+    }
 
-typedef struct MyFileWrite {
-    int version;
-    int (*WriteBlock)(struct MyFileWrite* pThis, const void* pData, unsigned long size);
-    const char* filename;  // Name of the file to write
-} MyFileWrite;
+    ~MyFileWrite() { Abort(); }
 
-// MyWriteBlock declaration
-static int MyWriteBlock(MyFileWrite* pThis, const void* pData, unsigned long size);
+    MyFileWrite(const MyFileWrite&) = delete;
+    MyFileWrite& operator=(const MyFileWrite&) = delete;
 
-// MyWriteBlock implementation
-static int MyWriteBlock(MyFileWrite* pThis, const void* pData, unsigned long size) {
-    if (!pThis || !pData) {
-        return 0;  // if params are null, return 0
+    bool IsOpen() const { return fd >= 0; }
+
+    // Flushes the buffer and moves the temporary file over the target.
+    bool Commit() {
+        if (fd < 0 || failed || !Flush()) {
+            Abort();
+            return false;
+        }
+        int close_result = close(fd);
+        fd = -1;
+        if (close_result != 0 || rename(temp_filename.c_str(), filename.c_str()) != 0) {
+            unlink(temp_filename.c_str());
+            return false;
+        }
+        committed = true;
+        RecordStats();
+        return true;
+    }
+
+    // Discards everything written so far.
+    void Abort() {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+        if (!committed && !aborted) {
+            unlink(temp_filename.c_str());
+            aborted = true;
+        }
     }
 
-    FILE* file = fopen(pThis->filename, "ab");  // Open file in append binary mode
-    if (!file) {
-        return 0;  // if file cannot be opened, return 0
+    // I/O cost of this save, added to native_stats() once committed
+    uint64_t bytes_written = 0;
+    uint64_t write_calls = 0;
+    uint64_t write_micros = 0;
+
+    // Told about every write() to the output, may be null
+    ProgressReporter* progress = nullptr;
+
+private:
+    static int MyWriteBlock(FPDF_FILEWRITE* pThis, const void* pData, unsigned long size) {
+        MyFileWrite* self = static_cast<MyFileWrite*>(pThis);
+        if (!self || (!pData && size > 0) || self->fd < 0 || self->failed) {
+            return 0;  // if params are null or the file is not usable, return 0
+        }
+        const char* data = static_cast<const char*>(pData);
+
+        // Blocks larger than the buffer skip it entirely
+        if (self->buffer.size() + size > kBufferSize) {
+            if (!self->Flush()) return 0;
+            if (size >= kBufferSize) return self->WriteAll(data, size) ? 1 : 0;
+        }
+        self->buffer.insert(self->buffer.end(), data, data + size);
+        return 1;
     }
 
-    size_t written = fwrite(pData, 1, size, file);  // write data to file
-    fclose(file);  // Cierra el archivo
+    bool Flush() {
+        if (buffer.empty()) return true;
+        bool ok = WriteAll(buffer.data(), buffer.size());
+        buffer.clear();
+        return ok;
+    }
+
+    bool WriteAll(const char* data, size_t size) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t bytes_before = bytes_written;
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            write_calls++;
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                failed = true;
+                break;
+            }
+            data += written;
+            size -= (size_t)written;
+            bytes_written += (uint64_t)written;
+        }
+        write_micros += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        if (progress) progress->Advance(0, bytes_written - bytes_before);
+        return !failed;
+    }
+
+    void RecordStats() const {
+        NativeStats& stats = native_stats();
+        stats.bytes_written += bytes_written;
+        stats.write_calls += write_calls;
+        stats.write_micros += write_micros;
+    }
+
+    std::string filename;
+    std::string temp_filename;
+    int fd = -1;
+    std::vector<char> buffer;
+    bool failed = false;
+    bool committed = false;
+    bool aborted = false;
+};
+
+// FPDF_FILEWRITE sink that keeps the saved document in memory.
+class MyMemoryWrite : public FPDF_FILEWRITE {
+public:
+    MyMemoryWrite() {
+        version = 1;
+        WriteBlock = MyWriteBlock;
+    }
+
+    std::vector<uint8_t> data;
+
+private:
+    static int MyWriteBlock(FPDF_FILEWRITE* pThis, const void* pData, unsigned long size) {
+        MyMemoryWrite* self = static_cast<MyMemoryWrite*>(pThis);
+        if (!self || (!pData && size > 0)) {
+            return 0;  // if params are null, return 0
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(pData);
+        self->data.insert(self->data.end(), bytes, bytes + size);
+        return 1;
+    }
+};
 
-    return written == size ? 1 : 0;  // Return 1 if all data was written, 0 otherwise
-}
\ No newline at end of file
+#endif  // PDF_COMBINER_MY_FILE_WRITE_H_
@@ -0,0 +1,37 @@
+#ifndef PDF_COMBINER_NATIVE_STATS_H_
+#define PDF_COMBINER_NATIVE_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+
+// Process-wide counters reported by the getNativeStats method call.
+typedef struct NativeStats {
+    // Output files
+    std::atomic<uint64_t> bytes_written{0};
+    std::atomic<uint64_t> write_calls{0};
+    std::atomic<uint64_t> write_micros{0};
+
+    // Memory-mapped inputs
+    std::atomic<uint64_t> mapped_file_bytes{0};
+    std::atomic<uint64_t> mapped_bytes_read{0};
+    std::atomic<uint64_t> mapped_bytes_touched{0};
+
+    // Documents kept open by DocumentCache, and the size of their files
+    std::atomic<uint64_t> document_cache_hits{0};
+    std::atomic<uint64_t> document_cache_misses{0};
+    std::atomic<uint64_t> document_cache_evictions{0};
+    std::atomic<int64_t> document_cache_documents{0};
+    std::atomic<int64_t> document_cache_bytes{0};
+
+    // Encoded PNG images
+    std::atomic<uint64_t> png_images{0};
+    std::atomic<uint64_t> png_bytes{0};
+    std::atomic<uint64_t> png_encode_micros{0};
+} NativeStats;
+
+inline NativeStats& native_stats() {
+    static NativeStats stats;
+    return stats;
+}
+
+#endif  // PDF_COMBINER_NATIVE_STATS_H_
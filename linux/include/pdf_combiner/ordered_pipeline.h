@@ -0,0 +1,94 @@
+#ifndef PDF_COMBINER_ORDERED_PIPELINE_H_
+#define PDF_COMBINER_ORDERED_PIPELINE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs `task(0) .. task(item_count - 1)` on background threads and hands the
+// results back to a single consumer in index order.
+//
+// Workers may run ahead of the consumer by at most `window` items, so the
+// results waiting to be consumed plus those being computed never exceed the
+// window: memory stays bounded however many items there are. Destroying the
+// pipeline early stops the workers after their current item.
+template <typename Result>
+class OrderedPipeline {
+public:
+    typedef std::function<Result(size_t index)> Task;
+
+    OrderedPipeline(size_t item_count, size_t worker_count, size_t window, Task task)
+        : item_count_(item_count), window_(window > 0 ? window : 1), task_(std::move(task)) {
+        if (worker_count == 0) worker_count = 1;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back([this] { Run(); });
+        }
+    }
+
+    ~OrderedPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        space_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+    }
+
+    OrderedPipeline(const OrderedPipeline&) = delete;
+    OrderedPipeline& operator=(const OrderedPipeline&) = delete;
+
+    // Blocks until the next result in order is ready. Returns false once every
+    // result has been consumed.
+    bool Next(Result& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (next_consume_ >= item_count_) return false;
+        ready_.wait(lock, [this] { return done_.count(next_consume_) > 0; });
+        auto it = done_.find(next_consume_);
+        out = std::move(it->second);
+        done_.erase(it);
+        next_consume_++;
+        space_.notify_all();
+        return true;
+    }
+
+private:
+    void Run() {
+        while (true) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                space_.wait(lock, [this] {
+                    return stopped_ || next_claim_ >= item_count_ || next_claim_ < next_consume_ + window_;
+                });
+                if (stopped_ || next_claim_ >= item_count_) return;
+                index = next_claim_++;
+            }
+            Result result = task_(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_[index] = std::move(result);
+            }
+            ready_.notify_one();
+        }
+    }
+
+    const size_t item_count_;
+    const size_t window_;
+    Task task_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable space_;
+    std::map<size_t, Result> done_;
+    size_t next_claim_ = 0;
+    size_t next_consume_ = 0;
+    bool stopped_ = false;
+};
+
+#endif  // PDF_COMBINER_ORDERED_PIPELINE_H_
@@ -0,0 +1,105 @@
+#ifndef PDF_COMBINER_PAGE_ENCODER_H_
+#define PDF_COMBINER_PAGE_ENCODER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "image_writer.h"
+#include "progress_reporter.h"
+
+// A rendered page waiting to be written as an image file, or encoded into
+// `output` when it is set.
+struct EncodeJob {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bgra;  // tightly packed, stride is width * 4
+    std::string output_path;
+    std::vector<uint8_t>* output = nullptr;
+};
+
+// Encodes rendered pages to image files on background threads.
+//
+// PDFium cannot render on several threads at once, so the caller renders the
+// pages one by one and hands each buffer over here: PNG and JPEG encoding,
+// which costs more than rendering for most pages, runs in parallel and
+// overlaps with the rendering of the next pages. The queue capacity bounds how many rendered
+// pages are held in memory. The encoders never call into PDFium. Each written
+// page is reported to `progress`, which may be null.
+class PageEncoder {
+public:
+    PageEncoder(size_t worker_count, size_t queue_capacity, ImageFormat format, int compression,
+                ProgressReporter* progress = nullptr)
+        : queue_(queue_capacity), format_(format), compression_(compression), progress_(progress) {
+        if (worker_count == 0) worker_count = 1;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back([this] { Run(); });
+        }
+    }
+
+    ~PageEncoder() { Finish(); }
+
+    PageEncoder(const PageEncoder&) = delete;
+    PageEncoder& operator=(const PageEncoder&) = delete;
+
+    // Queues a page, blocking while the queue is full.
+    bool Submit(EncodeJob job) { return !failed_ && queue_.Push(std::move(job)); }
+
+    // Drops the queued pages and waits for the ones being encoded.
+    void Cancel() {
+        failed_ = true;
+        queue_.Clear();
+        Finish();
+    }
+
+    // Waits until every queued page is written. Returns false if any failed.
+    bool Finish() {
+        queue_.Close();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+        workers_.clear();
+        return !failed_;
+    }
+
+    // The size of the pages encoded into an `output` buffer so far
+    uint64_t output_bytes() const { return output_bytes_; }
+
+private:
+    void Run() {
+        EncodeJob job;
+        while (queue_.Pop(job)) {
+            if (failed_) continue;  // drain without encoding
+            uint64_t bytes_written = 0;
+            bool saved;
+            if (job.output) {
+                saved = encode_bgra_image(job.bgra.data(), job.width, job.height, job.width * 4, format_,
+                                          compression_, *job.output);
+                bytes_written = job.output->size();
+                output_bytes_ += bytes_written;
+            } else {
+                saved = save_bgra_image(job.bgra.data(), job.width, job.height, job.width * 4, job.output_path,
+                                        format_, compression_, &bytes_written);
+            }
+            if (!saved) {
+                failed_ = true;
+            } else if (progress_) {
+                progress_->Advance(1, bytes_written);
+            }
+            job.bgra = std::vector<uint8_t>();  // release the pixels before waiting
+        }
+    }
+
+    BoundedQueue<EncodeJob> queue_;
+    const ImageFormat format_;
+    const int compression_;
+    ProgressReporter* const progress_;
+    std::vector<std::thread> workers_;
+    std::atomic<bool> failed_{false};
+    std::atomic<uint64_t> output_bytes_{0};
+};
+
+#endif  // PDF_COMBINER_PAGE_ENCODER_H_
@@ -0,0 +1,73 @@
+#ifndef PDF_COMBINER_PDF_COMPACTOR_H_
+#define PDF_COMBINER_PDF_COMPACTOR_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "../pdfium/fpdf_save.h"
+#include "pdf_object.h"
+#include "pdf_reader.h"
+#include "pdf_writer.h"
+
+// Rewrites a PDF with a compact PdfWriter (object streams and a
+// cross-reference stream). Only the objects reachable from the trailer
+// (/Root and /Info) are kept, renumbered from 1 in the order they are found,
+// which drops whatever PDFium saved without using it anymore. Objects are
+// read and written one at a time.
+class PdfCompactor {
+public:
+    PdfCompactor(const uint8_t* data, size_t size) : reader_(data, size) {}
+
+    PdfCompactor(const PdfCompactor&) = delete;
+    PdfCompactor& operator=(const PdfCompactor&) = delete;
+
+    // False if the input cannot be read (not a PDF, or encrypted) or `sink`
+    // fails.
+    bool Write(FPDF_FILEWRITE* sink) {
+        if (!reader_.Open() || reader_.IsEncrypted()) return false;
+        PdfWriter writer(sink, true);
+        writer.WriteHeader(reader_.Version() > "1.5" ? reader_.Version() : "1.5");
+
+        std::unordered_map<int, int> numbers;
+        std::deque<int> pending;
+        auto renumber = [&](PdfValue& ref) {
+            auto found = numbers.find((int)ref.integer);
+            if (found == numbers.end()) {
+                found = numbers.insert({(int)ref.integer, writer.NewObjectNumber()}).first;
+                pending.push_back((int)ref.integer);
+            }
+            ref = PdfValue::Reference(found->second);
+        };
+
+        PdfValue trailer = PdfValue::Dictionary();
+        for (const char* key : {"Root", "Info", "ID"}) {
+            const PdfValue* value = reader_.Trailer().Find(key);
+            if (value) trailer.Set(key, *value);
+        }
+        for_each_reference(trailer, renumber);
+
+        // Objects that cannot be read stay free, which reads as null
+        PdfIndirectObject object;
+        while (!pending.empty()) {
+            int number = pending.front();
+            pending.pop_front();
+            if (!reader_.ReadObject(number, object)) continue;
+            for_each_reference(object.value, renumber);
+            if (!writer.WriteObject(object, numbers[number])) return false;
+        }
+        return writer.WriteXrefAndTrailer(std::move(trailer));
+    }
+
+private:
+    PdfReader reader_;
+};
+
+// Compacts the PDF in `data` into `sink`.
+inline bool compact_pdf(const uint8_t* data, size_t size, FPDF_FILEWRITE* sink) {
+    PdfCompactor compactor(data, size);
+    return compactor.Write(sink);
+}
+
+#endif  // PDF_COMBINER_PDF_COMPACTOR_H_
@@ -0,0 +1,118 @@
+#ifndef PDF_COMBINER_PDF_FILTERS_H_
+#define PDF_COMBINER_PDF_FILTERS_H_
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "pdf_object.h"
+
+// Inflates zlib data (FlateDecode). Truncated or corrupt data keeps what was
+// decoded before the error, as viewers do; false only if nothing was.
+inline bool inflate_bytes(const std::string& input, std::string& output) {
+    output.clear();
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) return false;
+    stream.next_in = (Bytef*)input.data();
+    stream.avail_in = (uInt)input.size();
+    char buffer[64 * 1024];
+    int status = Z_OK;
+    while (status == Z_OK) {
+        stream.next_out = (Bytef*)buffer;
+        stream.avail_out = sizeof(buffer);
+        status = inflate(&stream, Z_NO_FLUSH);
+        output.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return status == Z_STREAM_END || !output.empty();
+}
+
+// Deflates `input` into zlib data (FlateDecode) at `level`.
+inline bool deflate_bytes(const std::string& input, int level, std::string& output) {
+    uLongf size = compressBound((uLong)input.size());
+    output.resize(size);
+    if (compress2((Bytef*)&output[0], &size, (const Bytef*)input.data(), (uLong)input.size(), level) != Z_OK) {
+        output.clear();
+        return false;
+    }
+    output.resize(size);
+    return true;
+}
+
+// Undoes the PNG predictors (/Predictor 10 to 15) used by cross-reference and
+// object streams. Each row starts with the PNG filter type of that row.
+inline bool undo_png_predictor(std::string& data, int colors, int bits_per_component, int columns) {
+    if (colors < 1 || bits_per_component < 1 || columns < 1) return false;
+    size_t pixel_bytes = ((size_t)colors * bits_per_component + 7) / 8;
+    size_t row_bytes = ((size_t)colors * bits_per_component * columns + 7) / 8;
+    std::string output;
+    output.reserve(data.size());
+    std::string previous(row_bytes, '\0');
+    for (size_t pos = 0; pos + 1 + row_bytes <= data.size(); pos += row_bytes + 1) {
+        int filter = (uint8_t)data[pos];
+        const uint8_t* in = (const uint8_t*)data.data() + pos + 1;
+        std::string row(row_bytes, '\0');
+        for (size_t i = 0; i < row_bytes; ++i) {
+            int left = i >= pixel_bytes ? (uint8_t)row[i - pixel_bytes] : 0;
+            int up = (uint8_t)previous[i];
+            int up_left = i >= pixel_bytes ? (uint8_t)previous[i - pixel_bytes] : 0;
+            int value = in[i];
+            switch (filter) {
+                case 0: break;
+                case 1: value += left; break;
+                case 2: value += up; break;
+                case 3: value += (left + up) / 2; break;
+                case 4: {
+                    int p = left + up - up_left;
+                    int pa = abs(p - left), pb = abs(p - up), pc = abs(p - up_left);
+                    value += (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : up_left);
+                    break;
+                }
+                default: return false;
+            }
+            row[i] = (char)value;
+        }
+        output += row;
+        previous.swap(row);
+    }
+    data.swap(output);
+    return true;
+}
+
+// Decodes stream data filtered with FlateDecode (and its PNG predictors) or
+// not filtered at all: enough for the object and cross-reference streams the
+// reader has to look into. Other filters are left to PDFium.
+inline bool decode_stream(const PdfValue& dict, const std::string& raw, std::string& output) {
+    const PdfValue* filter = dict.Find("Filter");
+    const PdfValue* params = dict.Find("DecodeParms");
+    if (filter && filter->type == PdfValue::kArray) {
+        if (filter->items.size() > 1) return false;
+        filter = filter->items.empty() ? nullptr : &filter->items[0];
+    }
+    if (params && params->type == PdfValue::kArray) {
+        params = params->items.empty() ? nullptr : &params->items[0];
+    }
+    if (!filter) {
+        output = raw;
+        return true;
+    }
+    if (!filter->IsName("FlateDecode") && !filter->IsName("Fl")) return false;
+    if (!inflate_bytes(raw, output)) return false;
+
+    int predictor = 1;
+    if (params && params->IsDictionary()) {
+        const PdfValue* value = params->Find("Predictor");
+        if (value) predictor = (int)value->AsInteger(1);
+    }
+    if (predictor == 1) return true;
+    if (predictor < 10) return false;  // TIFF predictor, not used by these streams
+    auto param = [params](const char* key, int fallback) {
+        const PdfValue* value = params->Find(key);
+        return value ? (int)value->AsInteger(fallback) : fallback;
+    };
+    return undo_png_predictor(output, param("Colors", 1), param("BitsPerComponent", 8), param("Columns", 1));
+}
+
+#endif  // PDF_COMBINER_PDF_FILTERS_H_
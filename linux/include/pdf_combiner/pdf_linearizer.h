@@ -0,0 +1,484 @@
+#ifndef PDF_COMBINER_PDF_LINEARIZER_H_
+#define PDF_COMBINER_PDF_LINEARIZER_H_
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pdf_object.h"
+#include "pdf_reader.h"
+#include "pdf_writer.h"
+
+// Rewrites a PDF as a linearized ("fast web view") file, laid out as in
+// Annex F of ISO 32000-1:
+//
+//   header, linearization dictionary, first-page cross-reference table,
+//   catalog and document-level objects, hint stream,
+//   first page (its page object first, then everything it uses),
+//   every other page (page object first, then its private objects),
+//   objects shared by several pages, the rest (page tree, outlines, ...),
+//   main cross-reference table.
+//
+// The hint stream carries the page offset and shared object hint tables, so
+// a viewer reading over HTTP range requests can show the first page from the
+// head of the file and fetch any other page directly. Objects not reachable
+// from the trailer are dropped and inheritable page attributes are copied
+// into the pages. Encrypted files are refused: their strings are encrypted
+// with keys derived from the object numbers that this rewrite changes.
+class PdfLinearizer {
+public:
+    PdfLinearizer(const uint8_t* data, size_t size) : reader_(data, size) {}
+
+    PdfLinearizer(const PdfLinearizer&) = delete;
+    PdfLinearizer& operator=(const PdfLinearizer&) = delete;
+
+    // Appends the linearized file to `out`. False if the input cannot be read
+    // or has no pages.
+    bool Write(std::string& out) {
+        if (!reader_.Open() || reader_.IsEncrypted()) return false;
+        if (!LoadObjects() || !CollectPages()) return false;
+        Partition();
+        Number();
+        Build(out);
+        return true;
+    }
+
+private:
+    enum Kind { kOther, kCatalog, kPagesNode, kPage };
+    enum Section { kUnassigned, kDocument, kFirstPage, kOtherPage, kShared, kRest };
+
+    // Writes integers of any bit width, most significant bit first.
+    struct BitWriter {
+        std::string data;
+        uint32_t pending = 0;
+        int pending_bits = 0;
+
+        void Put(uint64_t value, int bits) {
+            for (int i = bits - 1; i >= 0; --i) {
+                pending = (pending << 1) | (uint32_t)((value >> i) & 1);
+                if (++pending_bits == 8) {
+                    data += (char)pending;
+                    pending = 0;
+                    pending_bits = 0;
+                }
+            }
+        }
+
+        void Align() {
+            if (pending_bits > 0) Put(0, 8 - pending_bits);
+        }
+    };
+
+    static int BitsFor(uint64_t value) {
+        int bits = 0;
+        while (value) {
+            bits++;
+            value >>= 1;
+        }
+        return bits;
+    }
+
+    bool Loaded(int64_t number) const {
+        return number > 0 && number < (int64_t)loaded_.size() && loaded_[number];
+    }
+
+    // Reads every object reachable from the trailer.
+    bool LoadObjects() {
+        int size = reader_.Size();
+        objects_.resize(size);
+        loaded_.assign(size, false);
+        std::vector<int> pending;
+        auto push = [&](const PdfValue& ref) {
+            if (ref.integer > 0 && ref.integer < size && !loaded_[ref.integer]) {
+                loaded_[ref.integer] = true;  // queued, cleared again if unreadable
+                pending.push_back((int)ref.integer);
+            }
+        };
+        for_each_reference(reader_.Trailer(), push);
+        while (!pending.empty()) {
+            int number = pending.back();
+            pending.pop_back();
+            if (!reader_.ReadObject(number, objects_[number])) {
+                loaded_[number] = false;
+                continue;
+            }
+            for_each_reference(objects_[number].value, push);
+        }
+        const PdfValue* root = reader_.Trailer().Find("Root");
+        root_ = root ? (int)root->integer : 0;
+        return Loaded(root_) && objects_[root_].value.IsDictionary();
+    }
+
+    // Finds the pages in order, copying inherited attributes into each page.
+    bool CollectPages() {
+        kinds_.assign(objects_.size(), kOther);
+        kinds_[root_] = kCatalog;
+        const PdfValue* pages = objects_[root_].value.Find("Pages");
+        if (!pages || !pages->IsReference()) return false;
+        WalkPageTree((int)pages->integer, PdfValue::Dictionary(), 0);
+        return !pages_.empty();
+    }
+
+    void WalkPageTree(int number, PdfValue inherited, int depth) {
+        static const char* const kInheritable[] = {"Resources", "MediaBox", "CropBox", "Rotate"};
+        if (depth > 64 || !Loaded(number) || kinds_[number] != kOther) return;
+        PdfValue& node = objects_[number].value;
+        if (!node.IsDictionary()) return;
+        const PdfValue* type = node.Find("Type");
+        const PdfValue* kids = node.Find("Kids");
+        if (type && type->IsName("Page")) kids = nullptr;
+        if (!kids) {
+            kinds_[number] = kPage;
+            for (const auto& entry : inherited.entries) {
+                if (!node.Find(entry.first)) node.Set(entry.first, entry.second);
+            }
+            pages_.push_back(number);
+            return;
+        }
+        kinds_[number] = kPagesNode;
+        for (const char* key : kInheritable) {
+            const PdfValue* value = node.Find(key);
+            if (!value) continue;
+            inherited.Set(key, *value);
+            node.Erase(key);
+        }
+        kids = node.Find("Kids");
+        if (!kids || kids->type != PdfValue::kArray) return;
+        std::vector<PdfValue> items = kids->items;
+        for (const PdfValue& kid : items) {
+            if (kid.IsReference()) WalkPageTree((int)kid.integer, inherited, depth + 1);
+        }
+    }
+
+    // Appends to `list` the objects reachable from `value` that are not yet
+    // in a section, stopping at pages, page tree nodes and the catalog.
+    void Reach(const PdfValue& value, std::vector<int>& list, int stamp) {
+        std::vector<int> pending;
+        auto push = [&](const PdfValue& ref) {
+            int number = (int)ref.integer;
+            if (!Loaded(number) || kinds_[number] != kOther || sections_[number] == kDocument ||
+                marks_[number] == stamp) {
+                return;
+            }
+            marks_[number] = stamp;
+            list.push_back(number);
+            pending.push_back(number);
+        };
+        for_each_reference(value, push);
+        while (!pending.empty()) {
+            int number = pending.back();
+            pending.pop_back();
+            for_each_reference(objects_[number].value, push);
+        }
+    }
+
+    void Partition() {
+        size_t size = objects_.size();
+        sections_.assign(size, kUnassigned);
+        marks_.assign(size, -1);
+
+        // Catalog and the document-level objects a viewer needs to open it
+        document_.push_back(root_);
+        sections_[root_] = kDocument;
+        const PdfValue& catalog = objects_[root_].value;
+        const PdfValue* page_mode = catalog.Find("PageMode");
+        std::vector<const char*> keys = {"ViewerPreferences", "PageMode", "Threads", "OpenAction", "AcroForm"};
+        if (page_mode && page_mode->IsName("UseOutlines")) keys.push_back("Outlines");
+        for (const char* key : keys) {
+            const PdfValue* value = catalog.Find(key);
+            if (value) Reach(*value, document_, -2);
+        }
+        for (int number : document_) sections_[number] = kDocument;
+
+        // What each page uses, and by how many pages each object is used
+        page_objects_.resize(pages_.size());
+        std::vector<int> users(size, 0);
+        for (size_t i = 0; i < pages_.size(); ++i) {
+            std::vector<int>& list = page_objects_[i];
+            list.push_back(pages_[i]);
+            for (const auto& entry : objects_[pages_[i]].value.entries) {
+                if (entry.first != "Parent") Reach(entry.second, list, (int)i);
+            }
+            for (size_t j = 1; j < list.size(); ++j) users[list[j]]++;
+        }
+
+        first_page_ = page_objects_[0];
+        for (int number : first_page_) sections_[number] = kFirstPage;
+        other_pages_.resize(pages_.size());
+        for (size_t i = 1; i < pages_.size(); ++i) {
+            for (size_t j = 0; j < page_objects_[i].size(); ++j) {
+                int number = page_objects_[i][j];
+                if (sections_[number] == kUnassigned && (j == 0 || users[number] == 1)) {
+                    sections_[number] = kOtherPage;
+                    other_pages_[i].push_back(number);
+                }
+            }
+        }
+        for (size_t i = 1; i < pages_.size(); ++i) {
+            for (int number : page_objects_[i]) {
+                if (sections_[number] != kUnassigned) continue;
+                sections_[number] = kShared;
+                shared_.push_back(number);
+            }
+        }
+        for (size_t number = 1; number < size; ++number) {
+            if (loaded_[number] && sections_[number] == kUnassigned) {
+                sections_[number] = kRest;
+                rest_.push_back((int)number);
+            }
+        }
+    }
+
+    // Pages after the first come first in the numbering, as the page offset
+    // hint table requires; the first-page section takes the last numbers.
+    void Number() {
+        new_numbers_.assign(objects_.size(), 0);
+        int next = 1;
+        for (size_t i = 1; i < pages_.size(); ++i) {
+            for (int number : other_pages_[i]) new_numbers_[number] = next++;
+        }
+        first_shared_number_ = next;
+        for (int number : shared_) new_numbers_[number] = next++;
+        for (int number : rest_) new_numbers_[number] = next++;
+        main_count_ = next - 1;
+
+        linearization_number_ = next++;
+        for (int number : document_) new_numbers_[number] = next++;
+        hint_number_ = next++;
+        for (int number : first_page_) new_numbers_[number] = next++;
+        last_number_ = next - 1;
+    }
+
+    std::string Serialize(int number) {
+        PdfIndirectObject object = objects_[number];
+        for_each_reference(object.value, [this](PdfValue& ref) {
+            int mapped = ref.integer > 0 && ref.integer < (int64_t)new_numbers_.size() ? new_numbers_[ref.integer] : 0;
+            if (mapped) {
+                ref.integer = mapped;
+                ref.generation = 0;
+            } else {
+                ref = PdfValue();  // a reference to a missing object means null
+            }
+        });
+        std::string out;
+        serialize_pdf_object(object, new_numbers_[number], out);
+        return out;
+    }
+
+    // Numbers padded to a fixed width, patched once the layout is known
+    static std::string Padded(uint64_t value) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), "%-10" PRIu64, value);
+        return buffer;
+    }
+
+    std::string LinearizationDictionary(uint64_t file_length, uint64_t hint_offset, uint64_t hint_length,
+                                        uint64_t first_page_end, uint64_t main_xref_entry) const {
+        return std::to_string(linearization_number_) + " 0 obj\n<</Linearized 1/L " + Padded(file_length) +
+               "/H[" + Padded(hint_offset) + " " + Padded(hint_length) + "]/O " +
+               std::to_string(new_numbers_[pages_[0]]) + "/E " + Padded(first_page_end) + "/N " +
+               std::to_string(pages_.size()) + "/T " + Padded(main_xref_entry) + ">>\nendobj\n";
+    }
+
+    static std::string XrefEntry(uint64_t offset) {
+        char buffer[24];
+        snprintf(buffer, sizeof(buffer), "%010" PRIu64 " 00000 n\r\n", offset);
+        return buffer;
+    }
+
+    std::string FirstPageXref(const std::vector<uint64_t>& offsets, uint64_t main_xref_offset) const {
+        std::string out = "xref\n" + std::to_string(main_count_ + 1) + " " +
+                          std::to_string(last_number_ - main_count_) + "\n";
+        for (int number = main_count_ + 1; number <= last_number_; ++number) out += XrefEntry(offsets[number]);
+        PdfValue trailer = PdfValue::Dictionary();
+        trailer.Set("Size", PdfValue::Integer(last_number_ + 1));
+        trailer.Set("Root", PdfValue::Reference(new_numbers_[root_]));
+        const PdfValue* info = reader_.Trailer().Find("Info");
+        if (info && info->IsReference() && Loaded(info->integer)) {
+            trailer.Set("Info", PdfValue::Reference(new_numbers_[info->integer]));
+        }
+        const PdfValue* id = reader_.Trailer().Find("ID");
+        if (id && id->type == PdfValue::kArray) trailer.Set("ID", *id);
+        std::string dict;
+        serialize_pdf_value(trailer, dict);
+        dict.resize(dict.size() - 2);  // reopen it for the padded /Prev
+        out += "trailer\n" + dict + "/Prev " + Padded(main_xref_offset) + ">>\nstartxref\n0\n%%EOF\n";
+        return out;
+    }
+
+    // The page offset and shared object hint tables (ISO 32000-1 F.4),
+    // with offsets computed as if the hint stream were absent.
+    std::string HintStream(const std::vector<uint64_t>& offsets, const std::vector<uint64_t>& lengths) const {
+        size_t page_count = pages_.size();
+        std::vector<uint64_t> object_counts(page_count), page_lengths(page_count);
+        std::vector<std::vector<uint64_t>> shared_ids(page_count);
+        std::vector<int> shared_index(objects_.size(), -1);
+        for (size_t j = 0; j < first_page_.size(); ++j) shared_index[first_page_[j]] = (int)j;
+        for (size_t j = 0; j < shared_.size(); ++j) shared_index[shared_[j]] = (int)(first_page_.size() + j);
+
+        for (size_t i = 0; i < page_count; ++i) {
+            const std::vector<int>& own = i == 0 ? first_page_ : other_pages_[i];
+            object_counts[i] = own.size();
+            for (int number : own) page_lengths[i] += lengths[new_numbers_[number]];
+            if (i == 0) continue;
+            for (int number : page_objects_[i]) {
+                if (sections_[number] == kFirstPage || sections_[number] == kShared) {
+                    shared_ids[i].push_back((uint64_t)shared_index[number]);
+                }
+            }
+        }
+
+        uint64_t least_objects = *std::min_element(object_counts.begin(), object_counts.end());
+        uint64_t most_objects = *std::max_element(object_counts.begin(), object_counts.end());
+        uint64_t least_length = *std::min_element(page_lengths.begin(), page_lengths.end());
+        uint64_t most_length = *std::max_element(page_lengths.begin(), page_lengths.end());
+        uint64_t most_shared = 0, greatest_id = 0;
+        for (const auto& ids : shared_ids) {
+            most_shared = std::max<uint64_t>(most_shared, ids.size());
+            for (uint64_t id : ids) greatest_id = std::max(greatest_id, id);
+        }
+        int object_bits = BitsFor(most_objects - least_objects);
+        int length_bits = BitsFor(most_length - least_length);
+        int shared_count_bits = BitsFor(most_shared);
+        int shared_id_bits = BitsFor(greatest_id);
+
+        BitWriter hints;
+        hints.Put(least_objects, 32);
+        hints.Put(offsets[new_numbers_[pages_[0]]], 32);
+        hints.Put(object_bits, 16);
+        hints.Put(least_length, 32);
+        hints.Put(length_bits, 16);
+        hints.Put(0, 32);  // content streams are not located separately:
+        hints.Put(0, 16);  // each page's "content" is the whole page
+        hints.Put(least_length, 32);
+        hints.Put(length_bits, 16);
+        hints.Put(shared_count_bits, 16);
+        hints.Put(shared_id_bits, 16);
+        hints.Put(0, 16);  // no fractional positions
+        hints.Put(1, 16);
+        for (size_t i = 0; i < page_count; ++i) hints.Put(object_counts[i] - least_objects, object_bits);
+        hints.Align();
+        for (size_t i = 0; i < page_count; ++i) hints.Put(page_lengths[i] - least_length, length_bits);
+        hints.Align();
+        for (size_t i = 0; i < page_count; ++i) hints.Put(shared_ids[i].size(), shared_count_bits);
+        hints.Align();
+        for (size_t i = 0; i < page_count; ++i) {
+            for (uint64_t id : shared_ids[i]) hints.Put(id, shared_id_bits);
+        }
+        hints.Align();
+        hints.Align();  // numerators, 0 bits each
+        hints.Align();  // content offsets, 0 bits each
+        for (size_t i = 0; i < page_count; ++i) hints.Put(page_lengths[i] - least_length, length_bits);
+        hints.Align();
+
+        // Shared object hint table: one object per group, the first-page
+        // objects first, then the shared objects section
+        size_t shared_table_offset = hints.data.size();
+        std::vector<uint64_t> group_lengths;
+        for (int number : first_page_) group_lengths.push_back(lengths[new_numbers_[number]]);
+        for (int number : shared_) group_lengths.push_back(lengths[new_numbers_[number]]);
+        uint64_t least_group = *std::min_element(group_lengths.begin(), group_lengths.end());
+        uint64_t most_group = *std::max_element(group_lengths.begin(), group_lengths.end());
+        int group_bits = BitsFor(most_group - least_group);
+        hints.Put(first_shared_number_, 32);
+        hints.Put(offsets[first_shared_number_], 32);
+        hints.Put(first_page_.size(), 32);
+        hints.Put(group_lengths.size(), 32);
+        hints.Put(0, 16);  // one object per group
+        hints.Put(least_group, 32);
+        hints.Put(group_bits, 16);
+        for (uint64_t length : group_lengths) hints.Put(length - least_group, group_bits);
+        hints.Align();
+        for (size_t i = 0; i < group_lengths.size(); ++i) hints.Put(0, 1);  // no MD5 signatures
+        hints.Align();
+
+        return std::to_string(hint_number_) + " 0 obj\n<</Length " + std::to_string(hints.data.size()) + "/S " +
+               std::to_string(shared_table_offset) + ">>\nstream\n" + hints.data + "\nendstream\nendobj\n";
+    }
+
+    void Build(std::string& out) {
+        // Every object but the hint stream, by new number
+        std::vector<std::string> bodies(last_number_ + 1);
+        for (size_t number = 1; number < objects_.size(); ++number) {
+            if (loaded_[number] && new_numbers_[number]) bodies[new_numbers_[number]] = Serialize((int)number);
+        }
+        std::vector<int> order;  // file order of the numbered objects
+        for (int number : document_) order.push_back(new_numbers_[number]);
+        order.push_back(hint_number_);
+        for (int number : first_page_) order.push_back(new_numbers_[number]);
+        for (int number = 1; number <= main_count_; ++number) order.push_back(number);
+
+        std::string header = "%PDF-" + (reader_.Version().empty() ? std::string("1.7") : reader_.Version()) +
+                             "\n%\xE2\xE3\xCF\xD3\n";
+        uint64_t linearization_length = LinearizationDictionary(0, 0, 0, 0, 0).size();
+        uint64_t first_xref_length = FirstPageXref(std::vector<uint64_t>(last_number_ + 1, 0), 0).size();
+
+        // Lay the file out with an empty hint stream, then with the real one
+        std::vector<uint64_t> offsets(last_number_ + 1, 0), lengths(last_number_ + 1, 0);
+        std::string hint_stream;
+        uint64_t first_page_end = 0, main_xref_offset = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            uint64_t pos = header.size();
+            offsets[linearization_number_] = pos;
+            pos += linearization_length + first_xref_length;
+            for (int number : order) {
+                offsets[number] = pos;
+                lengths[number] = number == hint_number_ ? hint_stream.size() : bodies[number].size();
+                pos += lengths[number];
+                if (number == new_numbers_[first_page_.back()]) first_page_end = pos;
+            }
+            main_xref_offset = pos;
+            if (pass == 0) hint_stream = HintStream(offsets, lengths);
+        }
+
+        std::string main_xref_head = "xref\n0 " + std::to_string(main_count_ + 1) + "\n";
+        std::string main_xref = main_xref_head + "0000000000 65535 f\r\n";
+        for (int number = 1; number <= main_count_; ++number) main_xref += XrefEntry(offsets[number]);
+        uint64_t first_xref_offset = header.size() + linearization_length;
+        main_xref += "trailer\n<</Size " + std::to_string(main_count_ + 1) + ">>\nstartxref\n" +
+                     std::to_string(first_xref_offset) + "\n%%EOF\n";
+        uint64_t file_length = main_xref_offset + main_xref.size();
+
+        out.reserve(out.size() + file_length);
+        out += header;
+        out += LinearizationDictionary(file_length, offsets[hint_number_], hint_stream.size(), first_page_end,
+                                       main_xref_offset + main_xref_head.size() - 1);
+        out += FirstPageXref(offsets, main_xref_offset);
+        for (int number : order) out += number == hint_number_ ? hint_stream : bodies[number];
+        out += main_xref;
+    }
+
+    PdfReader reader_;
+    std::vector<PdfIndirectObject> objects_;  // by original number
+    std::vector<bool> loaded_;
+    std::vector<Kind> kinds_;
+    std::vector<Section> sections_;
+    std::vector<int> marks_;
+    int root_ = 0;
+
+    std::vector<int> pages_;                      // page objects in page order
+    std::vector<std::vector<int>> page_objects_;  // everything each page uses, page object first
+    std::vector<int> document_;                   // part 4
+    std::vector<int> first_page_;                 // part 6
+    std::vector<std::vector<int>> other_pages_;   // part 7, by page
+    std::vector<int> shared_;                     // part 8
+    std::vector<int> rest_;                       // part 9
+
+    std::vector<int> new_numbers_;
+    int first_shared_number_ = 0;
+    int main_count_ = 0;
+    int linearization_number_ = 0;
+    int hint_number_ = 0;
+    int last_number_ = 0;
+};
+
+// Linearizes the PDF in `data`, appending the result to `out`.
+inline bool linearize_pdf(const uint8_t* data, size_t size, std::string& out) {
+    PdfLinearizer linearizer(data, size);
+    return linearizer.Write(out);
+}
+
+#endif  // PDF_COMBINER_PDF_LINEARIZER_H_
@@ -0,0 +1,190 @@
+#ifndef PDF_COMBINER_PDF_OBJECT_H_
+#define PDF_COMBINER_PDF_OBJECT_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A direct PDF object, as read by PdfReader and written by PdfWriter when the
+// plugin rewrites a file object by object instead of going through PDFium.
+//
+// References to indirect objects are kept as object numbers and never
+// resolved behind the caller's back, so a value is cheap to copy around and
+// an object graph can be walked one object at a time.
+struct PdfValue {
+    enum Type { kNull, kBoolean, kInteger, kReal, kString, kName, kArray, kDictionary, kReference };
+
+    Type type = kNull;
+    bool boolean = false;
+    int64_t integer = 0;   // integers, and the object number of references
+    int generation = 0;    // references only
+    std::string text;      // string bytes, names without the slash, reals as written
+    bool hex = false;      // strings written as <...>
+    std::vector<PdfValue> items;                            // arrays
+    std::vector<std::pair<std::string, PdfValue>> entries;  // dictionaries, in file order
+
+    static PdfValue Boolean(bool value) {
+        PdfValue result;
+        result.type = kBoolean;
+        result.boolean = value;
+        return result;
+    }
+
+    static PdfValue Integer(int64_t value) {
+        PdfValue result;
+        result.type = kInteger;
+        result.integer = value;
+        return result;
+    }
+
+    // PDF has no exponent notation, so reals are written with fixed decimals.
+    static PdfValue Real(double value) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.5f", value);
+        std::string text = buffer;
+        while (text.back() == '0') text.pop_back();
+        if (text.back() == '.') text.pop_back();
+        if (text == "-0") text = "0";
+        PdfValue result;
+        result.type = kReal;
+        result.text = text;
+        return result;
+    }
+
+    static PdfValue String(std::string bytes, bool hex = false) {
+        PdfValue result;
+        result.type = kString;
+        result.text = std::move(bytes);
+        result.hex = hex;
+        return result;
+    }
+
+    static PdfValue Name(std::string name) {
+        PdfValue result;
+        result.type = kName;
+        result.text = std::move(name);
+        return result;
+    }
+
+    static PdfValue Array() {
+        PdfValue result;
+        result.type = kArray;
+        return result;
+    }
+
+    static PdfValue Dictionary() {
+        PdfValue result;
+        result.type = kDictionary;
+        return result;
+    }
+
+    static PdfValue Reference(int64_t number, int generation = 0) {
+        PdfValue result;
+        result.type = kReference;
+        result.integer = number;
+        result.generation = generation;
+        return result;
+    }
+
+    bool IsDictionary() const { return type == kDictionary; }
+    bool IsReference() const { return type == kReference; }
+    bool IsName(const char* name) const { return type == kName && text == name; }
+    bool IsNumber() const { return type == kInteger || type == kReal; }
+
+    // The value of a number, truncated for reals
+    int64_t AsInteger(int64_t fallback = 0) const {
+        if (type == kInteger) return integer;
+        if (type == kReal) return (int64_t)atof(text.c_str());
+        return fallback;
+    }
+
+    double AsReal(double fallback = 0) const {
+        if (type == kInteger) return (double)integer;
+        if (type == kReal) return atof(text.c_str());
+        return fallback;
+    }
+
+    // Dictionary lookup, nullptr if the key is missing or this is no dictionary
+    const PdfValue* Find(const std::string& key) const {
+        for (const auto& entry : entries) {
+            if (entry.first == key) return &entry.second;
+        }
+        return nullptr;
+    }
+
+    PdfValue* Find(const std::string& key) {
+        for (auto& entry : entries) {
+            if (entry.first == key) return &entry.second;
+        }
+        return nullptr;
+    }
+
+    void Set(const std::string& key, PdfValue value) {
+        PdfValue* existing = Find(key);
+        if (existing) {
+            *existing = std::move(value);
+        } else {
+            entries.emplace_back(key, std::move(value));
+        }
+    }
+
+    void Erase(const std::string& key) {
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->first == key) {
+                entries.erase(it);
+                return;
+            }
+        }
+    }
+};
+
+// An indirect object: a numbered value, and for streams the stream data as
+// stored in the file (still encoded with the filters of its dictionary).
+struct PdfIndirectObject {
+    int number = 0;
+    int generation = 0;
+    PdfValue value;
+    bool has_stream = false;
+    std::string stream;
+};
+
+// Calls `visit(PdfValue&)` for every reference inside `value`, at any depth.
+// The visitor may rewrite the reference in place.
+template <typename Visitor>
+void for_each_reference(PdfValue& value, Visitor&& visit) {
+    switch (value.type) {
+        case PdfValue::kReference:
+            visit(value);
+            break;
+        case PdfValue::kArray:
+            for (PdfValue& item : value.items) for_each_reference(item, visit);
+            break;
+        case PdfValue::kDictionary:
+            for (auto& entry : value.entries) for_each_reference(entry.second, visit);
+            break;
+        default:
+            break;
+    }
+}
+
+template <typename Visitor>
+void for_each_reference(const PdfValue& value, Visitor&& visit) {
+    switch (value.type) {
+        case PdfValue::kReference:
+            visit(value);
+            break;
+        case PdfValue::kArray:
+            for (const PdfValue& item : value.items) for_each_reference(item, visit);
+            break;
+        case PdfValue::kDictionary:
+            for (const auto& entry : value.entries) for_each_reference(entry.second, visit);
+            break;
+        default:
+            break;
+    }
+}
+
+#endif  // PDF_COMBINER_PDF_OBJECT_H_
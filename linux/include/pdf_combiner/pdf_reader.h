@@ -0,0 +1,698 @@
+#ifndef PDF_COMBINER_PDF_READER_H_
+#define PDF_COMBINER_PDF_READER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "pdf_filters.h"
+#include "pdf_object.h"
+
+// Tokenizer and parser for PDF objects in a byte buffer.
+class PdfLexer {
+public:
+    enum { kMaxDepth = 256 };
+
+    PdfLexer(const uint8_t* data, size_t size, size_t pos = 0) : data_(data), size_(size), pos_(pos) {}
+
+    size_t Position() const { return pos_; }
+
+    static bool IsSpace(int c) { return c == 0 || c == 9 || c == 10 || c == 12 || c == 13 || c == 32; }
+    static bool IsDelimiter(int c) {
+        return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' || c == '{' || c == '}' ||
+               c == '/' || c == '%';
+    }
+    static bool IsRegular(int c) { return !IsSpace(c) && !IsDelimiter(c); }
+
+    // Skips white space and comments.
+    void SkipSpace() {
+        while (pos_ < size_) {
+            int c = data_[pos_];
+            if (IsSpace(c)) {
+                pos_++;
+            } else if (c == '%') {
+                while (pos_ < size_ && data_[pos_] != '\r' && data_[pos_] != '\n') pos_++;
+            } else {
+                break;
+            }
+        }
+    }
+
+    // Reads a run of regular characters, such as a keyword or a number.
+    std::string ReadToken() {
+        SkipSpace();
+        size_t start = pos_;
+        while (pos_ < size_ && IsRegular(data_[pos_])) pos_++;
+        return std::string((const char*)data_ + start, pos_ - start);
+    }
+
+    bool ReadKeyword(const char* keyword) {
+        size_t saved = pos_;
+        if (ReadToken() == keyword) return true;
+        pos_ = saved;
+        return false;
+    }
+
+    bool ReadInteger(int64_t& value) {
+        size_t saved = pos_;
+        std::string token = ReadToken();
+        if (!ParseInteger(token, value)) {
+            pos_ = saved;
+            return false;
+        }
+        return true;
+    }
+
+    bool ParseValue(PdfValue& value, int depth = 0) {
+        if (depth > kMaxDepth) return false;
+        SkipSpace();
+        if (pos_ >= size_) return false;
+        int c = data_[pos_];
+        if (c == '/') {
+            pos_++;
+            value = PdfValue::Name(ReadName());
+            return true;
+        }
+        if (c == '(') {
+            value = PdfValue::String(ReadLiteralString());
+            return true;
+        }
+        if (c == '<' && pos_ + 1 < size_ && data_[pos_ + 1] == '<') {
+            pos_ += 2;
+            value = PdfValue::Dictionary();
+            while (true) {
+                SkipSpace();
+                if (pos_ + 1 < size_ && data_[pos_] == '>' && data_[pos_ + 1] == '>') {
+                    pos_ += 2;
+                    return true;
+                }
+                if (pos_ >= size_ || data_[pos_] != '/') return false;
+                pos_++;
+                std::string key = ReadName();
+                PdfValue item;
+                if (!ParseValue(item, depth + 1)) return false;
+                value.entries.emplace_back(std::move(key), std::move(item));
+            }
+        }
+        if (c == '<') {
+            pos_++;
+            value = PdfValue::String(ReadHexString(), true);
+            return true;
+        }
+        if (c == '[') {
+            pos_++;
+            value = PdfValue::Array();
+            while (true) {
+                SkipSpace();
+                if (pos_ < size_ && data_[pos_] == ']') {
+                    pos_++;
+                    return true;
+                }
+                PdfValue item;
+                if (!ParseValue(item, depth + 1)) return false;
+                value.items.push_back(std::move(item));
+            }
+        }
+        if (!IsRegular(c)) return false;
+
+        std::string token = ReadToken();
+        int64_t number = 0;
+        if (ParseInteger(token, number)) {
+            // "12 0 R" is a reference
+            size_t saved = pos_;
+            int64_t generation = 0;
+            if (number >= 0 && ReadInteger(generation) && generation >= 0 && ReadKeyword("R")) {
+                value = PdfValue::Reference(number, (int)generation);
+                return true;
+            }
+            pos_ = saved;
+            value = PdfValue::Integer(number);
+            return true;
+        }
+        if (token.find_first_not_of("+-.0123456789") == std::string::npos) {
+            value = PdfValue();
+            value.type = PdfValue::kReal;
+            value.text = NormalizeReal(token);
+            return true;
+        }
+        if (token == "true" || token == "false") {
+            value = PdfValue::Boolean(token == "true");
+            return true;
+        }
+        if (token == "null") {
+            value = PdfValue();
+            return true;
+        }
+        pos_ -= token.size();
+        return false;
+    }
+
+    static bool ParseInteger(const std::string& token, int64_t& value) {
+        if (token.empty() || token.size() > 18) return false;
+        size_t i = (token[0] == '+' || token[0] == '-') ? 1 : 0;
+        if (i == token.size()) return false;
+        int64_t result = 0;
+        for (; i < token.size(); ++i) {
+            if (token[i] < '0' || token[i] > '9') return false;
+            result = result * 10 + (token[i] - '0');
+        }
+        value = token[0] == '-' ? -result : result;
+        return true;
+    }
+
+private:
+    // Reals such as "-.5" or "4." are kept as written, malformed ones such as
+    // "--3" or "1.2.3" are rewritten the way viewers read them.
+    static std::string NormalizeReal(const std::string& token) {
+        bool plain = token.find_first_of("0123456789") != std::string::npos &&
+                     token.find_first_of("+-", 1) == std::string::npos && token.find('.') == token.rfind('.');
+        if (plain) return token;
+        size_t start = token.find_first_not_of("+-");
+        double value = start == std::string::npos ? 0 : atof(token.c_str() + start);
+        if (token[0] == '-') value = -value;
+        return PdfValue::Real(value).text;
+    }
+
+    static int HexValue(int c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    std::string ReadName() {
+        std::string name;
+        while (pos_ < size_ && IsRegular(data_[pos_])) {
+            int c = data_[pos_++];
+            if (c == '#' && pos_ + 1 < size_ && HexValue(data_[pos_]) >= 0 && HexValue(data_[pos_ + 1]) >= 0) {
+                c = HexValue(data_[pos_]) * 16 + HexValue(data_[pos_ + 1]);
+                pos_ += 2;
+            }
+            name += (char)c;
+        }
+        return name;
+    }
+
+    std::string ReadLiteralString() {
+        std::string text;
+        int nesting = 1;
+        pos_++;  // skip the opening parenthesis
+        while (pos_ < size_) {
+            int c = data_[pos_++];
+            if (c == '\\') {
+                if (pos_ >= size_) break;
+                int e = data_[pos_++];
+                switch (e) {
+                    case 'n': text += '\n'; break;
+                    case 'r': text += '\r'; break;
+                    case 't': text += '\t'; break;
+                    case 'b': text += '\b'; break;
+                    case 'f': text += '\f'; break;
+                    case '\r':
+                        if (pos_ < size_ && data_[pos_] == '\n') pos_++;
+                        break;
+                    case '\n': break;
+                    default:
+                        if (e >= '0' && e <= '7') {
+                            int octal = e - '0';
+                            for (int i = 0; i < 2 && pos_ < size_ && data_[pos_] >= '0' && data_[pos_] <= '7'; ++i) {
+                                octal = octal * 8 + (data_[pos_++] - '0');
+                            }
+                            text += (char)octal;
+                        } else {
+                            text += (char)e;
+                        }
+                }
+            } else if (c == '(') {
+                nesting++;
+                text += (char)c;
+            } else if (c == ')') {
+                if (--nesting == 0) break;
+                text += (char)c;
+            } else {
+                text += (char)c;
+            }
+        }
+        return text;
+    }
+
+    std::string ReadHexString() {
+        std::string text;
+        int high = -1;
+        while (pos_ < size_) {
+            int c = data_[pos_++];
+            if (c == '>') break;
+            int digit = HexValue(c);
+            if (digit < 0) continue;
+            if (high < 0) {
+                high = digit;
+            } else {
+                text += (char)(high * 16 + digit);
+                high = -1;
+            }
+        }
+        if (high >= 0) text += (char)(high * 16);
+        return text;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_;
+};
+
+// Reads the objects of a PDF held in memory (a mapped file or a buffer),
+// one at a time, through its cross-reference tables or streams.
+//
+// Classic tables, cross-reference streams, hybrid files, incremental updates
+// and object streams are understood; a file whose cross-references are
+// broken is scanned for its objects instead. Encrypted files can be opened
+// but their strings and streams are returned as stored.
+class PdfReader {
+public:
+    PdfReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    PdfReader(const PdfReader&) = delete;
+    PdfReader& operator=(const PdfReader&) = delete;
+
+    // Reads the cross-references. False if this does not look like a PDF.
+    bool Open() {
+        const char* header = "%PDF-";
+        size_t limit = size_ < 1024 ? size_ : 1024;
+        const void* found = limit >= 5 ? memmem(data_, limit, header, 5) : nullptr;
+        if (!found) return false;
+        size_t header_pos = (const uint8_t*)found - data_;
+        version_ = std::string((const char*)data_ + header_pos + 5, std::min<size_t>(3, size_ - header_pos - 5));
+
+        if (!ReadCrossReferences() || !trailer_.Find("Root")) {
+            entries_.clear();
+            trailer_ = PdfValue::Dictionary();
+            Reconstruct();
+        }
+        const PdfValue* root = trailer_.Find("Root");
+        return root && root->IsReference();
+    }
+
+    // The version in the header, such as "1.7"
+    const std::string& Version() const { return version_; }
+
+    // The trailer dictionary (/Root, /Info, /ID, /Encrypt)
+    const PdfValue& Trailer() const { return trailer_; }
+
+    bool IsEncrypted() const { return trailer_.Find("Encrypt") != nullptr; }
+
+    // One more than the highest object number in use
+    int Size() const { return (int)entries_.size(); }
+
+    // Reads object `number`. Streams get a direct /Length matching their data.
+    // False if the object is free, missing or cannot be parsed.
+    bool ReadObject(int number, PdfIndirectObject& object) {
+        if (number <= 0 || number >= (int)entries_.size()) return false;
+        const XrefEntry& entry = entries_[number];
+        object = PdfIndirectObject();
+        if (entry.type == 1) {
+            if (!ReadObjectAt(entry.offset, object) || object.number != number) return false;
+            return true;
+        }
+        if (entry.type == 2) return ReadCompressedObject(number, entry, object);
+        return false;
+    }
+
+    // Whether object `number` is listed in use. A reference to any other
+    // object is a reference to null.
+    bool InUse(int number) const {
+        return number > 0 && number < (int)entries_.size() && entries_[number].type != 0;
+    }
+
+    // Follows `value` if it is a reference, otherwise returns it.
+    PdfValue Resolve(const PdfValue& value) {
+        if (!value.IsReference()) return value;
+        PdfIndirectObject object;
+        if (!ReadObject((int)value.integer, object)) return PdfValue();
+        return std::move(object.value);
+    }
+
+private:
+    struct XrefEntry {
+        uint8_t type = 0;     // 0 free or unknown, 1 in the file, 2 in an object stream
+        uint64_t offset = 0;  // file offset, or the object stream number
+        uint32_t index = 0;   // index in the object stream
+    };
+
+    struct ObjectStream {
+        std::string data;
+        std::vector<std::pair<int, size_t>> objects;  // number and offset in data
+    };
+
+    enum { kMaxObjects = 8 * 1000 * 1000, kCachedObjectStreams = 4 };
+
+    void SetEntry(int64_t number, const XrefEntry& entry) {
+        if (number <= 0 || number >= kMaxObjects) return;
+        if ((size_t)number >= entries_.size()) {
+            entries_.resize((size_t)number + 1);
+            known_.resize((size_t)number + 1, false);
+        }
+        // Sections are read newest first, and the newest entry wins
+        if (known_[number]) return;
+        known_[number] = true;
+        entries_[number] = entry;
+    }
+
+    void MergeTrailer(const PdfValue& section) {
+        static const char* const keys[] = {"Root", "Info", "ID", "Encrypt"};
+        for (const char* key : keys) {
+            const PdfValue* value = section.Find(key);
+            if (value && !trailer_.Find(key)) trailer_.Set(key, *value);
+        }
+    }
+
+    // The offset after the last "startxref", 0 if there is none
+    size_t FindStartXref() const {
+        const char* keyword = "startxref";
+        size_t last = 0;
+        size_t tail = size_ < 4096 ? size_ : 4096;
+        for (size_t pos = size_ - tail; pos + 9 <= size_; ) {
+            const void* found = memmem(data_ + pos, size_ - pos, keyword, 9);
+            if (!found) break;
+            size_t at = (const uint8_t*)found - data_;
+            PdfLexer lexer(data_, size_, at + 9);
+            int64_t offset = 0;
+            if (lexer.ReadInteger(offset) && offset >= 0 && (uint64_t)offset < size_) last = (size_t)offset;
+            pos = at + 9;
+        }
+        return last;
+    }
+
+    bool ReadCrossReferences() {
+        trailer_ = PdfValue::Dictionary();
+        size_t offset = FindStartXref();
+        if (offset == 0) return false;
+        std::set<size_t> visited;
+        while (visited.insert(offset).second) {
+            PdfValue section;
+            PdfLexer lexer(data_, size_, offset);
+            if (lexer.ReadKeyword("xref")) {
+                // A hybrid file marks the objects of its object streams free in
+                // the table and lists them in /XRefStm, so the free entries of
+                // the table come last
+                std::vector<int64_t> free_numbers;
+                if (!ReadXrefTable(lexer, section, free_numbers)) return false;
+                const PdfValue* stream_offset = section.Find("XRefStm");
+                PdfValue stream_section;
+                if (stream_offset && stream_offset->type == PdfValue::kInteger) {
+                    ReadXrefStream((size_t)stream_offset->integer, stream_section);
+                }
+                for (int64_t number : free_numbers) SetEntry(number, XrefEntry());
+            } else if (!ReadXrefStream(offset, section)) {
+                return false;
+            }
+            MergeTrailer(section);
+            const PdfValue* prev = section.Find("Prev");
+            if (!prev || !prev->IsNumber()) break;
+            int64_t prev_offset = prev->AsInteger();
+            if (prev_offset <= 0 || (uint64_t)prev_offset >= size_) break;
+            offset = (size_t)prev_offset;
+        }
+        return true;
+    }
+
+    // Reads an xref table and its trailer. The numbers of the free entries are
+    // added to `free_numbers` for the caller to set.
+    bool ReadXrefTable(PdfLexer& lexer, PdfValue& section, std::vector<int64_t>& free_numbers) {
+        while (true) {
+            if (lexer.ReadKeyword("trailer")) {
+                return lexer.ParseValue(section) && section.IsDictionary();
+            }
+            int64_t start = 0, count = 0;
+            if (!lexer.ReadInteger(start) || !lexer.ReadInteger(count)) return false;
+            if (start < 0 || count < 0 || start + count > kMaxObjects) return false;
+            for (int64_t i = 0; i < count; ++i) {
+                int64_t offset = 0, generation = 0;
+                if (!lexer.ReadInteger(offset) || !lexer.ReadInteger(generation)) return false;
+                std::string kind = lexer.ReadToken();
+                XrefEntry entry;
+                if (kind == "n" && offset > 0 && (uint64_t)offset < size_) {
+                    entry.type = 1;
+                    entry.offset = (uint64_t)offset;
+                } else if (kind == "f") {
+                    free_numbers.push_back(start + i);
+                    continue;
+                } else if (kind != "n") {
+                    return false;
+                }
+                SetEntry(start + i, entry);
+            }
+        }
+    }
+
+    bool ReadXrefStream(size_t offset, PdfValue& section) {
+        PdfIndirectObject object;
+        if (!ReadObjectAt(offset, object) || !object.has_stream || !object.value.IsDictionary()) return false;
+        const PdfValue& dict = object.value;
+        const PdfValue* widths = dict.Find("W");
+        const PdfValue* size = dict.Find("Size");
+        if (!widths || widths->type != PdfValue::kArray || widths->items.size() != 3 || !size) return false;
+        int w[3];
+        for (int i = 0; i < 3; ++i) {
+            w[i] = (int)widths->items[i].AsInteger(-1);
+            if (w[i] < 0 || w[i] > 8) return false;
+        }
+        std::string data;
+        if (!decode_stream(dict, object.stream, data)) return false;
+
+        std::vector<int64_t> index;
+        const PdfValue* index_value = dict.Find("Index");
+        if (index_value && index_value->type == PdfValue::kArray) {
+            for (const PdfValue& item : index_value->items) index.push_back(item.AsInteger());
+        } else {
+            index = {0, size->AsInteger()};
+        }
+
+        size_t row = (size_t)w[0] + w[1] + w[2];
+        if (row == 0) return false;
+        size_t pos = 0;
+        auto field = [&](int width, uint64_t fallback) {
+            if (width == 0) return fallback;
+            uint64_t value = 0;
+            for (int i = 0; i < width; ++i) value = (value << 8) | (uint8_t)data[pos++];
+            return value;
+        };
+        for (size_t i = 0; i + 1 < index.size(); i += 2) {
+            if (index[i] < 0 || index[i + 1] < 0 || index[i] + index[i + 1] > kMaxObjects) return false;
+            for (int64_t n = 0; n < index[i + 1] && pos + row <= data.size(); ++n) {
+                uint64_t type = field(w[0], 1);
+                uint64_t second = field(w[1], 0);
+                uint64_t third = field(w[2], 0);
+                XrefEntry entry;
+                if (type == 1 && second > 0 && second < size_) {
+                    entry.type = 1;
+                    entry.offset = second;
+                } else if (type == 2) {
+                    entry.type = 2;
+                    entry.offset = second;
+                    entry.index = (uint32_t)third;
+                }
+                SetEntry(index[i] + n, entry);
+            }
+        }
+        section = dict;
+        return true;
+    }
+
+    // Parses "N G obj ... endobj" at `offset`.
+    bool ReadObjectAt(size_t offset, PdfIndirectObject& object) {
+        PdfLexer lexer(data_, size_, offset);
+        int64_t number = 0, generation = 0;
+        if (!lexer.ReadInteger(number) || !lexer.ReadInteger(generation) || !lexer.ReadKeyword("obj")) return false;
+        object.number = (int)number;
+        object.generation = (int)generation;
+        if (!lexer.ParseValue(object.value)) return false;
+        if (!object.value.IsDictionary() || !lexer.ReadKeyword("stream")) return true;
+
+        // The data starts after the end of line following "stream"
+        size_t start = lexer.Position();
+        if (start < size_ && data_[start] == '\r') start++;
+        if (start < size_ && data_[start] == '\n') start++;
+
+        int64_t length = -1;
+        const PdfValue* length_value = object.value.Find("Length");
+        if (length_value && length_value->type == PdfValue::kInteger) {
+            length = length_value->integer;
+        } else if (length_value && length_value->IsReference() && length_value->integer != number &&
+                   resolving_length_ < 4) {
+            resolving_length_++;
+            length = Resolve(*length_value).AsInteger(-1);
+            resolving_length_--;
+        }
+        if (length < 0 || (uint64_t)length > size_ - start || !EndstreamFollows(start + (size_t)length)) {
+            length = FindStreamEnd(start);
+            if (length < 0) return false;
+        }
+        object.has_stream = true;
+        object.stream.assign((const char*)data_ + start, (size_t)length);
+        object.value.Set("Length", PdfValue::Integer(length));
+        return true;
+    }
+
+    bool EndstreamFollows(size_t pos) const {
+        PdfLexer lexer(data_, size_, pos);
+        return lexer.ReadKeyword("endstream");
+    }
+
+    // Length of stream data whose /Length is wrong: up to "endstream", without
+    // the end of line before it.
+    int64_t FindStreamEnd(size_t start) const {
+        const void* found = memmem(data_ + start, size_ - start, "endstream", 9);
+        if (!found) return -1;
+        size_t end = (const uint8_t*)found - data_;
+        if (end > start && data_[end - 1] == '\n') end--;
+        if (end > start && data_[end - 1] == '\r') end--;
+        return (int64_t)(end - start);
+    }
+
+    const ObjectStream* LoadObjectStream(int number) {
+        for (auto& cached : object_streams_) {
+            if (cached.first == number) return &cached.second;
+        }
+        PdfIndirectObject container;
+        if (number <= 0 || number >= (int)entries_.size() || entries_[number].type != 1 ||
+            !ReadObjectAt(entries_[number].offset, container) || !container.has_stream) {
+            return nullptr;
+        }
+        ObjectStream stream;
+        if (!decode_stream(container.value, container.stream, stream.data)) return nullptr;
+        const PdfValue* count = container.value.Find("N");
+        const PdfValue* first = container.value.Find("First");
+        if (!count || !first) return nullptr;
+        PdfLexer lexer((const uint8_t*)stream.data.data(), stream.data.size());
+        for (int64_t i = 0; i < count->AsInteger(); ++i) {
+            int64_t object_number = 0, offset = 0;
+            if (!lexer.ReadInteger(object_number) || !lexer.ReadInteger(offset)) break;
+            stream.objects.emplace_back((int)object_number, (size_t)(first->AsInteger() + offset));
+        }
+        if (object_streams_.size() >= kCachedObjectStreams) object_streams_.erase(object_streams_.begin());
+        object_streams_.emplace_back(number, std::move(stream));
+        return &object_streams_.back().second;
+    }
+
+    bool ReadCompressedObject(int number, const XrefEntry& entry, PdfIndirectObject& object) {
+        const ObjectStream* stream = LoadObjectStream((int)entry.offset);
+        if (!stream) return false;
+        size_t offset = SIZE_MAX;
+        if (entry.index < stream->objects.size() && stream->objects[entry.index].first == number) {
+            offset = stream->objects[entry.index].second;
+        } else {
+            for (const auto& item : stream->objects) {
+                if (item.first == number) offset = item.second;
+            }
+        }
+        if (offset >= stream->data.size()) return false;
+        PdfLexer lexer((const uint8_t*)stream->data.data(), stream->data.size(), offset);
+        object.number = number;
+        object.generation = 0;
+        return lexer.ParseValue(object.value);
+    }
+
+    // Rebuilds the cross-references of a damaged file by scanning it for
+    // "N G obj", and the trailer from the last "trailer" or the catalog.
+    void Reconstruct() {
+        std::vector<int> object_streams;
+        for (size_t pos = 0; pos + 3 <= size_;) {
+            const void* found = memmem(data_ + pos, size_ - pos, "obj", 3);
+            if (!found) break;
+            size_t at = (const uint8_t*)found - data_;
+            pos = at + 3;
+            if (pos < size_ && PdfLexer::IsRegular(data_[pos])) continue;
+            // Walk back over "N G "
+            size_t start = at;
+            int numbers = 0;
+            while (numbers < 2 && start > 0) {
+                size_t end = start;
+                while (start > 0 && PdfLexer::IsSpace(data_[start - 1])) start--;
+                if (start == end) break;
+                end = start;
+                while (start > 0 && data_[start - 1] >= '0' && data_[start - 1] <= '9') start--;
+                if (start == end) break;
+                numbers++;
+            }
+            if (numbers < 2 || (start > 0 && PdfLexer::IsRegular(data_[start - 1]))) continue;
+            PdfLexer lexer(data_, size_, start);
+            int64_t number = 0;
+            if (!lexer.ReadInteger(number) || number <= 0 || number >= kMaxObjects) continue;
+            if ((size_t)number >= entries_.size()) {
+                entries_.resize((size_t)number + 1);
+                known_.resize((size_t)number + 1, false);
+            }
+            entries_[number].type = 1;
+            entries_[number].offset = start;
+            known_[number] = true;
+        }
+
+        const uint8_t* last_trailer = nullptr;
+        for (size_t pos = 0; pos < size_;) {
+            const void* found = memmem(data_ + pos, size_ - pos, "trailer", 7);
+            if (!found) break;
+            last_trailer = (const uint8_t*)found;
+            pos = last_trailer - data_ + 7;
+        }
+        if (last_trailer) {
+            PdfLexer lexer(data_, size_, last_trailer - data_ + 7);
+            PdfValue dict;
+            if (lexer.ParseValue(dict) && dict.IsDictionary()) MergeTrailer(dict);
+        }
+
+        // Objects in object streams, and the catalog if the trailer is lost
+        for (int number = 1; number < (int)entries_.size(); ++number) {
+            if (entries_[number].type != 1) continue;
+            PdfIndirectObject object;
+            if (!ReadObjectAt(entries_[number].offset, object) || !object.value.IsDictionary()) continue;
+            const PdfValue* type = object.value.Find("Type");
+            if (type && type->IsName("ObjStm")) object_streams.push_back(number);
+            if (type && type->IsName("Catalog") && !trailer_.Find("Root")) {
+                trailer_.Set("Root", PdfValue::Reference(number));
+            }
+        }
+        for (int stream_number : object_streams) {
+            const ObjectStream* stream = LoadObjectStream(stream_number);
+            if (!stream) continue;
+            for (size_t i = 0; i < stream->objects.size(); ++i) {
+                int number = stream->objects[i].first;
+                if (number <= 0 || number >= kMaxObjects) continue;
+                if ((size_t)number >= entries_.size()) {
+                    entries_.resize((size_t)number + 1);
+                    known_.resize((size_t)number + 1, false);
+                }
+                if (entries_[number].type == 1) continue;
+                entries_[number].type = 2;
+                entries_[number].offset = (uint64_t)stream_number;
+                entries_[number].index = (uint32_t)i;
+            }
+        }
+        // The catalog may itself have been compressed
+        if (!trailer_.Find("Root")) {
+            for (int number = 1; number < (int)entries_.size(); ++number) {
+                if (entries_[number].type != 2) continue;
+                PdfIndirectObject object;
+                if (!ReadObject(number, object)) continue;
+                const PdfValue* type = object.value.Find("Type");
+                if (type && type->IsName("Catalog")) {
+                    trailer_.Set("Root", PdfValue::Reference(number));
+                    break;
+                }
+            }
+        }
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    std::string version_;
+    int resolving_length_ = 0;
+    PdfValue trailer_ = PdfValue::Dictionary();
+    std::vector<XrefEntry> entries_;
+    std::vector<bool> known_;
+    std::vector<std::pair<int, ObjectStream>> object_streams_;
+};
+
+#endif  // PDF_COMBINER_PDF_READER_H_
@@ -0,0 +1,283 @@
+#ifndef PDF_COMBINER_PDF_STREAM_MERGER_H_
+#define PDF_COMBINER_PDF_STREAM_MERGER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../pdfium/fpdf_save.h"
+#include "image_recompressor.h"
+#include "pdf_object.h"
+#include "pdf_reader.h"
+#include "pdf_writer.h"
+#include "progress_reporter.h"
+#include "sha256.h"
+
+// Merges PDFs without building the merged document in memory. Each selected
+// page is copied straight from its input with every object it uses, renumbered
+// and written to the output at once; only the page list and the offsets for
+// the final cross-reference table are kept until Finish().
+//
+//   PdfStreamMerger merger(&file_write);
+//   for each input: merger.OpenInput(data, size); merger.CopyPages(indices);
+//   merger.Finish();
+//
+// Objects shared by pages of the same input are written once; an input's
+// document-level objects (outlines, forms, names) are not copied, as with
+// FPDF_ImportPages. With `deduplicate` set, streams (font programs, images,
+// ICC profiles, forms) identical to one already written, references
+// included, are not written again and are shared across inputs instead.
+// With `images`, the image streams it has new JPEGs for are swapped as they
+// are copied.
+class PdfStreamMerger {
+public:
+    // With `compact`, the output uses object streams and a cross-reference
+    // stream (see PdfWriter).
+    explicit PdfStreamMerger(FPDF_FILEWRITE* sink, bool compact = false) : writer_(sink, compact) {
+        writer_.WriteHeader("1.7");
+        writer_.NewObjectNumber();  // kCatalogNumber
+        writer_.NewObjectNumber();  // kPagesNumber
+    }
+
+    PdfStreamMerger(const PdfStreamMerger&) = delete;
+    PdfStreamMerger& operator=(const PdfStreamMerger&) = delete;
+
+    // Advanced by one for each page copied, if set
+    ProgressReporter* progress = nullptr;
+
+    // Whether to share identical streams across inputs
+    bool deduplicate = false;
+
+    // Replaces the images it re-encoded, if set
+    ImageRecompressor* images = nullptr;
+
+    // Starts copying from the PDF in `data`, which must stay valid until the
+    // next OpenInput() or Finish(). Returns its page count, or -1 if it cannot
+    // be read here (not a PDF, encrypted, or no page found).
+    int OpenInput(const uint8_t* data, size_t size) {
+        numbers_.clear();
+        tree_objects_.clear();
+        pages_.clear();
+        reader_.reset(new PdfReader(data, size));
+        if (!reader_->Open() || reader_->IsEncrypted()) {
+            reader_.reset();
+            return -1;
+        }
+        int root = (int)reader_->Trailer().Find("Root")->integer;
+        tree_objects_.insert(root);
+        PdfIndirectObject catalog;
+        if (reader_->ReadObject(root, catalog)) {
+            const PdfValue* pages = catalog.value.Find("Pages");
+            if (pages && pages->IsReference()) WalkPageTree((int)pages->integer, PdfValue::Dictionary(), 0);
+        }
+        if (pages_.empty()) {
+            reader_.reset();
+            return -1;
+        }
+        return (int)pages_.size();
+    }
+
+    // Copies the pages at `indices` (0-based, in that order; all of them if
+    // empty) of the current input to the end of the output. Fails if an
+    // object they use cannot be read; none of the pages is added then, and
+    // the objects already written stay in the output unreferenced.
+    bool CopyPages(const std::vector<int>& indices) {
+        if (!reader_) return false;
+        std::vector<int> selection = indices;
+        if (selection.empty()) {
+            for (size_t i = 0; i < pages_.size(); ++i) selection.push_back((int)i);
+        }
+
+        // Number the selected pages first, so links between them survive
+        std::vector<int> numbers;
+        for (int index : selection) {
+            if (index < 0 || index >= (int)pages_.size()) return false;
+            numbers.push_back(writer_.NewObjectNumber());
+            numbers_.insert({pages_[index].number, numbers.back()});
+        }
+        size_t kid_count = kids_.size();
+        for (size_t i = 0; i < selection.size(); ++i) {
+            if (!CopyPage(pages_[selection[i]], numbers[i])) {
+                kids_.resize(kid_count);
+                return false;
+            }
+            if (progress) progress->Advance(1);
+        }
+        return writer_.ok();
+    }
+
+    // Writes the page tree, the catalog and the cross-reference table.
+    bool Finish() {
+        reader_.reset();
+        PdfIndirectObject pages;
+        pages.value = PdfValue::Dictionary();
+        pages.value.Set("Type", PdfValue::Name("Pages"));
+        PdfValue kids = PdfValue::Array();
+        for (int number : kids_) kids.items.push_back(PdfValue::Reference(number));
+        pages.value.Set("Kids", std::move(kids));
+        pages.value.Set("Count", PdfValue::Integer((int64_t)kids_.size()));
+        writer_.WriteObject(pages, kPagesNumber);
+
+        PdfIndirectObject catalog;
+        catalog.value = PdfValue::Dictionary();
+        catalog.value.Set("Type", PdfValue::Name("Catalog"));
+        catalog.value.Set("Pages", PdfValue::Reference(kPagesNumber));
+        writer_.WriteObject(catalog, kCatalogNumber);
+
+        PdfValue trailer = PdfValue::Dictionary();
+        trailer.Set("Root", PdfValue::Reference(kCatalogNumber));
+        return writer_.WriteXrefAndTrailer(std::move(trailer));
+    }
+
+    int PageCount() const { return (int)kids_.size(); }
+    uint64_t BytesWritten() const { return writer_.Offset(); }
+
+    // Streams not written because an identical one already was, and their size
+    int DuplicateCount() const { return duplicate_count_; }
+    uint64_t DuplicateBytes() const { return duplicate_bytes_; }
+
+private:
+    enum { kCatalogNumber = 1, kPagesNumber = 2 };
+
+    struct SourcePage {
+        int number;
+        PdfValue inherited;  // Resources, MediaBox, CropBox, Rotate from the page tree
+    };
+
+    void WalkPageTree(int number, PdfValue inherited, int depth) {
+        static const char* const kInheritable[] = {"Resources", "MediaBox", "CropBox", "Rotate"};
+        if (depth > 64 || tree_objects_.count(number)) return;
+        PdfIndirectObject node;
+        if (!reader_->ReadObject(number, node) || !node.value.IsDictionary()) return;
+        tree_objects_.insert(number);
+        const PdfValue* type = node.value.Find("Type");
+        const PdfValue* kids = node.value.Find("Kids");
+        if (!kids || (type && type->IsName("Page"))) {
+            pages_.push_back({number, std::move(inherited)});
+            return;
+        }
+        for (const char* key : kInheritable) {
+            const PdfValue* value = node.value.Find(key);
+            if (value) inherited.Set(key, *value);
+        }
+        if (kids->type != PdfValue::kArray) return;
+        for (const PdfValue& kid : kids->items) {
+            if (kid.IsReference()) WalkPageTree((int)kid.integer, inherited, depth + 1);
+        }
+    }
+
+    // An object being copied, with the references in it still to resolve
+    struct Frame {
+        int old_number = 0;
+        int number = 0;                 // set when the number is already in use
+        PdfValue* referrer = nullptr;   // the reference to this object in its parent
+        PdfIndirectObject object;
+        std::vector<PdfValue*> references;
+        size_t next = 0;
+    };
+
+    // Writes the page and everything it uses that is not in the output yet.
+    // Objects are written after the objects they use, so that a stream is
+    // complete, new references included, by the time it is compared with
+    // the ones already written; only references that form a cycle need a
+    // number before their object is written.
+    bool CopyPage(const SourcePage& page, int number) {
+        std::vector<std::unique_ptr<Frame>> stack;
+        std::unordered_map<int, size_t> open;  // objects on the stack
+        auto push = [&](int old_number, int fixed_number, PdfValue* referrer, PdfIndirectObject&& object) {
+            std::unique_ptr<Frame> frame(new Frame());
+            frame->old_number = old_number;
+            frame->number = fixed_number;
+            frame->referrer = referrer;
+            frame->object = std::move(object);
+            if (images) images->Replace(frame->object);
+            for_each_reference(frame->object.value, [&](PdfValue& ref) { frame->references.push_back(&ref); });
+            open[old_number] = stack.size();
+            stack.push_back(std::move(frame));
+        };
+
+        PdfIndirectObject object;
+        if (!reader_->ReadObject(page.number, object)) return false;
+        object.value.Erase("Parent");
+        for (const auto& entry : page.inherited.entries) {
+            if (!object.value.Find(entry.first)) object.value.Set(entry.first, entry.second);
+        }
+        push(page.number, number, nullptr, std::move(object));
+
+        while (!stack.empty()) {
+            Frame& frame = *stack.back();
+            if (frame.next < frame.references.size()) {
+                PdfValue* ref = frame.references[frame.next++];
+                int old_number = (int)ref->integer;
+                auto found = numbers_.find(old_number);
+                auto cycle = open.find(old_number);
+                if (found != numbers_.end()) {
+                    *ref = PdfValue::Reference(found->second);
+                } else if (cycle != open.end()) {
+                    Frame& target = *stack[cycle->second];
+                    target.number = writer_.NewObjectNumber();
+                    numbers_.insert({old_number, target.number});
+                    *ref = PdfValue::Reference(target.number);
+                } else if (tree_objects_.count(old_number) || !reader_->InUse(old_number)) {
+                    // Pages not copied, page tree nodes, the catalog and free objects
+                    *ref = PdfValue();
+                } else if (!reader_->ReadObject(old_number, object)) {
+                    return false;
+                } else {
+                    push(old_number, 0, ref, std::move(object));
+                }
+                continue;
+            }
+
+            if (stack.size() == 1) frame.object.value.Set("Parent", PdfValue::Reference(kPagesNumber));
+            int written = WriteCopiedObject(frame);
+            if (frame.referrer) *frame.referrer = PdfValue::Reference(written);
+            numbers_.insert({frame.old_number, written});
+            open.erase(frame.old_number);
+            stack.pop_back();
+        }
+        kids_.push_back(number);
+        return writer_.ok();
+    }
+
+    // Writes a copied object whose references have all been renumbered, or
+    // finds an identical stream already written. Returns its number.
+    int WriteCopiedObject(const Frame& frame) {
+        std::string digest;
+        if (deduplicate && frame.object.has_stream) {
+            Sha256 hash;
+            std::string dictionary;
+            serialize_pdf_value(frame.object.value, dictionary);
+            hash.Update(dictionary);
+            hash.Update(frame.object.stream);
+            digest = hash.Finish();
+            auto found = streams_.find(digest);
+            if (found != streams_.end() && !frame.number) {
+                duplicate_count_++;
+                duplicate_bytes_ += frame.object.stream.size();
+                return found->second;
+            }
+        }
+        int number = frame.number ? frame.number : writer_.NewObjectNumber();
+        writer_.WriteObject(frame.object, number);
+        if (!digest.empty()) streams_.insert({digest, number});
+        return number;
+    }
+
+    PdfWriter writer_;
+    std::vector<int> kids_;
+    std::unordered_map<std::string, int> streams_;  // SHA-256 of the streams written, when deduplicating
+    int duplicate_count_ = 0;
+    uint64_t duplicate_bytes_ = 0;
+
+    // The current input
+    std::unique_ptr<PdfReader> reader_;
+    std::vector<SourcePage> pages_;
+    std::unordered_set<int> tree_objects_;     // its catalog, page tree nodes and pages
+    std::unordered_map<int, int> numbers_;     // its object numbers to output ones
+};
+
+#endif  // PDF_COMBINER_PDF_STREAM_MERGER_H_
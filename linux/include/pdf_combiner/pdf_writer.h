@@ -0,0 +1,312 @@
+#ifndef PDF_COMBINER_PDF_WRITER_H_
+#define PDF_COMBINER_PDF_WRITER_H_
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../pdfium/fpdf_save.h"
+#include "pdf_filters.h"
+#include "pdf_object.h"
+
+// Appends the PDF syntax of `value` to `out`.
+inline void serialize_pdf_value(const PdfValue& value, std::string& out) {
+    static const char kHex[] = "0123456789ABCDEF";
+    char buffer[48];
+    switch (value.type) {
+        case PdfValue::kNull:
+            out += "null";
+            break;
+        case PdfValue::kBoolean:
+            out += value.boolean ? "true" : "false";
+            break;
+        case PdfValue::kInteger:
+            snprintf(buffer, sizeof(buffer), "%" PRId64, value.integer);
+            out += buffer;
+            break;
+        case PdfValue::kReal:
+            out += value.text;
+            break;
+        case PdfValue::kReference:
+            snprintf(buffer, sizeof(buffer), "%" PRId64 " %d R", value.integer, value.generation);
+            out += buffer;
+            break;
+        case PdfValue::kName:
+            out += '/';
+            for (unsigned char c : value.text) {
+                if (c <= 0x20 || c >= 0x7f || c == '#' || c == '(' || c == ')' || c == '<' || c == '>' ||
+                    c == '[' || c == ']' || c == '{' || c == '}' || c == '/' || c == '%') {
+                    out += '#';
+                    out += kHex[c >> 4];
+                    out += kHex[c & 15];
+                } else {
+                    out += (char)c;
+                }
+            }
+            break;
+        case PdfValue::kString:
+            if (value.hex) {
+                out += '<';
+                for (unsigned char c : value.text) {
+                    out += kHex[c >> 4];
+                    out += kHex[c & 15];
+                }
+                out += '>';
+            } else {
+                out += '(';
+                for (char c : value.text) {
+                    if (c == '(' || c == ')' || c == '\\') {
+                        out += '\\';
+                        out += c;
+                    } else if (c == '\r') {
+                        out += "\\r";
+                    } else {
+                        out += c;
+                    }
+                }
+                out += ')';
+            }
+            break;
+        case PdfValue::kArray:
+            out += '[';
+            for (size_t i = 0; i < value.items.size(); ++i) {
+                if (i > 0) out += ' ';
+                serialize_pdf_value(value.items[i], out);
+            }
+            out += ']';
+            break;
+        case PdfValue::kDictionary:
+            out += "<<";
+            for (const auto& entry : value.entries) {
+                serialize_pdf_value(PdfValue::Name(entry.first), out);
+                const PdfValue& item = entry.second;
+                bool delimited = item.type == PdfValue::kName || item.type == PdfValue::kString ||
+                                 item.type == PdfValue::kArray || item.type == PdfValue::kDictionary;
+                if (!delimited) out += ' ';
+                serialize_pdf_value(item, out);
+            }
+            out += ">>";
+            break;
+    }
+}
+
+// Appends "N G obj ... endobj" for `object` to `out`, numbered `number`. A
+// stream gets the /Length of its data, whatever its dictionary says.
+inline void serialize_pdf_object(const PdfIndirectObject& object, int number, std::string& out) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%d 0 obj\n", number);
+    out += buffer;
+    const PdfValue* length = object.value.Find("Length");
+    if (object.has_stream && !(length && length->type == PdfValue::kInteger &&
+                               length->integer == (int64_t)object.stream.size())) {
+        PdfValue value = object.value;
+        value.Set("Length", PdfValue::Integer((int64_t)object.stream.size()));
+        serialize_pdf_value(value, out);
+    } else {
+        serialize_pdf_value(object.value, out);
+    }
+    if (object.has_stream) {
+        out += "\nstream\n";
+        out += object.stream;
+        out += "\nendstream";
+    }
+    out += "\nendobj\n";
+}
+
+// Writes a PDF to an FPDF_FILEWRITE sink (MyFileWrite or MyMemoryWrite) one
+// object at a time, remembering where each one went for the final
+// cross-reference table. Object numbers are handed out by NewObjectNumber().
+//
+// A compact writer packs every object without a stream into Flate-compressed
+// object streams of up to kObjectsPerStream objects, and ends the file with a
+// compressed cross-reference stream instead of a table (PDF 1.5).
+class PdfWriter {
+public:
+    enum { kObjectsPerStream = 100 };
+
+    explicit PdfWriter(FPDF_FILEWRITE* sink, bool compact = false) : sink_(sink), compact_(compact) {}
+
+    PdfWriter(const PdfWriter&) = delete;
+    PdfWriter& operator=(const PdfWriter&) = delete;
+
+    bool ok() const { return ok_; }
+    uint64_t Offset() const { return offset_; }
+
+    // A number for an object not written yet
+    int NewObjectNumber() {
+        entries_.push_back(Entry());
+        return (int)entries_.size() - 1;
+    }
+
+    bool Write(const char* data, size_t size) {
+        if (!ok_ || size == 0) return ok_;
+        ok_ = sink_->WriteBlock(sink_, data, (unsigned long)size) != 0;
+        offset_ += size;
+        return ok_;
+    }
+
+    bool Write(const std::string& data) { return Write(data.data(), data.size()); }
+
+    // "%PDF-1.7" and a comment with high bytes, so the file counts as binary
+    bool WriteHeader(const std::string& version) {
+        return Write("%PDF-" + version + "\n%\xE2\xE3\xCF\xD3\n");
+    }
+
+    // Writes `object` as object `number`, from NewObjectNumber() (streams get
+    // their /Length). A compact writer may hold it back for an object stream.
+    bool WriteObject(const PdfIndirectObject& object, int number) {
+        if (number <= 0 || number >= (int)entries_.size()) return false;
+        if (compact_ && !object.has_stream) {
+            if (packed_numbers_.empty()) packed_stream_ = NewObjectNumber();
+            entries_[number].stream = packed_stream_;
+            entries_[number].offset = packed_numbers_.size();
+            packed_numbers_.push_back(number);
+            packed_offsets_.push_back(packed_.size());
+            serialize_pdf_value(object.value, packed_);
+            packed_ += '\n';
+            return packed_numbers_.size() < kObjectsPerStream || FlushObjectStream();
+        }
+        entries_[number].offset = offset_;
+        buffer_.clear();
+        serialize_pdf_object(object, number, buffer_);
+        return Write(buffer_);
+    }
+
+    // Writes the cross-reference table or stream of every object written so
+    // far, the trailer (its /Size is set here) and the end of the file.
+    bool WriteXrefAndTrailer(PdfValue trailer) {
+        if (compact_) return WriteXrefStream(std::move(trailer));
+        uint64_t xref_offset = offset_;
+        size_t size = entries_.size() > 0 ? entries_.size() : 1;
+        std::string table;
+        char line[64];
+        snprintf(line, sizeof(line), "xref\n0 %zu\n0000000000 65535 f\r\n", size);
+        table += line;
+        for (size_t i = 1; i < entries_.size(); ++i) {
+            if (entries_[i].offset) {
+                snprintf(line, sizeof(line), "%010" PRIu64 " 00000 n\r\n", entries_[i].offset);
+            } else {
+                snprintf(line, sizeof(line), "0000000000 00001 f\r\n");
+            }
+            table += line;
+        }
+        trailer.Set("Size", PdfValue::Integer((int64_t)size));
+        table += "trailer\n";
+        serialize_pdf_value(trailer, table);
+        snprintf(line, sizeof(line), "\nstartxref\n%" PRIu64 "\n%%%%EOF\n", xref_offset);
+        table += line;
+        return Write(table);
+    }
+
+private:
+    struct Entry {
+        uint64_t offset = 0;  // in the file, or the index in its object stream
+        int stream = 0;       // the object stream holding it, if any
+    };
+
+    // Writes the objects held back so far as one object stream.
+    bool FlushObjectStream() {
+        if (packed_numbers_.empty()) return ok_;
+        std::string data;
+        char pair[48];
+        for (size_t i = 0; i < packed_numbers_.size(); ++i) {
+            snprintf(pair, sizeof(pair), "%s%d %zu", i ? " " : "", packed_numbers_[i], packed_offsets_[i]);
+            data += pair;
+        }
+        data += '\n';
+        size_t first = data.size();
+        data += packed_;
+
+        PdfIndirectObject stream;
+        stream.has_stream = true;
+        stream.value = PdfValue::Dictionary();
+        stream.value.Set("Type", PdfValue::Name("ObjStm"));
+        stream.value.Set("N", PdfValue::Integer((int64_t)packed_numbers_.size()));
+        stream.value.Set("First", PdfValue::Integer((int64_t)first));
+        stream.value.Set("Filter", PdfValue::Name("FlateDecode"));
+        if (!deflate_bytes(data, 6, stream.stream)) return ok_ = false;
+        stream.value.Set("Length", PdfValue::Integer((int64_t)stream.stream.size()));
+        packed_numbers_.clear();
+        packed_offsets_.clear();
+        packed_.clear();
+        entries_[packed_stream_].offset = offset_;
+        buffer_.clear();
+        serialize_pdf_object(stream, packed_stream_, buffer_);
+        return Write(buffer_);
+    }
+
+    // Writes a cross-reference stream: one row of type, offset or object
+    // stream number, and generation or index per object, with the PNG Up
+    // predictor so that the mostly growing columns compress well.
+    bool WriteXrefStream(PdfValue trailer) {
+        if (!FlushObjectStream()) return false;
+        int number = NewObjectNumber();
+        entries_[number].offset = offset_;
+
+        uint64_t largest = 0;
+        for (const Entry& entry : entries_) largest = std::max<uint64_t>(largest, entry.stream ? entry.stream : entry.offset);
+        int width = 1;
+        while (width < 8 && (largest >> (8 * width)) != 0) width++;
+        size_t row_size = 1 + width + 2;
+        std::string rows;
+        std::string previous(row_size, '\0');
+        std::string row(row_size, '\0');
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            const Entry& entry = entries_[i];
+            uint64_t second = entry.stream ? (uint64_t)entry.stream : entry.offset;
+            uint64_t third = entry.stream ? entry.offset : (i == 0 ? 0xffff : 0);
+            row[0] = (char)(entry.stream ? 2 : (entry.offset ? 1 : 0));
+            for (int b = 0; b < width; ++b) row[1 + b] = (char)(second >> (8 * (width - 1 - b)));
+            row[1 + width] = (char)(third >> 8);
+            row[2 + width] = (char)third;
+            rows += '\x02';
+            for (size_t b = 0; b < row_size; ++b) rows += (char)(row[b] - previous[b]);
+            previous = row;
+        }
+
+        PdfIndirectObject xref;
+        xref.has_stream = true;
+        xref.value = PdfValue::Dictionary();
+        xref.value.Set("Type", PdfValue::Name("XRef"));
+        xref.value.Set("Size", PdfValue::Integer((int64_t)entries_.size()));
+        PdfValue widths = PdfValue::Array();
+        widths.items = {PdfValue::Integer(1), PdfValue::Integer(width), PdfValue::Integer(2)};
+        xref.value.Set("W", std::move(widths));
+        for (const auto& entry : trailer.entries) {
+            if (entry.first != "Size" && entry.first != "Prev") xref.value.Set(entry.first, entry.second);
+        }
+        xref.value.Set("Filter", PdfValue::Name("FlateDecode"));
+        PdfValue parameters = PdfValue::Dictionary();
+        parameters.Set("Predictor", PdfValue::Integer(12));
+        parameters.Set("Columns", PdfValue::Integer((int64_t)row_size));
+        xref.value.Set("DecodeParms", std::move(parameters));
+        if (!deflate_bytes(rows, 9, xref.stream)) return ok_ = false;
+        xref.value.Set("Length", PdfValue::Integer((int64_t)xref.stream.size()));
+
+        uint64_t xref_offset = offset_;
+        buffer_.clear();
+        serialize_pdf_object(xref, number, buffer_);
+        char line[48];
+        snprintf(line, sizeof(line), "\nstartxref\n%" PRIu64 "\n%%%%EOF\n", xref_offset);
+        buffer_ += line;
+        return Write(buffer_);
+    }
+
+    FPDF_FILEWRITE* sink_;
+    bool compact_;
+    uint64_t offset_ = 0;
+    bool ok_ = true;
+    std::vector<Entry> entries_ = std::vector<Entry>(1);
+    std::string buffer_;
+
+    // The object stream being filled by a compact writer
+    int packed_stream_ = 0;
+    std::vector<int> packed_numbers_;
+    std::vector<size_t> packed_offsets_;
+    std::string packed_;
+};
+
+#endif  // PDF_COMBINER_PDF_WRITER_H_
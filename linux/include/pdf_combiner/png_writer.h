@@ -0,0 +1,237 @@
+#ifndef PDF_COMBINER_PNG_WRITER_H_
+#define PDF_COMBINER_PNG_WRITER_H_
+
+#include <zlib.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "native_stats.h"
+
+// Streaming writer for 8-bit RGBA PNG files, fed one row at a time.
+//
+// The `compression` value of ImageCompression (0-100) selects the encoder
+// effort: zlib level 1 for 0 up to level 9 for 100. Below 50 every row uses
+// the Up filter, which is cheap and suits rendered pages; from 50 the filter
+// is chosen per row by the minimum sum of absolute differences, as libpng
+// does, for smaller files at a higher CPU cost.
+//
+// The PNG goes to a file, or is appended to a buffer in memory.
+class PngWriter {
+public:
+    PngWriter(const std::string& path, int width, int height, int compression)
+        : width_(width), height_(height) {
+        if (!Init(compression)) return;
+        file_ = fopen(path.c_str(), "wb");
+        if (file_) WriteHeader();
+    }
+
+    PngWriter(std::vector<uint8_t>* output, int width, int height, int compression)
+        : width_(width), height_(height), memory_(output) {
+        if (Init(compression)) WriteHeader();
+    }
+
+    ~PngWriter() {
+        if (stream_ready_) deflateEnd(&stream_);
+        if (file_) fclose(file_);
+    }
+
+    PngWriter(const PngWriter&) = delete;
+    PngWriter& operator=(const PngWriter&) = delete;
+
+    bool ok() const { return ok_; }
+
+    // Appends the next row, `width * 4` bytes of RGBA.
+    bool WriteRow(const uint8_t* rgba) {
+        if (!ok_ || rows_written_ >= height_) return false;
+        if (adaptive_filter_) {
+            uint64_t best_cost = UINT64_MAX;
+            for (uint8_t filter = 0; filter <= 4; ++filter) {
+                uint64_t cost = FilterRow(filter, rgba, candidate_.data());
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    filtered_.swap(candidate_);
+                }
+            }
+        } else {
+            FilterRow(2, rgba, filtered_.data());
+        }
+        memcpy(previous_.data(), rgba, row_size_);
+        rows_written_++;
+        return Deflate(filtered_.data(), filtered_.size(), Z_NO_FLUSH);
+    }
+
+    // Closes the file without completing it.
+    void Abort() {
+        if (file_) fclose(file_);
+        file_ = nullptr;
+        ok_ = false;
+    }
+
+    // Ends the image and closes the file. Every row must have been written.
+    bool Finish() {
+        if (!ok_ || rows_written_ != height_) return false;
+        ok_ = Deflate(nullptr, 0, Z_FINISH) && FlushIdat() && WriteChunk("IEND", nullptr, 0);
+        if (file_) ok_ = (fclose(file_) == 0) && ok_;
+        file_ = nullptr;
+        if (ok_) RecordStats();
+        return ok_;
+    }
+
+    uint64_t bytes_written() const { return bytes_written_; }
+    uint64_t encode_micros() const { return encode_micros_; }
+
+private:
+    static const size_t kChunkSize = 256 * 1024;
+
+    // Sets up the encoder, false if there is nothing to encode
+    bool Init(int compression) {
+        if (compression < 0) compression = 0;
+        if (compression > 100) compression = 100;
+        level_ = 1 + compression * 8 / 100;
+        adaptive_filter_ = compression >= 50;
+        start_ = std::chrono::steady_clock::now();
+
+        if (width_ <= 0 || height_ <= 0) return false;
+        row_size_ = (size_t)width_ * 4;
+        previous_.assign(row_size_, 0);
+        filtered_.resize(row_size_ + 1);
+        if (adaptive_filter_) candidate_.resize(row_size_ + 1);
+        out_.resize(kChunkSize);
+
+        memset(&stream_, 0, sizeof(stream_));
+        if (deflateInit(&stream_, level_) != Z_OK) return false;
+        stream_ready_ = true;
+        return true;
+    }
+
+    void WriteHeader() {
+        static const uint8_t kSignature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+        uint8_t header[13];
+        PutBigEndian(header, (uint32_t)width_);
+        PutBigEndian(header + 4, (uint32_t)height_);
+        header[8] = 8;   // bit depth
+        header[9] = 6;   // RGBA
+        header[10] = 0;  // deflate
+        header[11] = 0;  // adaptive filtering
+        header[12] = 0;  // no interlace
+        ok_ = Write(kSignature, sizeof(kSignature)) && WriteChunk("IHDR", header, sizeof(header));
+    }
+
+    static void PutBigEndian(uint8_t* out, uint32_t value) {
+        out[0] = (uint8_t)(value >> 24);
+        out[1] = (uint8_t)(value >> 16);
+        out[2] = (uint8_t)(value >> 8);
+        out[3] = (uint8_t)value;
+    }
+
+    static uint8_t Paeth(int a, int b, int c) {
+        int p = a + b - c;
+        int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+        if (pa <= pb && pa <= pc) return (uint8_t)a;
+        return (uint8_t)(pb <= pc ? b : c);
+    }
+
+    // Writes the filter byte and the filtered row to `out`, returns the sum of
+    // the absolute values of the filtered bytes (the adaptive heuristic).
+    uint64_t FilterRow(uint8_t filter, const uint8_t* row, uint8_t* out) const {
+        const uint8_t* up = previous_.data();
+        out[0] = filter;
+        uint8_t* dst = out + 1;
+        uint64_t cost = 0;
+        for (size_t i = 0; i < row_size_; ++i) {
+            int left = i >= 4 ? row[i - 4] : 0;
+            int upper_left = i >= 4 ? up[i - 4] : 0;
+            uint8_t value;
+            switch (filter) {
+                case 1: value = (uint8_t)(row[i] - left); break;
+                case 2: value = (uint8_t)(row[i] - up[i]); break;
+                case 3: value = (uint8_t)(row[i] - ((left + up[i]) >> 1)); break;
+                case 4: value = (uint8_t)(row[i] - Paeth(left, up[i], upper_left)); break;
+                default: value = row[i]; break;
+            }
+            dst[i] = value;
+            cost += value < 128 ? value : 256 - value;
+        }
+        return cost;
+    }
+
+    bool Deflate(const uint8_t* data, size_t size, int flush) {
+        stream_.next_in = const_cast<Bytef*>(data);
+        stream_.avail_in = (uInt)size;
+        do {
+            stream_.next_out = out_.data() + out_used_;
+            stream_.avail_out = (uInt)(out_.size() - out_used_);
+            int status = deflate(&stream_, flush);
+            if (status == Z_STREAM_ERROR) return false;
+            out_used_ = out_.size() - stream_.avail_out;
+            if (out_used_ == out_.size() && !FlushIdat()) return false;
+            if (status == Z_STREAM_END) break;
+        } while (stream_.avail_in > 0 || (flush == Z_FINISH) || stream_.avail_out == 0);
+        return true;
+    }
+
+    bool FlushIdat() {
+        if (out_used_ == 0) return true;
+        bool written = WriteChunk("IDAT", out_.data(), out_used_);
+        out_used_ = 0;
+        return written;
+    }
+
+    bool WriteChunk(const char* type, const uint8_t* data, size_t size) {
+        uint8_t length[4];
+        PutBigEndian(length, (uint32_t)size);
+        uLong crc = crc32(0L, reinterpret_cast<const Bytef*>(type), 4);
+        if (size > 0) crc = crc32(crc, data, (uInt)size);
+        uint8_t crc_bytes[4];
+        PutBigEndian(crc_bytes, (uint32_t)crc);
+        return Write(length, 4) && Write(type, 4) && (size == 0 || Write(data, size)) && Write(crc_bytes, 4);
+    }
+
+    bool Write(const void* data, size_t size) {
+        if (memory_) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            memory_->insert(memory_->end(), bytes, bytes + size);
+        } else if (fwrite(data, 1, size, file_) != size) {
+            return false;
+        }
+        bytes_written_ += size;
+        return true;
+    }
+
+    void RecordStats() {
+        encode_micros_ = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start_).count();
+        NativeStats& stats = native_stats();
+        stats.png_images++;
+        stats.png_bytes += bytes_written_;
+        stats.png_encode_micros += encode_micros_;
+    }
+
+    int width_;
+    int height_;
+    int level_ = 1;
+    bool adaptive_filter_ = false;
+    size_t row_size_ = 0;
+    std::vector<uint8_t> previous_;
+    std::vector<uint8_t> filtered_;
+    std::vector<uint8_t> candidate_;
+    std::vector<uint8_t> out_;
+    size_t out_used_ = 0;
+    z_stream stream_;
+    bool stream_ready_ = false;
+    FILE* file_ = nullptr;
+    std::vector<uint8_t>* memory_ = nullptr;  // written to instead of file_ when set
+    bool ok_ = false;
+    int rows_written_ = 0;
+    uint64_t bytes_written_ = 0;
+    uint64_t encode_micros_ = 0;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#endif  // PDF_COMBINER_PNG_WRITER_H_
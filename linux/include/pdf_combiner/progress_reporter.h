@@ -0,0 +1,119 @@
+#ifndef PDF_COMBINER_PROGRESS_REPORTER_H_
+#define PDF_COMBINER_PROGRESS_REPORTER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Progress of a running method call, sent on the pdf_combiner/progress event
+// channel.
+struct ProgressEvent {
+    std::string method;
+    std::string job_id;  // empty when the call has no jobId
+    int documents_done = 0;
+    int document_count = 0;
+    int pages_done = 0;
+    int total_pages = 0;
+    uint64_t bytes_written = 0;
+    uint64_t elapsed_micros = 0;
+    bool finished = false;
+};
+
+typedef std::function<void(const ProgressEvent&)> ProgressListener;
+
+// Holds the listener installed by the plugin while Dart listens to the event
+// channel. Without one, reporting progress costs a few counter updates.
+class ProgressHub {
+public:
+    void SetListener(ProgressListener listener) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        listener_ = std::move(listener);
+    }
+
+    ProgressListener Listener() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return listener_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    ProgressListener listener_;
+};
+
+inline ProgressHub& progress_hub() {
+    static ProgressHub hub;
+    return hub;
+}
+
+// Counts the work done by one method call and forwards it to a listener at
+// most every kIntervalMillis, so a render of thousands of small pages does
+// not flood the channel. The last event, sent when the reporter is destroyed,
+// is never throttled and has `finished` set.
+//
+// Pages may complete on encoder threads, so every method is thread-safe.
+class ProgressReporter {
+public:
+    enum { kIntervalMillis = 100 };
+
+    ProgressReporter(const char* method, const std::string& job_id, int document_count, ProgressListener listener)
+        : listener_(std::move(listener)), start_(std::chrono::steady_clock::now()), last_sent_(start_) {
+        event_.method = method;
+        event_.job_id = job_id;
+        event_.document_count = document_count;
+    }
+
+    ~ProgressReporter() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.finished = true;
+        Send(std::chrono::steady_clock::now());
+    }
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    // Adds pages to the total, as inputs are opened.
+    void AddPages(int pages) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.total_pages += pages;
+        MaybeSend();
+    }
+
+    // Records finished pages and the output bytes they produced.
+    void Advance(int pages, uint64_t bytes = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.pages_done += pages;
+        event_.bytes_written += bytes;
+        MaybeSend();
+    }
+
+    void DocumentDone() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        event_.documents_done++;
+        MaybeSend();
+    }
+
+private:
+    void MaybeSend() {
+        if (!listener_) return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_sent_ < std::chrono::milliseconds(kIntervalMillis)) return;
+        Send(now);
+    }
+
+    void Send(std::chrono::steady_clock::time_point now) {
+        if (!listener_) return;
+        last_sent_ = now;
+        event_.elapsed_micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+        listener_(event_);
+    }
+
+    const ProgressListener listener_;
+    const std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point last_sent_;
+    std::mutex mutex_;
+    ProgressEvent event_;
+};
+
+#endif  // PDF_COMBINER_PROGRESS_REPORTER_H_
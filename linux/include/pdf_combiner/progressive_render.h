@@ -0,0 +1,40 @@
+#ifndef PDF_COMBINER_PROGRESSIVE_RENDER_H_
+#define PDF_COMBINER_PROGRESSIVE_RENDER_H_
+
+#include <atomic>
+
+#include "../pdfium/fpdf_progressive.h"
+#include "../pdfium/fpdfview.h"
+
+// IFSDK_PAUSE that asks PDFium to stop once the job is cancelled.
+struct CancelPause : public IFSDK_PAUSE {
+    explicit CancelPause(const std::atomic<bool>* cancelled) : cancelled(cancelled) {
+        version = 1;
+        NeedToPauseNow = CheckCancelled;
+        user = nullptr;
+    }
+
+    static FPDF_BOOL CheckCancelled(IFSDK_PAUSE* pause) {
+        const std::atomic<bool>* flag = static_cast<CancelPause*>(pause)->cancelled;
+        return flag && flag->load() ? 1 : 0;
+    }
+
+    const std::atomic<bool>* cancelled;
+};
+
+// Renders a page like FPDF_RenderPageBitmap, but through the progressive API
+// so a cancelled job stops in the middle of a page. `cancelled` may be null.
+// Returns false if the rendering was cancelled or failed.
+inline bool render_page_progressive(FPDF_BITMAP bitmap, FPDF_PAGE page, int start_x, int start_y, int size_x, int size_y,
+                                    int flags, const std::atomic<bool>* cancelled) {
+    CancelPause pause(cancelled);
+    int status = FPDF_RenderPageBitmapWithColorScheme_Start(bitmap, page, start_x, start_y, size_x, size_y, 0, flags,
+                                                            nullptr, &pause);
+    while (status == FPDF_RENDER_TOBECONTINUED && !CancelPause::CheckCancelled(&pause)) {
+        status = FPDF_RenderPage_Continue(page, &pause);
+    }
+    FPDF_RenderPage_Close(page);
+    return status == FPDF_RENDER_DONE;
+}
+
+#endif  // PDF_COMBINER_PROGRESSIVE_RENDER_H_
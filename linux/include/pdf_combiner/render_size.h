@@ -0,0 +1,86 @@
+#ifndef PDF_COMBINER_RENDER_SIZE_H_
+#define PDF_COMBINER_RENDER_SIZE_H_
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+// How large pages are rendered, in pixels.
+//
+// A page is `scale` pixels per point (a dpi of 72 * scale), then shrunk,
+// keeping its aspect ratio, until it fits `max_width` x `max_height` and has
+// at most `max_pixels` pixels; a zero limit is no limit. A `fixed_width` or
+// `fixed_height` replaces all of that: with both the page is stretched to
+// them, with one the other follows the aspect ratio.
+struct RenderSize {
+    double scale = 1;
+    int fixed_width = 0;
+    int fixed_height = 0;
+    int max_width = 0;
+    int max_height = 0;
+    int64_t max_pixels = 0;
+
+    // The size of a page of `width` x `height` points; false if the page is
+    // empty or the bitmap would be wider than PDFium can address.
+    bool PageSize(double width, double height, int& out_width, int& out_height) const {
+        if (!(width > 0 && height > 0)) return false;
+        double pixel_width, pixel_height;
+        if (fixed_width > 0 || fixed_height > 0) {
+            pixel_width = fixed_width > 0 ? fixed_width : fixed_height * width / height;
+            pixel_height = fixed_height > 0 ? fixed_height : fixed_width * height / width;
+        } else {
+            pixel_width = width * scale;
+            pixel_height = height * scale;
+            double fit = 1;
+            if (max_width > 0) fit = std::min(fit, max_width / pixel_width);
+            if (max_height > 0) fit = std::min(fit, max_height / pixel_height);
+            if (max_pixels > 0) fit = std::min(fit, std::sqrt(max_pixels / (pixel_width * pixel_height)));
+            pixel_width *= fit;
+            pixel_height *= fit;
+        }
+        // Round down so the limits hold
+        pixel_width = std::max(1.0, std::floor(pixel_width + 1e-6));
+        pixel_height = std::max(1.0, std::floor(pixel_height + 1e-6));
+        if (pixel_width > INT_MAX / 4 || pixel_height > INT_MAX) return false;
+        out_width = (int)pixel_width;
+        out_height = (int)pixel_height;
+        return true;
+    }
+};
+
+// Memory the system can give without swapping: MemAvailable from
+// /proc/meminfo, or the free pages where it is missing.
+inline uint64_t available_memory() {
+    uint64_t bytes = 0;
+    if (FILE* meminfo = fopen("/proc/meminfo", "r")) {
+        char line[128];
+        unsigned long long kb;
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "MemAvailable: %llu kB", &kb) == 1) {
+                bytes = (uint64_t)kb * 1024;
+                break;
+            }
+        }
+        fclose(meminfo);
+    }
+    if (bytes == 0) {
+        long pages = sysconf(_SC_AVPHYS_PAGES);
+        long page_size = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && page_size > 0) bytes = (uint64_t)pages * page_size;
+    }
+    return bytes;
+}
+
+// Whether `count` BGRA bitmaps of `width` x `height` fit in `available`
+// bytes of memory, checked before allocating them; an unknown (zero)
+// amount of memory does not limit them.
+inline bool bitmaps_fit_in_memory(int width, int height, size_t count, uint64_t available) {
+    uint64_t bytes = (uint64_t)width * height * 4 * count;
+    return available == 0 || bytes <= available;
+}
+
+#endif  // PDF_COMBINER_RENDER_SIZE_H_
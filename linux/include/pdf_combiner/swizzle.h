@@ -0,0 +1,124 @@
+#ifndef PDF_COMBINER_SWIZZLE_H_
+#define PDF_COMBINER_SWIZZLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PDF_COMBINER_SWIZZLE_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#define PDF_COMBINER_SWIZZLE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Swaps the first and third byte of every 4-byte pixel, which converts
+// between PDFium's BGRA/BGRx and the RGBA used by stb.
+//
+// The row kernel is picked once at runtime: AVX2 or SSSE3 on x86 (built with
+// target attributes, so the plugin itself needs no -mavx2), NEON on ARM, and
+// a portable fallback otherwise.
+
+typedef void (*SwizzleRowFunction)(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+inline void swizzle_row_scalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint8_t r = src[0];
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = r;
+        dst[3] = src[3];
+        src += 4;
+        dst += 4;
+    }
+}
+
+#ifdef PDF_COMBINER_SWIZZLE_X86
+__attribute__((target("ssse3")))
+inline void swizzle_row_ssse3(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, mask));
+    }
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+__attribute__((target("avx2")))
+inline void swizzle_row_avx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4 + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4 + 32), _mm256_shuffle_epi8(b, mask));
+    }
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(a, mask));
+    }
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+#endif
+
+#ifdef PDF_COMBINER_SWIZZLE_NEON
+inline void swizzle_row_neon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t r = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = r;
+        vst4q_u8(dst + i * 4, v);
+    }
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+#endif
+
+// Best row kernel for this CPU, detected on first use.
+inline SwizzleRowFunction swizzle_row_function() {
+    static const SwizzleRowFunction function = [] {
+#ifdef PDF_COMBINER_SWIZZLE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return &swizzle_row_avx2;
+        if (__builtin_cpu_supports("ssse3")) return &swizzle_row_ssse3;
+        return &swizzle_row_scalar;
+#elif defined(PDF_COMBINER_SWIZZLE_NEON)
+        return &swizzle_row_neon;
+#else
+        return &swizzle_row_scalar;
+#endif
+    }();
+    return function;
+}
+
+// Name of the kernel in use, for diagnostics.
+inline const char* swizzle_kernel_name() {
+    SwizzleRowFunction function = swizzle_row_function();
+#ifdef PDF_COMBINER_SWIZZLE_X86
+    if (function == &swizzle_row_avx2) return "avx2";
+    if (function == &swizzle_row_ssse3) return "ssse3";
+#elif defined(PDF_COMBINER_SWIZZLE_NEON)
+    if (function == &swizzle_row_neon) return "neon";
+#endif
+    return "scalar";
+}
+
+// Converts a whole image, optionally flipping it vertically in the same pass.
+// Strides are in bytes; `src` and `dst` may be the same buffer when not
+// flipping.
+inline void swizzle_rgba_bgra(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                              int width, int height, bool flip_vertically) {
+    if (width <= 0 || height <= 0) return;
+    SwizzleRowFunction swizzle_row = swizzle_row_function();
+    for (int y = 0; y < height; y++) {
+        int dst_y = flip_vertically ? height - 1 - y : y;
+        swizzle_row(src + (size_t)y * src_stride, dst + (size_t)dst_y * dst_stride, (size_t)width);
+    }
+}
+
+#endif  // PDF_COMBINER_SWIZZLE_H_
@@ -0,0 +1,84 @@
+#ifndef PDF_COMBINER_WORKER_POOL_H_
+#define PDF_COMBINER_WORKER_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+
+// PDFium keeps global state and is not thread-safe, even across different
+// documents. Every call into PDFium must happen while holding this lock.
+inline std::mutex& pdfium_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// Number of helper threads worth starting for `item_count` independent items
+// while the calling thread keeps one core busy with PDFium.
+inline size_t background_worker_count(size_t item_count) {
+    size_t cores = std::thread::hardware_concurrency();
+    size_t count = cores > 1 ? cores - 1 : 1;
+    return std::max<size_t>(1, std::min<size_t>({count, item_count, 8}));
+}
+
+// Fixed-size pool of threads fed by a bounded job queue.
+//
+// Method calls are executed here so that long merges and renders never block
+// the GTK main loop. Submit() refuses new work when the queue is full instead
+// of growing without limit.
+class WorkerPool {
+public:
+    typedef std::function<void()> Job;
+
+    WorkerPool(size_t worker_count, size_t queue_capacity) : queue_(queue_capacity) {
+        if (worker_count == 0) worker_count = 1;
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers_.emplace_back([this] { Run(); });
+        }
+    }
+
+    ~WorkerPool() { Shutdown(); }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Queues a job. Returns false if the queue is full or the pool is stopped.
+    bool Submit(Job job) { return queue_.TryPush(std::move(job)); }
+
+    // Drops the jobs that have not started yet and waits for the running ones.
+    void Shutdown() {
+        queue_.Close();
+        queue_.Clear();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) worker.join();
+        }
+        workers_.clear();
+    }
+
+    size_t QueueDepth() const { return queue_.Size(); }
+    size_t QueueCapacity() const { return queue_.Capacity(); }
+    size_t RunningJobs() const { return running_.load(); }
+    size_t WorkerCount() const { return workers_.size(); }
+
+private:
+    void Run() {
+        Job job;
+        while (queue_.Pop(job)) {
+            running_++;
+            job();
+            job = nullptr;
+            running_--;
+        }
+    }
+
+    BoundedQueue<Job> queue_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> running_{0};
+};
+
+#endif  // PDF_COMBINER_WORKER_POOL_H_
@@ -4,7 +4,10 @@
 #include <gtk/gtk.h>
 #include <sys/utsname.h>
 
+#include <algorithm>
+#include <climits>
 #include <cstring>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -15,8 +18,26 @@
 #include "include/pdfium/fpdf_save.h"
 #include "include/pdfium/fpdf_ppo.h"
 
+#include "include/pdf_combiner/document_cache.h"
+#include "include/pdf_combiner/embedded_thumbnail.h"
+#include "include/pdf_combiner/image_recompressor.h"
+#include "include/pdf_combiner/image_writer.h"
+#include "include/pdf_combiner/job_registry.h"
+#include "include/pdf_combiner/mapped_file.h"
 #include "include/pdf_combiner/my_file_write.h"
-#include "include/pdf_combiner/save_bitmap_to_png.h"
+#include "include/pdf_combiner/native_stats.h"
+#include "include/pdf_combiner/ordered_pipeline.h"
+#include "include/pdf_combiner/page_encoder.h"
+#include "include/pdf_combiner/page_range.h"
+#include "include/pdf_combiner/pdf_compactor.h"
+#include "include/pdf_combiner/pdf_linearizer.h"
+#include "include/pdf_combiner/pdf_stream_merger.h"
+#include "include/pdf_combiner/progress_reporter.h"
+#include "include/pdf_combiner/progressive_render.h"
+#include "include/pdf_combiner/render_size.h"
+#include "include/pdf_combiner/stb_image.h"
+#include "include/pdf_combiner/swizzle.h"
+#include "include/pdf_combiner/worker_pool.h"
 #include <cstdio>
 
 #ifdef HAS_HEIF
@@ -27,61 +48,325 @@
   (G_TYPE_CHECK_INSTANCE_CAST((obj), pdf_combiner_plugin_get_type(), \
                               PdfCombinerPlugin))
 
+// Jobs running at the same time. PDFium work is serialized by pdfium_mutex(),
+// so a second worker only picks up the next job while the first finishes.
+static const size_t kWorkerCount = 2;
+
+// Method calls waiting for a worker before new ones are rejected.
+static const size_t kQueueCapacity = 64;
+
 struct _PdfCombinerPlugin {
   GObject parent_instance;
+  WorkerPool* worker_pool;
+  DocumentCache* document_cache;
+  FlEventChannel* progress_channel;
 };
 
 G_DEFINE_TYPE(PdfCombinerPlugin, pdf_combiner_plugin, g_object_get_type())
 
-// Called when a method call is received from Flutter.
-static void pdf_combiner_plugin_handle_method_call( PdfCombinerPlugin* self, FlMethodCall* method_call) {
-  g_autoptr(FlMethodResponse) response = nullptr;
+typedef FlMethodResponse* (*MethodHandler)(FlValue* args);
 
-  const gchar* method = fl_method_call_get_name(method_call);
+// Response produced on a worker thread, waiting to be sent on the main loop.
+typedef struct {
+  FlMethodCall* method_call;
+  FlMethodResponse* response;
+} PendingResponse;
+
+// Progress event produced on a worker thread, waiting to be sent on the main loop.
+typedef struct {
+  FlEventChannel* channel;
+  FlValue* event;
+} PendingProgress;
+
+static gboolean send_progress_on_main_loop(gpointer user_data) {
+  PendingProgress* pending = static_cast<PendingProgress*>(user_data);
+  fl_event_channel_send(pending->channel, pending->event, nullptr, nullptr);
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_progress_free(gpointer user_data) {
+  PendingProgress* pending = static_cast<PendingProgress*>(user_data);
+  fl_value_unref(pending->event);
+  g_object_unref(pending->channel);
+  g_free(pending);
+}
+
+static FlValue* progress_event_to_value(const ProgressEvent& event) {
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "method", fl_value_new_string(event.method.c_str()));
+  if (!event.job_id.empty()) fl_value_set_string_take(value, "jobId", fl_value_new_string(event.job_id.c_str()));
+  fl_value_set_string_take(value, "documentsDone", fl_value_new_int(event.documents_done));
+  fl_value_set_string_take(value, "documentCount", fl_value_new_int(event.document_count));
+  fl_value_set_string_take(value, "pagesDone", fl_value_new_int(event.pages_done));
+  fl_value_set_string_take(value, "totalPages", fl_value_new_int(event.total_pages));
+  fl_value_set_string_take(value, "bytesWritten", fl_value_new_int((int64_t)event.bytes_written));
+  fl_value_set_string_take(value, "elapsedMicros", fl_value_new_int((int64_t)event.elapsed_micros));
+  fl_value_set_string_take(value, "finished", fl_value_new_bool(event.finished));
+  return value;
+}
+
+// Dart started listening: forward the progress of every job from now on.
+static FlMethodErrorResponse* progress_listen_cb(FlEventChannel* channel, FlValue* args, gpointer user_data) {
+  progress_hub().SetListener([channel](const ProgressEvent& event) {
+    PendingProgress* pending = g_new0(PendingProgress, 1);
+    pending->channel = FL_EVENT_CHANNEL(g_object_ref(channel));
+    pending->event = progress_event_to_value(event);
+    g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, send_progress_on_main_loop, pending, pending_progress_free);
+  });
+  return nullptr;
+}
+
+static FlMethodErrorResponse* progress_cancel_cb(FlEventChannel* channel, FlValue* args, gpointer user_data) {
+  progress_hub().SetListener(nullptr);
+  return nullptr;
+}
+
+static gboolean respond_on_main_loop(gpointer user_data) {
+  PendingResponse* pending = static_cast<PendingResponse*>(user_data);
+  fl_method_call_respond(pending->method_call, pending->response, nullptr);
+  return G_SOURCE_REMOVE;
+}
+
+static void pending_response_free(gpointer user_data) {
+  PendingResponse* pending = static_cast<PendingResponse*>(user_data);
+  g_object_unref(pending->response);
+  g_object_unref(pending->method_call);
+  g_free(pending);
+}
 
+static MethodHandler find_method_handler(const gchar* method) {
     if (strcmp(method, "mergeMultiplePDF") == 0) {
-        response = merge_multiple_pdfs(fl_method_call_get_args(method_call));
+        return merge_multiple_pdfs;
+    } else if (strcmp(method, "mergeMultiplePDFToBytes") == 0) {
+        return merge_multiple_pdfs_to_bytes;
     } else if (strcmp(method, "createPDFFromMultipleImage") == 0) {
-        response = create_pdf_from_multiple_images(fl_method_call_get_args(method_call));
+        return create_pdf_from_multiple_images;
     } else if (strcmp(method, "createImageFromPDF") == 0) {
-        response = create_image_from_pdf(fl_method_call_get_args(method_call));
-    } else {
-        response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+        return create_image_from_pdf;
+    } else if (strcmp(method, "createImageFromPDFToBytes") == 0) {
+        return create_image_from_pdf_to_bytes;
+    } else if (strcmp(method, "createThumbnailsFromPDF") == 0) {
+        return create_thumbnails_from_pdf;
+    } else if (strcmp(method, "runBatch") == 0) {
+        return run_batch;
+    } else if (strcmp(method, "configureDocumentCache") == 0) {
+        return configure_document_cache;
     }
+    return nullptr;
+}
 
-  fl_method_call_respond(method_call, response, nullptr);
+static FlMethodResponse* get_native_stats(PdfCombinerPlugin* self) {
+    g_autoptr(FlValue) result = fl_value_new_map();
+    WorkerPool* pool = self->worker_pool;
+    fl_value_set_string_take(result, "workers", fl_value_new_int(pool ? pool->WorkerCount() : 0));
+    fl_value_set_string_take(result, "queueDepth", fl_value_new_int(pool ? pool->QueueDepth() : 0));
+    fl_value_set_string_take(result, "queueCapacity", fl_value_new_int(pool ? pool->QueueCapacity() : 0));
+    fl_value_set_string_take(result, "runningJobs", fl_value_new_int(pool ? pool->RunningJobs() : 0));
+
+    NativeStats& stats = native_stats();
+    fl_value_set_string_take(result, "bytesWritten", fl_value_new_int(stats.bytes_written.load()));
+    fl_value_set_string_take(result, "writeCalls", fl_value_new_int(stats.write_calls.load()));
+    fl_value_set_string_take(result, "writeMicros", fl_value_new_int(stats.write_micros.load()));
+    fl_value_set_string_take(result, "mappedFileBytes", fl_value_new_int(stats.mapped_file_bytes.load()));
+    fl_value_set_string_take(result, "mappedBytesRead", fl_value_new_int(stats.mapped_bytes_read.load()));
+    fl_value_set_string_take(result, "mappedBytesTouched", fl_value_new_int(stats.mapped_bytes_touched.load()));
+    fl_value_set_string_take(result, "documentCacheHits", fl_value_new_int(stats.document_cache_hits.load()));
+    fl_value_set_string_take(result, "documentCacheMisses", fl_value_new_int(stats.document_cache_misses.load()));
+    fl_value_set_string_take(result, "documentCacheEvictions", fl_value_new_int(stats.document_cache_evictions.load()));
+    fl_value_set_string_take(result, "documentCacheDocuments", fl_value_new_int(stats.document_cache_documents.load()));
+    fl_value_set_string_take(result, "documentCacheBytes", fl_value_new_int(stats.document_cache_bytes.load()));
+    fl_value_set_string_take(result, "pngImages", fl_value_new_int(stats.png_images.load()));
+    fl_value_set_string_take(result, "pngBytes", fl_value_new_int(stats.png_bytes.load()));
+    fl_value_set_string_take(result, "pngEncodeMicros", fl_value_new_int(stats.png_encode_micros.load()));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-FlMethodResponse* merge_multiple_pdfs(FlValue* args) {
-    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
-        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with inputPaths and outputPath", nullptr));
-    }
+// Returns the optional jobId of a call, used to cancel it.
+static const gchar* get_job_id(FlValue* args) {
+    if (!args || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) return nullptr;
+    FlValue* job_id_value = fl_value_lookup_string(args, "jobId");
+    if (!job_id_value || fl_value_get_type(job_id_value) != FL_VALUE_TYPE_STRING) return nullptr;
+    return fl_value_get_string(job_id_value);
+}
 
-    // Get inputPaths (List<String>)
-    FlValue* input_paths_value = fl_value_lookup_string(args, "paths");
-    if (!input_paths_value || fl_value_get_type(input_paths_value) != FL_VALUE_TYPE_LIST) {
-        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "inputPaths must be a list of strings", nullptr));
-    }
+// Returns the jobId of a call for progress events, empty if it has none.
+static std::string progress_job_id(FlValue* args) {
+    const gchar* job_id = get_job_id(args);
+    return job_id ? job_id : "";
+}
 
-    // Get outputPath (String)
-    FlValue* output_path_value = fl_value_lookup_string(args, "outputDirPath");
-    if (!output_path_value || fl_value_get_type(output_path_value) != FL_VALUE_TYPE_STRING) {
-        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "outputPath must be a string", nullptr));
+// Returns the cancellation flag of the job a call belongs to, or null.
+static JobRegistry::CancelFlag find_cancel_flag(FlValue* args) {
+    const gchar* job_id = get_job_id(args);
+    return job_id ? job_registry().Find(job_id) : JobRegistry::CancelFlag();
+}
+
+static FlMethodResponse* cancelled_response() {
+    return FL_METHOD_RESPONSE(fl_method_error_response_new("cancelled", "The operation was cancelled", nullptr));
+}
+
+// Flags a queued or running job as cancelled. Returns whether it was found.
+static FlMethodResponse* cancel_job(FlValue* args) {
+    const gchar* job_id = get_job_id(args);
+    if (!job_id) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "jobId must be a string", nullptr));
     }
+    g_autoptr(FlValue) result = fl_value_new_bool(job_registry().Cancel(job_id));
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
 
-    // Cast outputPath to C-string
-    const char* output_path = fl_value_get_string(output_path_value);
+// Called when a method call is received from Flutter.
+static void pdf_combiner_plugin_handle_method_call( PdfCombinerPlugin* self, FlMethodCall* method_call) {
+  const gchar* method = fl_method_call_get_name(method_call);
 
-    // Cast inputPaths to a strings vector
-    int num_pdfs = fl_value_get_length(input_paths_value);
-    std::vector<std::string> input_paths;
+  if (strcmp(method, "getNativeStats") == 0) {
+    g_autoptr(FlMethodResponse) response = get_native_stats(self);
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  // Answered right away, so it is not stuck behind the job it cancels
+  if (strcmp(method, "cancel") == 0) {
+    g_autoptr(FlMethodResponse) response = cancel_job(fl_method_call_get_args(method_call));
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  MethodHandler handler = find_method_handler(method);
+  if (!handler) {
+    g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    fl_method_call_respond(method_call, response, nullptr);
+    return;
+  }
+
+  // The job keeps the call alive until the response has been delivered, and
+  // releases it if the job is dropped on shutdown.
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)), g_object_unref);
+  const gchar* job_id = get_job_id(fl_method_call_get_args(method_call));
+  JobRegistry::CancelFlag cancelled;
+  if (job_id) cancelled = job_registry().Register(job_id);
+  bool queued = self->worker_pool && self->worker_pool->Submit([call, handler, cancelled]() {
+      FlMethodResponse* response;
+      if (cancelled && cancelled->load()) {
+          response = cancelled_response();
+      } else {
+          std::lock_guard<std::mutex> lock(pdfium_mutex());
+          response = handler(fl_method_call_get_args(call.get()));
+      }
+      const gchar* job_id = get_job_id(fl_method_call_get_args(call.get()));
+      if (job_id) job_registry().Unregister(job_id);
+      PendingResponse* pending = g_new0(PendingResponse, 1);
+      pending->method_call = FL_METHOD_CALL(g_object_ref(call.get()));
+      pending->response = response;
+      g_main_context_invoke_full(nullptr, G_PRIORITY_DEFAULT, respond_on_main_loop, pending, pending_response_free);
+  });
+
+  if (!queued) {
+    if (job_id) job_registry().Unregister(job_id);
+    g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+            "queue_full", "Too many pending pdf_combiner operations, try again later", nullptr));
+    fl_method_call_respond(method_call, response, nullptr);
+  }
+}
+
+// Input files kept open across calls: the plugin's DocumentCache, or the one
+// of the running batch when it is disabled (see run_batch). Only used with
+// pdfium_mutex() held.
+static DocumentCache* shared_documents = nullptr;
+
+// Maps an input file, through shared_documents when it is enabled. Otherwise
+// the mapping is owned by `mapped_file`.
+static MappedFile* map_input_file(const char* path, std::unique_ptr<MappedFile>& mapped_file) {
+    if (shared_documents && shared_documents->Enabled()) return shared_documents->Map(path);
+    mapped_file.reset(new MappedFile(path));
+    return mapped_file.get();
+}
+
+// Loads an input PDF file, from shared_documents when it is enabled.
+// Otherwise it is read through `mapped_file`, which must outlive the document.
+static FPDF_DOCUMENT load_input_file(const char* path, std::unique_ptr<MappedFile>& mapped_file) {
+    if (shared_documents && shared_documents->Enabled()) return shared_documents->Open(path);
+    mapped_file.reset(new MappedFile(path));
+    return mapped_file->LoadDocument();
+}
+
+// Closes a document returned by load_input_file or load_merge_input, unless
+// it belongs to shared_documents.
+static void close_input_document(FPDF_DOCUMENT doc) {
+    if (!shared_documents || !shared_documents->Owns(doc)) FPDF_CloseDocument(doc);
+}
+
+// Loads one merge input, given either as a file path or as the bytes of a PDF.
+// Byte inputs are read straight from the channel buffer and files through
+// load_input_file; both must outlive the returned document.
+static FPDF_DOCUMENT load_merge_input(FlValue* input_value, std::unique_ptr<MappedFile>& mapped_file) {
+    if (fl_value_get_type(input_value) == FL_VALUE_TYPE_UINT8_LIST) {
+        return FPDF_LoadMemDocument64(fl_value_get_uint8_list(input_value), fl_value_get_length(input_value), nullptr);
+    }
+    return load_input_file(fl_value_get_string(input_value), mapped_file);
+}
+
+// Checks the inputs (List<String | Uint8List>) and page ranges (List<String?>,
+// one per input) of a merge call. Returns nullptr if they are valid.
+static FlMethodResponse* validate_merge_inputs(FlValue* input_values, FlValue* page_ranges) {
+    // Validate the inputs (List<String | Uint8List>)
+    int num_pdfs = fl_value_get_length(input_values);
     for (int i = 0; i < num_pdfs; i++) {
-        FlValue* path_value = fl_value_get_list_value(input_paths_value, i);
-        if (!path_value || fl_value_get_type(path_value) != FL_VALUE_TYPE_STRING) {
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Each item in inputPaths must be a string", nullptr));
+        FlValue* input_value = fl_value_get_list_value(input_values, i);
+        FlValueType type = input_value ? fl_value_get_type(input_value) : FL_VALUE_TYPE_NULL;
+        if (type != FL_VALUE_TYPE_STRING && type != FL_VALUE_TYPE_UINT8_LIST) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Each item in inputPaths must be a string or a Uint8List", nullptr));
+        }
+    }
+
+    // Validate the page ranges (List<String?>, one per input)
+    if (page_ranges && fl_value_get_type(page_ranges) != FL_VALUE_TYPE_NULL) {
+        if (fl_value_get_type(page_ranges) != FL_VALUE_TYPE_LIST || (int)fl_value_get_length(page_ranges) != num_pdfs) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "pageRanges must be a list with one item per input", nullptr));
+        }
+        for (int i = 0; i < num_pdfs; i++) {
+            FlValueType type = fl_value_get_type(fl_value_get_list_value(page_ranges, i));
+            if (type != FL_VALUE_TYPE_STRING && type != FL_VALUE_TYPE_NULL) {
+                return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Each item in pageRanges must be a string or null", nullptr));
+            }
         }
-        input_paths.push_back(std::string(fl_value_get_string(path_value)));
     }
+    return nullptr;
+}
+
+// The name of merge input `index` in error messages: its path, or its index.
+static std::string merge_input_name(FlValue* input_value, int index) {
+    return fl_value_get_type(input_value) == FL_VALUE_TYPE_STRING
+            ? std::string(fl_value_get_string(input_value))
+            : "bytes at index " + std::to_string(index);
+}
+
+// Resolves the pages selected from merge input `index` in `page_ranges` into
+// `indices`, left empty for all of them. Returns the number of pages selected,
+// or -1 with the error response in `error`.
+static int select_merge_pages(FlValue* page_ranges, int index, int page_count, const std::string& input_name,
+                              std::vector<int>& indices, FlMethodResponse** error) {
+    indices.clear();
+    FlValue* range_value = page_ranges ? fl_value_get_list_value(page_ranges, index) : nullptr;
+    if (!range_value || fl_value_get_type(range_value) != FL_VALUE_TYPE_STRING) return page_count;
+    std::string range = fl_value_get_string(range_value);
+    if (!parse_page_range(range, page_count, indices)) {
+        *error = FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_page_range", ("Invalid page range \"" + range + "\" for document: " + input_name).c_str(), nullptr));
+        return -1;
+    }
+    return (int)indices.size();
+}
+
+// Imports the pages of every input into a new document: all of them, or the
+// selection given for that input in `page_ranges` (see parse_page_range). Only
+// the selected pages are copied. On success stores the document in `out_doc`
+// and returns nullptr, otherwise returns the error response.
+static FlMethodResponse* merge_input_documents(FlValue* input_values, FlValue* page_ranges, FPDF_DOCUMENT* out_doc,
+                                               ProgressReporter& progress) {
+    FlMethodResponse* error = validate_merge_inputs(input_values, page_ranges);
+    if (error) return error;
+    if (page_ranges && fl_value_get_type(page_ranges) == FL_VALUE_TYPE_NULL) page_ranges = nullptr;
+    int num_pdfs = fl_value_get_length(input_values);
 
     // Create an empty document
     FPDF_DOCUMENT new_doc = FPDF_CreateNewDocument();
@@ -91,37 +376,300 @@ FlMethodResponse* merge_multiple_pdfs(FlValue* args) {
 
     int total_pages = 0;  // Variable to track total pages
 
-    // Process each PDF file in input_paths
-    for (const auto& input_path : input_paths) {
-        // Load the PDF file
-        FPDF_DOCUMENT doc = FPDF_LoadDocument(input_path.c_str(), nullptr);
+    // Process each PDF in the inputs
+    std::vector<int> page_indices;
+    for (int i = 0; i < num_pdfs; i++) {
+        FlValue* input_value = fl_value_get_list_value(input_values, i);
+        std::string input_name = merge_input_name(input_value, i);
+
+        // Load the PDF file or buffer
+        std::unique_ptr<MappedFile> mapped_file;
+        FPDF_DOCUMENT doc = load_merge_input(input_value, mapped_file);
         if (!doc) {
             FPDF_CloseDocument(new_doc);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", ("Failed to load document: " + input_path).c_str(), nullptr));
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", ("Failed to load document: " + input_name).c_str(), nullptr));
         }
 
-        // Get the number of pages in the loaded document
-        int page_count = FPDF_GetPageCount(doc);
-
-        // Import the page into the new document
-        if (!FPDF_ImportPages(new_doc, doc, nullptr, total_pages)) {
-            FPDF_CloseDocument(doc);
+        // Resolve the selected pages, all of them by default
+        int page_count = select_merge_pages(page_ranges, i, FPDF_GetPageCount(doc), input_name, page_indices, &error);
+        if (page_count < 0) {
+            close_input_document(doc);
+            FPDF_CloseDocument(new_doc);
+            return error;
+        }
+        progress.AddPages(page_count);
+
+        // Import the pages into the new document
+        bool imported = page_indices.empty()
+                ? FPDF_ImportPages(new_doc, doc, nullptr, total_pages)
+                : FPDF_ImportPagesByIndex(new_doc, doc, page_indices.data(), (unsigned long)page_indices.size(), total_pages);
+        if (!imported) {
+            close_input_document(doc);
             FPDF_CloseDocument(new_doc);
             return FL_METHOD_RESPONSE(fl_method_error_response_new("page_import_failed", "Failed to import page into new document", nullptr));
         }
         total_pages += page_count;
+        progress.Advance(page_count);
 
         // Close the loaded document
-        FPDF_CloseDocument(doc);
+        close_input_document(doc);
+        progress.DocumentDone();
+    }
+
+    *out_doc = new_doc;
+    return nullptr;
+}
+
+// How a merge call writes its output (MergeConfig on the Dart side)
+struct MergeOptions {
+    bool linearize = false;    // "fast web view" layout, see PdfLinearizer
+    bool streaming = false;    // pages written as they are copied, see PdfStreamMerger
+    bool deduplicate = false;  // identical streams written once, only done when streaming
+    bool compact = false;      // object streams and a cross-reference stream, not with linearize
+
+    // Images re-encoded as JPEG, see ImageRecompressor; only done when streaming
+    int max_image_dpi = 0;
+    int64_t target_bytes = 0;
+    int image_quality = 75;
+
+    bool RecompressesImages() const { return max_image_dpi > 0 || target_bytes > 0; }
+};
+
+static bool bool_argument(FlValue* args, const char* key) {
+    FlValue* value = fl_value_lookup_string(args, key);
+    return value && fl_value_get_type(value) == FL_VALUE_TYPE_BOOL && fl_value_get_bool(value);
+}
+
+static int64_t int_argument(FlValue* args, const char* key, int64_t fallback) {
+    FlValue* value = fl_value_lookup_string(args, key);
+    return value && fl_value_get_type(value) == FL_VALUE_TYPE_INT ? fl_value_get_int(value) : fallback;
+}
+
+static double double_argument(FlValue* args, const char* key, double fallback) {
+    FlValue* value = fl_value_lookup_string(args, key);
+    if (!value) return fallback;
+    if (fl_value_get_type(value) == FL_VALUE_TYPE_FLOAT) return fl_value_get_float(value);
+    return fl_value_get_type(value) == FL_VALUE_TYPE_INT ? (double)fl_value_get_int(value) : fallback;
+}
+
+static MergeOptions merge_options(FlValue* args) {
+    MergeOptions options;
+    options.linearize = bool_argument(args, "linearize");
+    options.deduplicate = bool_argument(args, "deduplicate");
+    options.compact = bool_argument(args, "compact") && !options.linearize;
+    options.max_image_dpi = (int)std::max<int64_t>(0, int_argument(args, "maxImageDpi", 0));
+    options.target_bytes = std::max<int64_t>(0, int_argument(args, "targetBytes", 0));
+    options.image_quality = (int)std::min<int64_t>(100, std::max<int64_t>(1, int_argument(args, "imageQuality", 75)));
+    options.streaming = bool_argument(args, "streaming") || options.deduplicate || options.RecompressesImages();
+    return options;
+}
+
+// Runs the passes of `images` over the selected pages of every merge input,
+// loaded with PDFium, before they are merged.
+static FlMethodResponse* recompress_merge_images(FlValue* input_values, FlValue* page_ranges, ImageRecompressor& images) {
+    int num_pdfs = fl_value_get_length(input_values);
+    std::vector<int> page_indices;
+    do {
+        for (int i = 0; i < num_pdfs; i++) {
+            FlValue* input_value = fl_value_get_list_value(input_values, i);
+            std::string input_name = merge_input_name(input_value, i);
+            std::unique_ptr<MappedFile> mapped_file;
+            FPDF_DOCUMENT doc = load_merge_input(input_value, mapped_file);
+            if (!doc) {
+                return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", ("Failed to load document: " + input_name).c_str(), nullptr));
+            }
+            FlMethodResponse* error = nullptr;
+            int page_count = select_merge_pages(page_ranges, i, FPDF_GetPageCount(doc), input_name, page_indices, &error);
+            // The size of the file `doc` was loaded from. Not through Map():
+            // had the file changed since, it would close `doc`.
+            const MappedFile* file = mapped_file.get();
+            if (!file && shared_documents) file = shared_documents->FileOf(doc);
+            uint64_t size = file ? file->size() : fl_value_get_length(input_value);
+            bool read = page_count >= 0 && images.AddDocument(doc, page_indices, size);
+            close_input_document(doc);
+            if (page_count < 0) return error;
+            if (!read) {
+                return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", ("Failed to load document: " + input_name).c_str(), nullptr));
+            }
+        }
+    } while (images.NextPass());
+    return nullptr;
+}
+
+// Merges like merge_input_documents, but through PdfStreamMerger: every page
+// is written to `sink` as soon as it has been copied, so memory use does not
+// grow with the number of inputs. An input the merger cannot read itself (an
+// encrypted or damaged one, or one it misreads) is rewritten by PDFium, on
+// its own, and copied from that. `options` selects deduplication, image
+// recompression and the compact output.
+static FlMethodResponse* stream_merge_input_documents(FlValue* input_values, FlValue* page_ranges,
+                                                      const MergeOptions& options, FPDF_FILEWRITE* sink,
+                                                      ProgressReporter& progress) {
+    FlMethodResponse* error = validate_merge_inputs(input_values, page_ranges);
+    if (error) return error;
+    if (page_ranges && fl_value_get_type(page_ranges) == FL_VALUE_TYPE_NULL) page_ranges = nullptr;
+    int num_pdfs = fl_value_get_length(input_values);
+
+    PdfStreamMerger merger(sink, options.compact);
+    merger.progress = &progress;
+    merger.deduplicate = options.deduplicate;
+    ImageRecompressor images;
+    if (options.RecompressesImages()) {
+        images.max_dpi = options.max_image_dpi;
+        images.target_bytes = (uint64_t)options.target_bytes;
+        images.quality = options.image_quality;
+        error = recompress_merge_images(input_values, page_ranges, images);
+        if (error) return error;
+        merger.images = &images;
+    }
+    std::vector<int> page_indices;
+    for (int i = 0; i < num_pdfs; i++) {
+        FlValue* input_value = fl_value_get_list_value(input_values, i);
+        std::string input_name = merge_input_name(input_value, i);
+
+        // Read the PDF buffer or the mapped file
+        std::unique_ptr<MappedFile> mapped_file;
+        int page_count = -1;
+        if (fl_value_get_type(input_value) == FL_VALUE_TYPE_UINT8_LIST) {
+            page_count = merger.OpenInput(fl_value_get_uint8_list(input_value), fl_value_get_length(input_value));
+        } else {
+            MappedFile* file = map_input_file(fl_value_get_string(input_value), mapped_file);
+            if (file && file->IsOpen()) page_count = merger.OpenInput(file->data(), file->size());
+        }
+        MyMemoryWrite rewritten;
+        auto open_rewritten = [&]() {
+            int count = -1;
+            FPDF_DOCUMENT doc = load_merge_input(input_value, mapped_file);
+            if (doc && FPDF_SaveAsCopy(doc, &rewritten, FPDF_REMOVE_SECURITY)) {
+                count = merger.OpenInput(rewritten.data.data(), rewritten.data.size());
+            }
+            if (doc) close_input_document(doc);
+            return count;
+        };
+        if (page_count < 0) page_count = open_rewritten();
+        if (page_count < 0) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", ("Failed to load document: " + input_name).c_str(), nullptr));
+        }
+
+        // Resolve the selected pages, all of them by default
+        int input_page_count = page_count;
+        page_count = select_merge_pages(page_ranges, i, page_count, input_name, page_indices, &error);
+        if (page_count < 0) return error;
+        progress.AddPages(page_count);
+
+        // Copy the pages to the output, from PDFium's rewrite if an object
+        // they use could not be read
+        bool copied = merger.CopyPages(page_indices);
+        if (!copied && rewritten.data.empty() && open_rewritten() == input_page_count) {
+            progress.AddPages(page_count);
+            copied = merger.CopyPages(page_indices);
+        }
+        if (!copied) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("page_import_failed", "Failed to import page into new document", nullptr));
+        }
+        progress.DocumentDone();
+    }
+
+    if (!merger.Finish()) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
+    }
+    return nullptr;
+}
+
+// Runs stream_merge_input_documents for a merge call into `sink`. A linearized
+// output has to be laid out as a whole, so it is merged into memory first and
+// then rewritten by PdfLinearizer.
+static FlMethodResponse* stream_merge_to_sink(FlValue* args, FlValue* input_values, const MergeOptions& options,
+                                              FPDF_FILEWRITE* sink, ProgressReporter& progress) {
+    FlValue* page_ranges = fl_value_lookup_string(args, "pageRanges");
+    if (!options.linearize) {
+        return stream_merge_input_documents(input_values, page_ranges, options, sink, progress);
+    }
+    std::string linearized;
+    {
+        MyMemoryWrite merged;
+        FlMethodResponse* error = stream_merge_input_documents(input_values, page_ranges, options, &merged, progress);
+        if (error) return error;
+        if (!linearize_pdf(merged.data.data(), merged.data.size(), linearized)) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
+        }
+    }
+    if (!sink->WriteBlock(sink, linearized.data(), linearized.size())) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
+    }
+    return nullptr;
+}
+
+// Saves a merged document to `sink`. A linearized or compact output is saved
+// to memory first and rewritten by PdfLinearizer or PdfCompactor, as PDFium
+// cannot write either itself.
+static bool save_merged_document(FPDF_DOCUMENT doc, FPDF_FILEWRITE* sink, const MergeOptions& options) {
+    if (!options.linearize && !options.compact) return FPDF_SaveAsCopy(doc, sink, FPDF_INCREMENTAL);
+    MyMemoryWrite saved;
+    if (!FPDF_SaveAsCopy(doc, &saved, FPDF_INCREMENTAL)) return false;
+    if (options.compact) return compact_pdf(saved.data.data(), saved.data.size(), sink);
+    std::string linearized;
+    if (!linearize_pdf(saved.data.data(), saved.data.size(), linearized)) return false;
+    std::vector<uint8_t>().swap(saved.data);
+    return sink->WriteBlock(sink, linearized.data(), linearized.size()) != 0;
+}
+
+FlMethodResponse* merge_multiple_pdfs(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with inputPaths and outputPath", nullptr));
+    }
+
+    // Get inputPaths (List<String | Uint8List>)
+    FlValue* input_paths_value = fl_value_lookup_string(args, "paths");
+    if (!input_paths_value || fl_value_get_type(input_paths_value) != FL_VALUE_TYPE_LIST) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "inputPaths must be a list of strings", nullptr));
+    }
+
+    // Get outputPath (String)
+    FlValue* output_path_value = fl_value_lookup_string(args, "outputDirPath");
+    if (!output_path_value || fl_value_get_type(output_path_value) != FL_VALUE_TYPE_STRING) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "outputPath must be a string", nullptr));
+    }
+
+    // Cast outputPath to C-string
+    const char* output_path = fl_value_get_string(output_path_value);
+
+    ProgressReporter progress("mergeMultiplePDF", progress_job_id(args), (int)fl_value_get_length(input_paths_value),
+                              progress_hub().Listener());
+
+    MergeOptions options = merge_options(args);
+    if (options.streaming) {
+        MyFileWrite file_write(output_path);
+        file_write.progress = &progress;
+        if (!file_write.IsOpen()) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", ("Failed to open output file: " + std::string(output_path)).c_str(), nullptr));
+        }
+        FlMethodResponse* error = stream_merge_to_sink(args, input_paths_value, options, &file_write, progress);
+        if (error) {
+            return error;
+        }
+        if (!file_write.Commit()) {
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
+        }
+        g_autoptr(FlValue) result = fl_value_new_string(output_path);
+        return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    }
+
+    FPDF_DOCUMENT new_doc = nullptr;
+    FlMethodResponse* error = merge_input_documents(input_paths_value, fl_value_lookup_string(args, "pageRanges"), &new_doc, progress);
+    if (error) {
+        return error;
     }
 
-    MyFileWrite file_write;
-    file_write.version = 1;
-    file_write.WriteBlock = MyWriteBlock;
-    file_write.filename = output_path;
+    MyFileWrite file_write(output_path);
+    file_write.progress = &progress;
+    if (!file_write.IsOpen()) {
+        FPDF_CloseDocument(new_doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", ("Failed to open output file: " + std::string(output_path)).c_str(), nullptr));
+    }
 
     // Save the new document
-    if (!FPDF_SaveAsCopy(new_doc, (FPDF_FILEWRITE*)&file_write, FPDF_INCREMENTAL)) {
+    if (!save_merged_document(new_doc, &file_write, options) || !file_write.Commit()) {
         FPDF_CloseDocument(new_doc);
         return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
     }
@@ -134,41 +682,193 @@ FlMethodResponse* merge_multiple_pdfs(FlValue* args) {
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-std::string ProcessHeic(const std::string& path) {
+FlMethodResponse* merge_multiple_pdfs_to_bytes(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with inputPaths", nullptr));
+    }
+
+    // Get inputPaths (List<String | Uint8List>)
+    FlValue* input_paths_value = fl_value_lookup_string(args, "paths");
+    if (!input_paths_value || fl_value_get_type(input_paths_value) != FL_VALUE_TYPE_LIST) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "inputPaths must be a list of strings or Uint8List", nullptr));
+    }
+
+    ProgressReporter progress("mergeMultiplePDFToBytes", progress_job_id(args),
+                              (int)fl_value_get_length(input_paths_value), progress_hub().Listener());
+
+    MergeOptions options = merge_options(args);
+    if (options.streaming) {
+        MyMemoryWrite memory_write;
+        FlMethodResponse* error = stream_merge_to_sink(args, input_paths_value, options, &memory_write, progress);
+        if (error) {
+            return error;
+        }
+        progress.Advance(0, memory_write.data.size());
+        g_autoptr(FlValue) result = fl_value_new_uint8_list(memory_write.data.data(), memory_write.data.size());
+        return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    }
+
+    FPDF_DOCUMENT new_doc = nullptr;
+    FlMethodResponse* error = merge_input_documents(input_paths_value, fl_value_lookup_string(args, "pageRanges"), &new_doc, progress);
+    if (error) {
+        return error;
+    }
+
+    // Save the new document into memory
+    MyMemoryWrite memory_write;
+    if (!save_merged_document(new_doc, &memory_write, options)) {
+        FPDF_CloseDocument(new_doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
+    }
+    progress.Advance(0, memory_write.data.size());
+
+    // Close the new document
+    FPDF_CloseDocument(new_doc);
+
+    // Return success response with the merged document
+    g_autoptr(FlValue) result = fl_value_new_uint8_list(memory_write.data.data(), memory_write.data.size());
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Decodes a HEIC/HEIF file into tightly packed RGBA pixels.
+bool ProcessHeic(const std::string& path, int& width, int& height, std::vector<unsigned char>& rgba) {
 #ifdef HAS_HEIF
     heif_context* ctx = heif_context_alloc();
     heif_error err = heif_context_read_from_file(ctx, path.c_str(), nullptr);
-    if (err.code != heif_error_Ok) { heif_context_free(ctx); return ""; }
+    if (err.code != heif_error_Ok) { heif_context_free(ctx); return false; }
 
     heif_image_handle* handle = nullptr;
     err = heif_context_get_primary_image_handle(ctx, &handle);
-    if (err.code != heif_error_Ok) { heif_context_free(ctx); return ""; }
+    if (err.code != heif_error_Ok) { heif_context_free(ctx); return false; }
 
     heif_image* img = nullptr;
-    err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, nullptr);
+    err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGBA, nullptr);
     if (err.code != heif_error_Ok) {
         heif_image_handle_release(handle);
         heif_context_free(ctx);
-        return "";
+        return false;
     }
 
-    int width = heif_image_get_width(img, heif_channel_interleaved);
-    int height = heif_image_get_height(img, heif_channel_interleaved);
+    width = heif_image_get_width(img, heif_channel_interleaved);
+    height = heif_image_get_height(img, heif_channel_interleaved);
     int stride;
     const uint8_t* data = heif_image_get_plane_readonly(img, heif_channel_interleaved, &stride);
 
-    std::string out_jpg = path + ".tmp.jpg";
-    int success = stbi_write_jpg(out_jpg.c_str(), width, height, 3, data, 85);
+    // Copy row by row, the plane stride can be padded
+    bool success = data && width > 0 && height > 0;
+    if (success) {
+        size_t row_size = (size_t)width * 4;
+        rgba.resize(row_size * height);
+        for (int y = 0; y < height; y++) {
+            memcpy(rgba.data() + y * row_size, data + (size_t)y * stride, row_size);
+        }
+    }
 
     heif_image_release(img);
     heif_image_handle_release(handle);
     heif_context_free(ctx);
-    return success ? out_jpg : "";
+    return success;
 #else
-    return "";
+    return false;
 #endif
 }
 
+// An input image decoded and converted for FPDFImageObj_SetBitmap.
+struct DecodedImage {
+    std::string path;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bgrx;  // bottom-up rows, stride is width * 4
+    std::unique_ptr<MappedFile> jpeg;  // set instead of bgrx for JPEG passthrough
+    bool skipped = false;
+    std::string error_code;
+    std::string error_message;
+};
+
+// Decodes and resizes one image. Runs on the decoder threads, so it must not
+// call into PDFium.
+static DecodedImage decode_image_for_pdf(const std::string& path, int64_t max_width, int64_t max_height, bool keep_aspect_ratio) {
+    DecodedImage image;
+    image.path = path;
+
+    // Load the image and get its dimensions
+    int width, height, channels;
+    unsigned char* image_data = nullptr;
+    std::vector<unsigned char> heic_data;
+    bool is_heic = (path.find(".heic") != std::string::npos || path.find(".HEIC") != std::string::npos ||
+                   path.find(".heif") != std::string::npos || path.find(".HEIF") != std::string::npos);
+
+    if (is_heic) {
+        // HEIC is decoded straight to memory, stb cannot read it
+        if (!ProcessHeic(path, width, height, heic_data)) {
+            image.skipped = true;
+            return image;
+        }
+    } else {
+        // JPEG files kept at their size are embedded as they are, without decoding
+        bool is_jpg = (path.find(".jpg") != std::string::npos || path.find(".JPG") != std::string::npos ||
+                       path.find(".jpeg") != std::string::npos || path.find(".JPEG") != std::string::npos);
+        if (is_jpg && max_width == 0 && max_height == 0) {
+            std::unique_ptr<MappedFile> jpeg(new MappedFile(path.c_str()));
+            if (jpeg->IsOpen() && jpeg->size() <= INT_MAX &&
+                stbi_info_from_memory(jpeg->data(), (int)jpeg->size(), &image.width, &image.height, &channels)) {
+                image.jpeg = std::move(jpeg);
+                return image;
+            }
+        }
+
+        image_data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!image_data) {
+            image.error_code = "image_loading_failed";
+            image.error_message = "Failed to load image: " + path;
+            return image;
+        }
+    }
+    const unsigned char* pixels = image_data ? image_data : heic_data.data();
+
+    // Resize the image if necessary
+    std::vector<unsigned char> resized_image_data;
+    if (max_width != 0 || max_height != 0) {
+        int new_width = width;
+        int new_height = height;
+
+        if (max_width != 0) {
+            new_width = max_width;
+        }
+
+        if (max_height != 0) {
+            if (keep_aspect_ratio) {
+                double aspectRatio = static_cast<double>(height) / width;
+                new_height = static_cast<int>(max_width * aspectRatio);
+            } else {
+                new_height = max_height;
+            }
+        }
+
+        resized_image_data.resize((size_t)new_width * new_height * 4);
+        if (!stbir_resize_uint8_linear(pixels, width, height, 0, resized_image_data.data(), new_width, new_height, 0, STBIR_RGBA)) {
+            stbi_image_free(image_data);
+            image.error_code = "image_resize_failed";
+            image.error_message = "Failed to resize image";
+            return image;
+        }
+
+        // Assigning the new values
+        pixels = resized_image_data.data();
+        width = new_width;
+        height = new_height;
+    }
+
+    // Convert to BGRx and flip vertically, as the image matrix expects
+    image.width = width;
+    image.height = height;
+    image.bgrx.resize((size_t)width * height * 4);
+    swizzle_rgba_bgra(pixels, (size_t)width * 4, image.bgrx.data(), (size_t)width * 4, width, height, true);
+
+    stbi_image_free(image_data);
+    return image;
+}
+
 FlMethodResponse* create_pdf_from_multiple_images(FlValue* args) {
     if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
         return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with inputPaths and outputPath", nullptr));
@@ -228,102 +928,71 @@ FlMethodResponse* create_pdf_from_multiple_images(FlValue* args) {
         input_paths.push_back(std::string(fl_value_get_string(path_value)));
     }
 
+    // Every image is an input document of one page
+    ProgressReporter progress("createPDFFromMultipleImage", progress_job_id(args), num_images, progress_hub().Listener());
+    progress.AddPages(num_images);
+
     // Create an empty document
     FPDF_DOCUMENT new_doc = FPDF_CreateNewDocument();
     if (!new_doc) {
         return FL_METHOD_RESPONSE(fl_method_error_response_new("document_creation_failed", "Failed to create new PDF document", nullptr));
     }
 
-    // Process each image file in input_paths
-    for (const auto& path : input_paths) {
-        std::string current_path = path;
-        bool is_temp = false;
-        
-        bool is_heic = (path.find(".heic") != std::string::npos || path.find(".HEIC") != std::string::npos ||
-                       path.find(".heif") != std::string::npos || path.find(".HEIF") != std::string::npos);
-        
-        if (is_heic) {
-            current_path = ProcessHeic(path);
-            if (current_path.empty()) continue;
-            is_temp = true;
+    // Images are decoded and resized in parallel, then embedded here in order
+    size_t decoder_count = background_worker_count(input_paths.size());
+    OrderedPipeline<DecodedImage> decoder(input_paths.size(), decoder_count, decoder_count * 2, [&](size_t index) {
+        return decode_image_for_pdf(input_paths[index], max_width, max_height, keep_aspect_ratio);
+    });
+
+    DecodedImage image;
+    while (decoder.Next(image)) {
+        progress.Advance(1);
+        progress.DocumentDone();
+        if (image.skipped) continue;
+        if (!image.error_code.empty()) {
+            FPDF_CloseDocument(new_doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(image.error_code.c_str(), image.error_message.c_str(), nullptr));
         }
 
-        // Load the image and get its dimensions
-        int width, height, channels;
-        unsigned char* image_data = stbi_load(current_path.c_str(), &width, &height, &channels, 4);
-        if (!image_data) {
-            if (is_temp) remove(current_path.c_str());
+        int width = image.width;
+        int height = image.height;
+        FPDF_PAGE new_page = FPDFPage_New(new_doc, FPDF_GetPageCount(new_doc), width, height);
+        if (!new_page) {
             FPDF_CloseDocument(new_doc);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("image_loading_failed", ("Failed to load image: " + current_path).c_str(), nullptr));
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("page_creation_failed", ("Failed to create page for image: " + image.path).c_str(), nullptr));
         }
 
-        // Resize the image if necessary
-        if (max_width != 0 || max_height != 0) {
-            int new_width = width;
-            int new_height = height;
-
-            if (max_width != 0) {
-                new_width = max_width;
-            }
-
-            if (max_height != 0) {
-                if (keep_aspect_ratio) {
-                    double aspectRatio = static_cast<double>(height) / width;
-                    new_height = static_cast<int>(max_width * aspectRatio);
-                } else {
-                    new_height = max_height;
-                }
-            }
-
-            unsigned char* resized_image_data = new unsigned char[new_width * new_height * 4];
-
-            if (!stbir_resize_uint8_linear(image_data, width, height, 0, resized_image_data, new_width, new_height, 0, STBIR_RGBA)) {
-                stbi_image_free(image_data);
+        if (image.jpeg) {
+            // Copy the JPEG data into the document as a DCT stream
+            FPDF_PAGEOBJECT image_obj = FPDFPageObj_NewImageObj(new_doc);
+            if (!image_obj || !FPDFImageObj_LoadJpegFileInline(&new_page, 1, image_obj, image.jpeg->file_access())) {
+                if (image_obj) FPDFPageObj_Destroy(image_obj);
+                FPDF_ClosePage(new_page);
                 FPDF_CloseDocument(new_doc);
-                return FL_METHOD_RESPONSE(fl_method_error_response_new("image_resize_failed", "Failed to resize image", nullptr));
+                return FL_METHOD_RESPONSE(fl_method_error_response_new("image_object_creation_failed", ("Failed to create image object for: " + image.path).c_str(), nullptr));
             }
-
-            // Free only the original image, not the resized one
-            stbi_image_free(image_data);
-
-            // Assigning the new values
-            image_data = resized_image_data;
-            width = new_width;
-            height = new_height;
+            FPDFImageObj_SetMatrix(image_obj, width, 0, 0, height, 0, 0);
+            FPDFPage_InsertObject(new_page, image_obj);
+            FPDFPage_GenerateContent(new_page);
+            FPDF_ClosePage(new_page);
+            image.jpeg.reset();
+            continue;
         }
 
-        FPDF_PAGE new_page = FPDFPage_New(new_doc, FPDF_GetPageCount(new_doc), width, height);
-        if (!new_page) {
-            if (is_temp) remove(current_path.c_str());
-            stbi_image_free(image_data);
+        // Crate bitmap over the decoded pixels
+        FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRx, image.bgrx.data(), width * 4);
+        if (!bitmap) {
+            FPDF_ClosePage(new_page);
             FPDF_CloseDocument(new_doc);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("page_creation_failed", ("Failed to create page for image: " + current_path).c_str(), nullptr));
-        }
-
-        // Crate bitmap of the image
-        FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0);
-        FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
-        unsigned char* bitmap_buffer = (unsigned char*)FPDFBitmap_GetBuffer(bitmap);
-        int stride = FPDFBitmap_GetStride(bitmap);
-
-        for (int y = 0; y < height; y++) {
-            unsigned char* src_row = image_data + y * width * 4;
-            unsigned char* dst_row = bitmap_buffer + (height - 1 - y) * stride;
-
-            for (int x = 0; x < width; x++) {
-                dst_row[x * 4 + 0] = src_row[x * 4 + 2]; // Blue  <- Red
-                dst_row[x * 4 + 1] = src_row[x * 4 + 1]; // Green <- Green
-                dst_row[x * 4 + 2] = src_row[x * 4 + 0]; // Red   <- Blue
-                dst_row[x * 4 + 3] = src_row[x * 4 + 3]; // Alpha <- Alpha
-            }
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("bitmap_creation_failed", ("Failed to create bitmap for image: " + image.path).c_str(), nullptr));
         }
 
         FPDF_PAGEOBJECT image_obj = FPDFPageObj_NewImageObj(new_doc);
         if (!image_obj) {
-            if (is_temp) remove(current_path.c_str());
-            stbi_image_free(image_data);
+            FPDFBitmap_Destroy(bitmap);
+            FPDF_ClosePage(new_page);
             FPDF_CloseDocument(new_doc);
-            return FL_METHOD_RESPONSE(fl_method_error_response_new("image_object_creation_failed", ("Failed to create image object for: " + current_path).c_str(), nullptr));
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("image_object_creation_failed", ("Failed to create image object for: " + image.path).c_str(), nullptr));
         }
 
         FPDFImageObj_SetBitmap(&new_page, 1, image_obj, bitmap);
@@ -331,18 +1000,20 @@ FlMethodResponse* create_pdf_from_multiple_images(FlValue* args) {
         FPDFPage_InsertObject(new_page, image_obj);
         FPDFPage_GenerateContent(new_page);
 
-        stbi_image_free(image_data);
         FPDFBitmap_Destroy(bitmap);
-        if (is_temp) remove(current_path.c_str());
+        FPDF_ClosePage(new_page);
+        image.bgrx = std::vector<uint8_t>();
     }
 
-    MyFileWrite file_write;
-    file_write.version = 1;
-    file_write.WriteBlock = MyWriteBlock;
-    file_write.filename = output_path;
+    MyFileWrite file_write(output_path);
+    file_write.progress = &progress;
+    if (!file_write.IsOpen()) {
+        FPDF_CloseDocument(new_doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", ("Failed to open output file: " + std::string(output_path)).c_str(), nullptr));
+    }
 
     // Save the new document
-    if (!FPDF_SaveAsCopy(new_doc, (FPDF_FILEWRITE*)&file_write, FPDF_INCREMENTAL)) {
+    if (!FPDF_SaveAsCopy(new_doc, &file_write, FPDF_INCREMENTAL) || !file_write.Commit()) {
         FPDF_CloseDocument(new_doc);
         return FL_METHOD_RESPONSE(fl_method_error_response_new("document_save_failed", "Failed to save the new PDF document", nullptr));
     }
@@ -355,15 +1026,33 @@ FlMethodResponse* create_pdf_from_multiple_images(FlValue* args) {
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
-FlMethodResponse* create_image_from_pdf(FlValue* args) {
-    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
-        return FL_METHOD_RESPONSE(fl_method_error_response_new(
-                "invalid_arguments", "Expected a map with inputPath, outputDirPath, width, height, compression and createOneImage keys", nullptr));
+// The number of encoder threads and queued pages for rendering `page_indices`
+// of `doc`. Every queued and encoding page holds its bitmap, so fewer are
+// queued when large pages would not fit in `available` bytes together; the
+// largest page is known without loading the pages.
+static void size_page_encoder(FPDF_DOCUMENT doc, const std::vector<int>& page_indices, const RenderSize& render_size,
+                              uint64_t available, size_t& encoder_count, size_t& queue_capacity) {
+    uint64_t largest_bitmap = 0;
+    for (int index : page_indices) {
+        FS_SIZEF size;
+        int width, height;
+        if (FPDF_GetPageSizeByIndexF(doc, index, &size) && render_size.PageSize(size.width, size.height, width, height)) {
+            largest_bitmap = std::max(largest_bitmap, (uint64_t)width * height * 4);
+        }
     }
+    encoder_count = background_worker_count(page_indices.size());
+    queue_capacity = encoder_count * 2;
+    if (available > 0 && largest_bitmap > 0) {
+        uint64_t fitting = available / largest_bitmap;
+        size_t in_flight = (size_t)std::min<uint64_t>(fitting, encoder_count + queue_capacity + 1);
+        encoder_count = std::max<size_t>(1, std::min(encoder_count, in_flight / 2));
+        queue_capacity = in_flight > encoder_count + 2 ? in_flight - encoder_count - 1 : 1;
+    }
+}
 
-    // Get params from the map
-    const char* input_path = fl_value_get_string(fl_value_lookup_string(args, "path"));
-
+// Reads the page size and image format arguments of createImageFromPDF and
+// createImageFromPDFToBytes. Returns an error response if any is invalid.
+static FlMethodResponse* image_options(FlValue* args, RenderSize& render_size, ImageFormat& format, int& compression) {
     // Get width (String)
     FlValue* max_width_value = fl_value_lookup_string(args, "width");
     if (!max_width_value || fl_value_get_type(max_width_value) != FL_VALUE_TYPE_INT) {
@@ -382,6 +1071,22 @@ FlMethodResponse* create_image_from_pdf(FlValue* args) {
     // Cast height to C-int
     int64_t max_height = fl_value_get_int(max_height_value);
 
+    // Pixels per point and pixel budgets, width and height win over them
+    render_size = RenderSize();
+    double dpi = double_argument(args, "dpi", 0);
+    double scale = double_argument(args, "scale", 0);
+    render_size.max_width = (int)std::min<int64_t>(int_argument(args, "maxWidth", 0), INT_MAX);
+    render_size.max_height = (int)std::min<int64_t>(int_argument(args, "maxHeight", 0), INT_MAX);
+    render_size.max_pixels = int_argument(args, "maxPixels", 0);
+    if (dpi < 0 || scale < 0 || max_width < 0 || max_height < 0 || max_width > INT_MAX || max_height > INT_MAX ||
+        render_size.max_width < 0 || render_size.max_height < 0 || render_size.max_pixels < 0) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "invalid_arguments", "dpi, scale, width, height and the max sizes cannot be negative", nullptr));
+    }
+    render_size.scale = dpi > 0 ? dpi / 72 : scale > 0 ? scale : 1;
+    render_size.fixed_width = (int)max_width;
+    render_size.fixed_height = (int)max_height;
+
     // Get compression (String)
     FlValue* compression_value = fl_value_lookup_string(args, "compression");
     if (!compression_value || fl_value_get_type(compression_value) != FL_VALUE_TYPE_INT) {
@@ -389,7 +1094,34 @@ FlMethodResponse* create_image_from_pdf(FlValue* args) {
     }
 
     // Cast height to C-int
-    int compression = (int)fl_value_get_int(compression_value);
+    compression = (int)fl_value_get_int(compression_value);
+
+    // PNG, or the format in "outputFormat" (see parse_image_format)
+    format = ImageFormat::kPng;
+    FlValue* format_value = fl_value_lookup_string(args, "outputFormat");
+    if (format_value && (fl_value_get_type(format_value) != FL_VALUE_TYPE_STRING ||
+                         !parse_image_format(fl_value_get_string(format_value), format))) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "invalid_arguments", "outputFormat must be png, jpeg, bgra, ppm or pgm", nullptr));
+    }
+    return nullptr;
+}
+
+FlMethodResponse* create_image_from_pdf(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "invalid_arguments", "Expected a map with inputPath, outputDirPath, width, height, compression and createOneImage keys", nullptr));
+    }
+
+    // Get params from the map
+    const char* input_path = fl_value_get_string(fl_value_lookup_string(args, "path"));
+
+    RenderSize render_size;
+    ImageFormat format;
+    int compression;
+    if (FlMethodResponse* error = image_options(args, render_size, format, compression)) {
+        return error;
+    }
 
     const char* output_path = fl_value_get_string(fl_value_lookup_string(args, "outputDirPath"));
     if (!input_path || !output_path) {
@@ -397,8 +1129,12 @@ FlMethodResponse* create_image_from_pdf(FlValue* args) {
                 "invalid_arguments", "Missing path or outputDirPath", nullptr));
     }
 
-    // Load the PDF document
-    FPDF_DOCUMENT doc = FPDF_LoadDocument(input_path, nullptr);
+    // Reports every written page, declared first so the encoders stop before it
+    ProgressReporter progress("createImageFromPDF", progress_job_id(args), 1, progress_hub().Listener());
+
+    // Load the PDF document, the mapping must outlive it
+    std::unique_ptr<MappedFile> mapped_file;
+    FPDF_DOCUMENT doc = load_input_file(input_path, mapped_file);
     if (!doc) {
         return FL_METHOD_RESPONSE(fl_method_error_response_new(
                 "document_loading_failed", "Failed to load PDF document", nullptr));
@@ -406,17 +1142,22 @@ FlMethodResponse* create_image_from_pdf(FlValue* args) {
 
     int page_count = FPDF_GetPageCount(doc);
     if (page_count < 1) {
-        FPDF_CloseDocument(doc);
+        close_input_document(doc);
         return FL_METHOD_RESPONSE(fl_method_error_response_new(
                 "empty_pdf", "The PDF document is empty", nullptr));
     }
+    progress.AddPages(page_count);
 
-    FlValue* result = fl_value_new_list();
+    g_autoptr(FlValue) result = fl_value_new_list();
 
+    // Set by cancel(jobId), checked while rendering
+    JobRegistry::CancelFlag cancel_flag = find_cancel_flag(args);
+    const std::atomic<bool>* cancelled = cancel_flag.get();
 
     // Get createOneImage (Bool)
     FlValue* create_one_image_value = fl_value_lookup_string(args, "createOneImage");
     if (!create_one_image_value || fl_value_get_type(create_one_image_value) != FL_VALUE_TYPE_BOOL) {
+        close_input_document(doc);
         return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "createOneImage must be a boolean", nullptr));
     }
 
@@ -428,121 +1169,570 @@ FlMethodResponse* create_image_from_pdf(FlValue* args) {
         int total_height = 0;
 
         // First, calculate the total width and height for the combined image
-        std::vector<FPDF_PAGE> pages(page_count);
-        std::vector<double> page_widths(page_count);
-        std::vector<double> page_heights(page_count);
+        // without loading the pages
+        std::vector<int> page_widths(page_count, 0);
+        std::vector<int> page_heights(page_count, 0);
 
+        int strip_height = 0;
         for (int i = 0; i < page_count; ++i) {
-            FPDF_PAGE page = FPDF_LoadPage(doc, i);
-            if (!page) continue;
-
-            // Get the size of the page
-            double width = FPDF_GetPageWidth(page);
-            double height = FPDF_GetPageHeight(page);
-
-            if (max_width != 0 || max_height != 0) {
-                width = (double)max_width;
-                height = (double)max_height;
-            }
+            FS_SIZEF size;
+            int width, height;
+            if (!FPDF_GetPageSizeByIndexF(doc, i, &size) ||
+                !render_size.PageSize(size.width, size.height, width, height)) continue;
 
-            pages[i] = page;
             page_widths[i] = width;
             page_heights[i] = height;
 
-            total_width = std::max(total_width, (int)width); // Use the max width
-            total_height += (int)height; // Sum the heights for vertical layout
+            total_width = std::max(total_width, width); // Use the max width
+            strip_height = std::max(strip_height, height);
+            if (total_height > INT_MAX - height) {
+                total_height = -1;
+                break;
+            }
+            total_height += height; // Sum the heights for vertical layout
         }
 
-        // Create a bitmap large enough to hold all pages vertically
-        FPDF_BITMAP combined_bitmap = FPDFBitmap_Create(total_width, total_height, 0xFFFFFFFF);
-        if (!combined_bitmap) {
-            FPDF_CloseDocument(doc);
+        if (total_width <= 0 || total_height <= 0) {
+            close_input_document(doc);
             return FL_METHOD_RESPONSE(fl_method_error_response_new(
                     "bitmap_creation_failed", "Failed to create combined bitmap", nullptr));
         }
 
-        int current_y = 0;
+        if (format == ImageFormat::kJpeg && (total_width > 65535 || total_height > 65535)) {
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                    "bitmap_too_large", "A JPEG image cannot be larger than 65535 pixels", nullptr));
+        }
 
-        // Render each page into the large combined image
-        for (int i = 0; i < page_count; ++i) {
-            FPDF_PAGE page = pages[i];
+        // Only the strip of the tallest page is held at once, but a JPEG keeps
+        // every row until it is encoded
+        if (!bitmaps_fit_in_memory(total_width, format == ImageFormat::kJpeg ? total_height : strip_height, 1,
+                                   available_memory())) {
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                    "bitmap_too_large", "Not enough memory to render the pages at this size", nullptr));
+        }
 
-            // Render the page into the combined bitmap at the correct position
-            FPDF_RenderPageBitmap(combined_bitmap, page, 0, current_y, (int)page_widths[i], (int)page_heights[i], 0, FPDF_ANNOT);
-            current_y += (int)page_heights[i]; // Move the y position down for the next page
+        // The pages are stacked vertically and streamed to the encoder one at
+        // a time, so only one page is ever held in memory
+        std::string output_image_path =
+                image_file_name(std::string(output_path) + "/image", format, total_width, total_height);
+        ImageWriter writer(output_image_path, total_width, total_height, format, compression);
+
+        // Strip buffer reused by every page, as wide as the combined image
+        int stride = total_width * 4;
+        std::vector<uint8_t> strip;
+
+        bool saved = writer.ok();
+        uint64_t bytes_reported = 0;
+        for (int i = 0; i < page_count && saved; ++i) {
+            int height = page_heights[i];
+            if (height <= 0) {
+                progress.Advance(1);
+                continue;
+            }
+
+            // Clear the strip, the area right of narrower pages stays transparent
+            strip.assign((size_t)stride * height, 0);
+
+            // Render the page into the strip
+            FPDF_PAGE page = FPDF_LoadPage(doc, i);
+            if (page) {
+                FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(total_width, height, FPDFBitmap_BGRA, strip.data(), stride);
+                if (!bitmap) {
+                    FPDF_ClosePage(page);
+                    close_input_document(doc);
+                    return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                            "bitmap_creation_failed", "Failed to create combined bitmap", nullptr));
+                }
+                render_page_progressive(bitmap, page, 0, 0, page_widths[i], height, FPDF_ANNOT, cancelled);
+                FPDFBitmap_Destroy(bitmap);
+                FPDF_ClosePage(page);
+            }
+
+            if (cancelled && cancelled->load()) {
+                writer.Abort();
+                remove(output_image_path.c_str());
+                close_input_document(doc);
+                return cancelled_response();
+            }
+
+            saved = writer.WriteRows(strip.data(), height, stride);
+            progress.Advance(1, writer.bytes_written() - bytes_reported);
+            bytes_reported = writer.bytes_written();
         }
+        strip = std::vector<uint8_t>();
 
-        // Save the combined bitmap to a PNG file
-        std::string output_image_path = std::string(output_path) + "/image.png";
-        if (!save_bitmap_to_png(combined_bitmap, output_image_path, compression)) {
-            FPDFBitmap_Destroy(combined_bitmap);
-            FPDF_CloseDocument(doc);
+        // Save the combined image
+        if (!saved || !writer.Finish()) {
+            remove(output_image_path.c_str());
+            close_input_document(doc);
             return FL_METHOD_RESPONSE(fl_method_error_response_new(
                     "image_save_failed", "Failed to save combined image", nullptr));
         }
+        progress.Advance(0, writer.bytes_written() - bytes_reported);
 
         // Add the combined image path to the result list
-        FlValue* image_path_value = fl_value_new_string(output_image_path.c_str());
-        fl_value_append(result, image_path_value);
-
-        // Clean up resources
-        FPDFBitmap_Destroy(combined_bitmap);
-        for (int i = 0; i < page_count; ++i) {
-            FPDF_ClosePage(pages[i]);
-        }
+        fl_value_append_take(result, fl_value_new_string(output_image_path.c_str()));
     } else {
+        // Pages are rendered here one by one, while the encoder threads write
+        // the previous ones
+        uint64_t available = available_memory();
+        std::vector<int> page_indices(page_count);
+        for (int i = 0; i < page_count; ++i) page_indices[i] = i;
+        size_t encoder_count, queue_capacity;
+        size_page_encoder(doc, page_indices, render_size, available, encoder_count, queue_capacity);
+        PageEncoder encoder(encoder_count, queue_capacity, format, compression, &progress);
+
         for (int i = 0; i < page_count; ++i) {
             FPDF_PAGE page = FPDF_LoadPage(doc, i);
-            if (!page) continue;
+            if (!page) {
+                progress.Advance(1);
+                continue;
+            }
 
-            int width, height;
-            if (max_width != 0 || max_height != 0) {
-                width = max_width;
-                height = max_height;
-            } else {
-                // Get the size of the page
-                width = (int)FPDF_GetPageWidth(page);
-                height = (int)FPDF_GetPageHeight(page);
+            int width = 0, height = 0;
+            render_size.PageSize(FPDF_GetPageWidthF(page), FPDF_GetPageHeightF(page), width, height);
+
+            // Checked before allocating, a failed allocation would abort
+            if (!bitmaps_fit_in_memory(width, height, 1, available)) {
+                FPDF_ClosePage(page);
+                encoder.Cancel();
+                for (size_t j = 0; j < fl_value_get_length(result); ++j) {
+                    remove(fl_value_get_string(fl_value_get_list_value(result, j)));
+                }
+                close_input_document(doc);
+                return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                        "bitmap_too_large", "Not enough memory to render the pages at this size", nullptr));
             }
 
-            // Create a bitmap of the appropriate size
-            FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0xFFFFFFFF);
+            // Create a bitmap over a buffer owned by the encode job
+            EncodeJob job;
+            job.width = width;
+            job.height = height;
+            FPDF_BITMAP bitmap = nullptr;
+            if (width > 0 && height > 0) {
+                job.bgra.resize((size_t)width * height * 4);
+                bitmap = FPDFBitmap_CreateEx(width, height, FPDFBitmap_BGRA, job.bgra.data(), width * 4);
+            }
             if (!bitmap) {
                 FPDF_ClosePage(page);
-                FPDF_CloseDocument(doc);
+                encoder.Cancel();
+                for (size_t j = 0; j < fl_value_get_length(result); ++j) {
+                    remove(fl_value_get_string(fl_value_get_list_value(result, j)));
+                }
+                close_input_document(doc);
                 return FL_METHOD_RESPONSE(fl_method_error_response_new(
                         "bitmap_creation_failed", "Failed to create bitmap", nullptr));
             }
 
             // Render the page into the bitmap
-            FPDF_RenderPageBitmap(bitmap, page, 0, 0, (int)width, (int)height, 0, FPDF_ANNOT);
+            render_page_progressive(bitmap, page, 0, 0, (int)width, (int)height, FPDF_ANNOT, cancelled);
 
-            // Save the bitmap to a PNG file
-            std::string output_image_path = std::string(output_path) + "/image_" + std::to_string(i+1) + ".png";
-            if (!save_bitmap_to_png(bitmap, output_image_path, compression)) {
-                FPDF_ClosePage(page);
-                FPDF_CloseDocument(doc);
-                return FL_METHOD_RESPONSE(fl_method_error_response_new(
-                        "image_save_failed", "Failed to save image", nullptr));
+            // Clean resources, the pixels stay in the job
+            FPDFBitmap_Destroy(bitmap);
+            FPDF_ClosePage(page);
+
+            // Stop here and remove the pages already written
+            if (cancelled && cancelled->load()) {
+                encoder.Cancel();
+                for (size_t j = 0; j < fl_value_get_length(result); ++j) {
+                    remove(fl_value_get_string(fl_value_get_list_value(result, j)));
+                }
+                close_input_document(doc);
+                return cancelled_response();
             }
 
-            // Add the image path to the result list
-            FlValue* image_path_value = fl_value_new_string(output_image_path.c_str());
-            fl_value_append(result, image_path_value);
+            // Queue the page to be saved as a PNG file
+            job.output_path = image_file_name(std::string(output_path) + "/image_" + std::to_string(i+1), format, width, height);
+            fl_value_append_take(result, fl_value_new_string(job.output_path.c_str()));
+            if (!encoder.Submit(std::move(job))) break;
+        }
 
-            // Clean resources
-            FPDFBitmap_Destroy(bitmap);
+        if (!encoder.Finish()) {
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                    "image_save_failed", "Failed to save image", nullptr));
+        }
+    }
+
+    close_input_document(doc);
+    progress.DocumentDone();
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Renders pages like create_image_from_pdf, but returns them in the response
+// instead of writing files: a map per page with its 1-based "page", "width",
+// "height", "format" and encoded "bytes". Raw "bgra" pages skip the encoders:
+// their bytes are the rendered buffer, with a "stride" of width * 4.
+FlMethodResponse* create_image_from_pdf_to_bytes(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "invalid_arguments", "Expected a map with path, width, height and compression keys", nullptr));
+    }
+
+    FlValue* path_value = fl_value_lookup_string(args, "path");
+    if (!path_value || fl_value_get_type(path_value) != FL_VALUE_TYPE_STRING) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Missing path", nullptr));
+    }
+    const char* input_path = fl_value_get_string(path_value);
+
+    RenderSize render_size;
+    ImageFormat format;
+    int compression;
+    if (FlMethodResponse* error = image_options(args, render_size, format, compression)) {
+        return error;
+    }
+
+    // Reports every encoded page, declared first so the encoders stop before it
+    ProgressReporter progress("createImageFromPDFToBytes", progress_job_id(args), 1, progress_hub().Listener());
+
+    // Load the PDF document, the mapping must outlive it
+    std::unique_ptr<MappedFile> mapped_file;
+    FPDF_DOCUMENT doc = load_input_file(input_path, mapped_file);
+    if (!doc) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "document_loading_failed", "Failed to load PDF document", nullptr));
+    }
+
+    // All the pages, or the selection in "pages" (see parse_page_range)
+    int page_count = FPDF_GetPageCount(doc);
+    std::vector<int> page_indices;
+    FlValue* pages_value = fl_value_lookup_string(args, "pages");
+    if (pages_value && fl_value_get_type(pages_value) == FL_VALUE_TYPE_STRING) {
+        std::string range = fl_value_get_string(pages_value);
+        if (!parse_page_range(range, page_count, page_indices)) {
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_page_range", ("Invalid page range \"" + range + "\" for document: " + input_path).c_str(), nullptr));
+        }
+    } else {
+        for (int i = 0; i < page_count; ++i) page_indices.push_back(i);
+    }
+    if (page_indices.empty()) {
+        close_input_document(doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "empty_pdf", "The PDF document is empty", nullptr));
+    }
+    progress.AddPages((int)page_indices.size());
+
+    // Set by cancel(jobId), checked while rendering
+    JobRegistry::CancelFlag cancel_flag = find_cancel_flag(args);
+    const std::atomic<bool>* cancelled = cancel_flag.get();
+
+    // The pages stay in memory until the response is built, so the raw pixels
+    // and the encoded images count against the available memory
+    struct RenderedPage {
+        int index = 0;
+        int width = 0;
+        int height = 0;
+        std::vector<uint8_t> bytes;
+    };
+    std::vector<RenderedPage> pages(page_indices.size());
+    uint64_t available = available_memory();
+    uint64_t held = 0;  // raw pages kept for the response
+
+    size_t encoder_count, queue_capacity;
+    size_page_encoder(doc, page_indices, render_size, available, encoder_count, queue_capacity);
+    std::unique_ptr<PageEncoder> encoder;
+    if (format != ImageFormat::kBgra) {
+        encoder.reset(new PageEncoder(encoder_count, queue_capacity, format, compression, &progress));
+    }
+
+    for (size_t k = 0; k < page_indices.size(); ++k) {
+        RenderedPage& rendered = pages[k];
+        rendered.index = page_indices[k];
+        FPDF_PAGE page = FPDF_LoadPage(doc, rendered.index);
+        if (!page) {
+            if (encoder) encoder->Cancel();
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                    "page_loading_failed", ("Failed to load page " + std::to_string(rendered.index + 1)).c_str(), nullptr));
+        }
+
+        EncodeJob job;
+        render_size.PageSize(FPDF_GetPageWidthF(page), FPDF_GetPageHeightF(page), job.width, job.height);
+        uint64_t in_use = held + (encoder ? encoder->output_bytes() : 0);
+        uint64_t room = available == 0 ? 0 : available > in_use ? available - in_use : 1;
+        FPDF_BITMAP bitmap = nullptr;
+        if (job.width > 0 && job.height > 0 && bitmaps_fit_in_memory(job.width, job.height, 1, room)) {
+            job.bgra.resize((size_t)job.width * job.height * 4);
+            bitmap = FPDFBitmap_CreateEx(job.width, job.height, FPDFBitmap_BGRA, job.bgra.data(), job.width * 4);
+        }
+        if (!bitmap) {
             FPDF_ClosePage(page);
+            if (encoder) encoder->Cancel();
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                    "bitmap_too_large", "Not enough memory to render the pages at this size", nullptr));
+        }
+        render_page_progressive(bitmap, page, 0, 0, job.width, job.height, FPDF_ANNOT, cancelled);
+        FPDFBitmap_Destroy(bitmap);
+        FPDF_ClosePage(page);
+
+        if (cancelled && cancelled->load()) {
+            if (encoder) encoder->Cancel();
+            close_input_document(doc);
+            return cancelled_response();
+        }
+
+        rendered.width = job.width;
+        rendered.height = job.height;
+        if (!encoder) {
+            // Raw pixels are the result as rendered
+            held += job.bgra.size();
+            progress.Advance(1, job.bgra.size());
+            rendered.bytes = std::move(job.bgra);
+            continue;
+        }
+        job.output = &rendered.bytes;
+        if (!encoder->Submit(std::move(job))) break;
+    }
+
+    if (encoder && !encoder->Finish()) {
+        close_input_document(doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new(
+                "image_encode_failed", "Failed to encode image", nullptr));
+    }
+    close_input_document(doc);
+
+    g_autoptr(FlValue) result = fl_value_new_list();
+    for (RenderedPage& rendered : pages) {
+        FlValue* item = fl_value_new_map();
+        fl_value_set_string_take(item, "page", fl_value_new_int(rendered.index + 1));
+        fl_value_set_string_take(item, "width", fl_value_new_int(rendered.width));
+        fl_value_set_string_take(item, "height", fl_value_new_int(rendered.height));
+        fl_value_set_string_take(item, "format", fl_value_new_string(image_format_name(format)));
+        if (format == ImageFormat::kBgra) {
+            fl_value_set_string_take(item, "stride", fl_value_new_int(rendered.width * 4));
+        }
+        fl_value_set_string_take(item, "bytes", fl_value_new_uint8_list(rendered.bytes.data(), rendered.bytes.size()));
+        rendered.bytes = std::vector<uint8_t>();  // release each page once copied
+        fl_value_append_take(result, item);
+    }
+    progress.DocumentDone();
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// Writes a small PNG per page: the thumbnail stored in the PDF when the page
+// has one, which costs no rendering, or else the page rendered to fit
+// `maxSize`. Pages are encoded on background threads like in
+// create_image_from_pdf.
+FlMethodResponse* create_thumbnails_from_pdf(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with path, outputDirPath and maxSize", nullptr));
+    }
+    FlValue* input_path_value = fl_value_lookup_string(args, "path");
+    FlValue* output_path_value = fl_value_lookup_string(args, "outputDirPath");
+    if (!input_path_value || fl_value_get_type(input_path_value) != FL_VALUE_TYPE_STRING ||
+        !output_path_value || fl_value_get_type(output_path_value) != FL_VALUE_TYPE_STRING) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Missing path or outputDirPath", nullptr));
+    }
+    const char* input_path = fl_value_get_string(input_path_value);
+    std::string output_path = fl_value_get_string(output_path_value);
+    int max_size = (int)int_argument(args, "maxSize", 0);
+    if (max_size <= 0) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "maxSize must be a positive int", nullptr));
+    }
+    int compression = (int)int_argument(args, "compression", 0);
+
+    // Reports every written page, declared first so the encoders stop before it
+    ProgressReporter progress("createThumbnailsFromPDF", progress_job_id(args), 1, progress_hub().Listener());
+
+    std::unique_ptr<MappedFile> mapped_file;
+    FPDF_DOCUMENT doc = load_input_file(input_path, mapped_file);
+    if (!doc) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("document_loading_failed", "Failed to load PDF document", nullptr));
+    }
+
+    // All the pages, or the selection in "pages" (see parse_page_range)
+    int page_count = FPDF_GetPageCount(doc);
+    std::vector<int> page_indices;
+    FlValue* pages_value = fl_value_lookup_string(args, "pages");
+    if (pages_value && fl_value_get_type(pages_value) == FL_VALUE_TYPE_STRING) {
+        std::string range = fl_value_get_string(pages_value);
+        if (!parse_page_range(range, page_count, page_indices)) {
+            close_input_document(doc);
+            return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_page_range", ("Invalid page range \"" + range + "\" for document: " + input_path).c_str(), nullptr));
+        }
+    }
+    if (page_indices.empty()) {
+        for (int i = 0; i < page_count; ++i) page_indices.push_back(i);
+    }
+    if (page_indices.empty()) {
+        close_input_document(doc);
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("empty_pdf", "The PDF document is empty", nullptr));
+    }
+    progress.AddPages((int)page_indices.size());
+
+    JobRegistry::CancelFlag cancel_flag = find_cancel_flag(args);
+    const std::atomic<bool>* cancelled = cancel_flag.get();
+
+    g_autoptr(FlValue) result = fl_value_new_list();
+    size_t encoder_count = background_worker_count(page_indices.size());
+    PageEncoder encoder(encoder_count, encoder_count * 2, ImageFormat::kPng, compression, &progress);
+    for (int index : page_indices) {
+        FPDF_PAGE page = FPDF_LoadPage(doc, index);
+        if (!page) {
+            progress.Advance(1);
+            continue;
         }
+
+        EncodeJob job;
+        if (!read_embedded_thumbnail(page, max_size, job.width, job.height, job.bgra)) {
+            // Rendered on white, as stored thumbnails are opaque
+            fit_thumbnail_size(FPDF_GetPageWidthF(page), FPDF_GetPageHeightF(page), max_size, job.width, job.height);
+            job.bgra.resize((size_t)job.width * job.height * 4);
+            FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(job.width, job.height, FPDFBitmap_BGRA, job.bgra.data(), job.width * 4);
+            if (!bitmap) {
+                FPDF_ClosePage(page);
+                encoder.Cancel();
+                for (size_t j = 0; j < fl_value_get_length(result); ++j) {
+                    remove(fl_value_get_string(fl_value_get_list_value(result, j)));
+                }
+                close_input_document(doc);
+                return FL_METHOD_RESPONSE(fl_method_error_response_new("bitmap_creation_failed", "Failed to create bitmap", nullptr));
+            }
+            FPDFBitmap_FillRect(bitmap, 0, 0, job.width, job.height, 0xFFFFFFFF);
+            render_page_progressive(bitmap, page, 0, 0, job.width, job.height, FPDF_ANNOT, cancelled);
+            FPDFBitmap_Destroy(bitmap);
+        }
+        FPDF_ClosePage(page);
+
+        // Stop here and remove the thumbnails already written
+        if (cancelled && cancelled->load()) {
+            encoder.Cancel();
+            for (size_t j = 0; j < fl_value_get_length(result); ++j) {
+                remove(fl_value_get_string(fl_value_get_list_value(result, j)));
+            }
+            close_input_document(doc);
+            return cancelled_response();
+        }
+
+        job.output_path = output_path + "/thumbnail_" + std::to_string(index + 1) + ".png";
+        fl_value_append_take(result, fl_value_new_string(job.output_path.c_str()));
+        if (!encoder.Submit(std::move(job))) break;
     }
+    close_input_document(doc);
 
-    FPDF_CloseDocument(doc);
+    if (!encoder.Finish()) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("image_save_failed", "Failed to save image", nullptr));
+    }
+    progress.DocumentDone();
     return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
 }
 
+FlMethodResponse* configure_document_cache(FlValue* args) {
+    if (fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Expected a map with maxDocuments and maxBytes", nullptr));
+    }
+    if (!shared_documents) {
+        g_autoptr(FlValue) result = fl_value_new_bool(false);
+        return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    }
+    int64_t max_documents = int_argument(args, "maxDocuments", DocumentCache::kDefaultMaxDocuments);
+    int64_t max_bytes = int_argument(args, "maxBytes", DocumentCache::kDefaultMaxBytes);
+    shared_documents->SetBudget((size_t)std::max<int64_t>(0, max_documents), (uint64_t)std::max<int64_t>(0, max_bytes));
+    g_autoptr(FlValue) result = fl_value_new_bool(true);
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+}
+
+// The result of one job of a batch: {"success": true, "result": ...} or
+// {"success": false, "code": ..., "message": ..., "details": ...}.
+static FlValue* batch_job_result(FlMethodResponse* response) {
+    FlValue* value = fl_value_new_map();
+    if (FL_IS_METHOD_SUCCESS_RESPONSE(response)) {
+        fl_value_set_string_take(value, "success", fl_value_new_bool(true));
+        FlValue* result = fl_method_success_response_get_result(FL_METHOD_SUCCESS_RESPONSE(response));
+        fl_value_set_string_take(value, "result", result ? fl_value_ref(result) : fl_value_new_null());
+        return value;
+    }
+    fl_value_set_string_take(value, "success", fl_value_new_bool(false));
+    if (FL_IS_METHOD_ERROR_RESPONSE(response)) {
+        FlMethodErrorResponse* error = FL_METHOD_ERROR_RESPONSE(response);
+        const gchar* message = fl_method_error_response_get_message(error);
+        FlValue* details = fl_method_error_response_get_details(error);
+        fl_value_set_string_take(value, "code", fl_value_new_string(fl_method_error_response_get_code(error)));
+        if (message) fl_value_set_string_take(value, "message", fl_value_new_string(message));
+        if (details) fl_value_set_string(value, "details", details);
+    } else {
+        fl_value_set_string_take(value, "code", fl_value_new_string("not_implemented"));
+    }
+    return value;
+}
+
+// Runs one job of a batch ({"method": ..., "arguments": {...}}) unless the
+// batch was cancelled.
+static FlMethodResponse* run_batch_job(FlValue* job, const JobRegistry::CancelFlag& batch_cancelled) {
+    FlValue* method = job && fl_value_get_type(job) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(job, "method") : nullptr;
+    FlValue* arguments = method ? fl_value_lookup_string(job, "arguments") : nullptr;
+    if (!method || fl_value_get_type(method) != FL_VALUE_TYPE_STRING || !arguments) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "Each job must be a map with a method and its arguments", nullptr));
+    }
+    MethodHandler handler = find_method_handler(fl_value_get_string(method));
+    if (!handler || handler == run_batch) {
+        return FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    }
+    JobRegistry::CancelFlag cancelled = find_cancel_flag(arguments);
+    if ((batch_cancelled && batch_cancelled->load()) || (cancelled && cancelled->load())) {
+        return cancelled_response();
+    }
+    return handler(arguments);
+}
+
+FlMethodResponse* run_batch(FlValue* args) {
+    FlValue* jobs = fl_value_get_type(args) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(args, "jobs") : nullptr;
+    if (!jobs || fl_value_get_type(jobs) != FL_VALUE_TYPE_LIST) {
+        return FL_METHOD_RESPONSE(fl_method_error_response_new("invalid_arguments", "jobs must be a list", nullptr));
+    }
+    size_t job_count = fl_value_get_length(jobs);
+
+    // The jobs can be cancelled one by one from the start, like queued calls
+    std::vector<std::string> job_ids;  // registered here
+    for (size_t i = 0; i < job_count; ++i) {
+        FlValue* job = fl_value_get_list_value(jobs, i);
+        FlValue* arguments = fl_value_get_type(job) == FL_VALUE_TYPE_MAP ? fl_value_lookup_string(job, "arguments") : nullptr;
+        const gchar* job_id = get_job_id(arguments);
+        if (job_id && !job_registry().Find(job_id)) {
+            job_registry().Register(job_id);
+            job_ids.push_back(job_id);
+        }
+    }
+
+    // Every job reports its own progress, the batch one job per document
+    ProgressReporter progress("runBatch", progress_job_id(args), (int)job_count, progress_hub().Listener());
+    JobRegistry::CancelFlag cancelled = find_cancel_flag(args);
+
+    // Inputs are shared by the jobs even with the plugin's cache disabled
+    DocumentCache* previous_documents = shared_documents;
+    DocumentCache batch_documents;
+    if (!shared_documents || !shared_documents->Enabled()) shared_documents = &batch_documents;
+    g_autoptr(FlValue) results = fl_value_new_list();
+    for (size_t i = 0; i < job_count; ++i) {
+        FlValue* job = fl_value_get_list_value(jobs, i);
+        g_autoptr(FlMethodResponse) response = run_batch_job(job, cancelled);
+        fl_value_append_take(results, batch_job_result(response));
+        progress.DocumentDone();
+    }
+    shared_documents = previous_documents;
+    for (const std::string& job_id : job_ids) job_registry().Unregister(job_id);
+
+    return FL_METHOD_RESPONSE(fl_method_success_response_new(results));
+}
+
 static void pdf_combiner_plugin_dispose(GObject* object) {
+  PdfCombinerPlugin* self = PDF_COMBINER_PLUGIN(object);
+  // Dispose can run more than once, only the first pass owns the library.
+  if (self->worker_pool) {
+    delete self->worker_pool; // Waits for the running jobs
+    self->worker_pool = nullptr;
+    shared_documents = nullptr;
+    delete self->document_cache; // Closes the cached documents
+    self->document_cache = nullptr;
+    FPDF_DestroyLibrary(); // Destroy the FPDF library
+  }
+  progress_hub().SetListener(nullptr);
+  g_clear_object(&self->progress_channel);
   G_OBJECT_CLASS(pdf_combiner_plugin_parent_class)->dispose(object);
-  FPDF_DestroyLibrary(); // Destroy the FPDF library
 }
 
 static void pdf_combiner_plugin_class_init(PdfCombinerPluginClass* klass) {
@@ -551,6 +1741,11 @@ static void pdf_combiner_plugin_class_init(PdfCombinerPluginClass* klass) {
 
 static void pdf_combiner_plugin_init(PdfCombinerPlugin* self) {
   FPDF_InitLibrary(); // Initialize the FPDF library
+  self->worker_pool = new WorkerPool(kWorkerCount, kQueueCapacity);
+
+  // Input documents stay open between calls, see DocumentCache
+  self->document_cache = new DocumentCache();
+  shared_documents = self->document_cache;
 }
 
 static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call, gpointer user_data) {
@@ -571,5 +1766,13 @@ void pdf_combiner_plugin_register_with_registrar(FlPluginRegistrar* registrar) {
                                             g_object_ref(plugin),
                                             g_object_unref);
 
+  // Progress of the running jobs, see ProgressReporter
+  plugin->progress_channel =
+      fl_event_channel_new(fl_plugin_registrar_get_messenger(registrar),
+                           "pdf_combiner/progress",
+                           FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->progress_channel, progress_listen_cb,
+                                       progress_cancel_cb, nullptr, nullptr);
+
   g_object_unref(plugin);
 }
@@ -8,5 +8,10 @@
 
 // Handles the getPlatformVersion method call.
 FlMethodResponse *merge_multiple_pdfs(FlValue *args);
+FlMethodResponse *merge_multiple_pdfs_to_bytes(FlValue *args);
 FlMethodResponse *create_pdf_from_multiple_images(FlValue *args);
 FlMethodResponse *create_image_from_pdf(FlValue *args);
+FlMethodResponse *create_image_from_pdf_to_bytes(FlValue *args);
+FlMethodResponse *create_thumbnails_from_pdf(FlValue *args);
+FlMethodResponse *run_batch(FlValue *args);
+FlMethodResponse *configure_document_cache(FlValue *args);
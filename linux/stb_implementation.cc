@@ -0,0 +1,8 @@
+// The stb single-file libraries, compiled once for the plugin. The headers in
+// include/pdf_combiner only declare them.
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "include/pdf_combiner/stb_image_write.h"
+#define STB_IMAGE_IMPLEMENTATION
+#include "include/pdf_combiner/stb_image.h"
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+#include "include/pdf_combiner/stb_image_resize2.h"
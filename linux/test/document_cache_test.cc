@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/document_cache.h"
+#include "include/pdf_combiner/my_file_write.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class DocumentCacheTest : public PdfiumTest {
+protected:
+    void TearDown() override {
+        for (const std::string& path : paths_) remove(path.c_str());
+    }
+
+    // Writes a PDF with `pages` pages to a new temporary file, or over `path`
+    std::string WriteDocument(int pages, std::string path = "") {
+        if (path.empty()) {
+            path = testing::TempDir() + "document_cache_" + std::to_string(getpid()) + "_" +
+                   std::to_string(paths_.size()) + ".pdf";
+            paths_.push_back(path);
+        }
+        FPDF_DOCUMENT doc = FPDF_CreateNewDocument();
+        for (int i = 0; i < pages; ++i) FPDF_ClosePage(FPDFPage_New(doc, i, 612, 792));
+        MyFileWrite file(path.c_str());
+        EXPECT_TRUE(FPDF_SaveAsCopy(doc, &file, FPDF_INCREMENTAL) && file.Commit());
+        FPDF_CloseDocument(doc);
+        return path;
+    }
+
+    std::vector<std::string> paths_;
+};
+
+}  // namespace
+
+TEST_F(DocumentCacheTest, OpensEachFileOnce) {
+    std::string first = WriteDocument(1);
+    std::string second = WriteDocument(2);
+    DocumentCache cache;
+    FPDF_DOCUMENT doc = cache.Open(first.c_str());
+    ASSERT_NE(doc, nullptr);
+    EXPECT_TRUE(cache.Owns(doc));
+    EXPECT_EQ(FPDF_GetPageCount(cache.Open(second.c_str())), 2);
+    EXPECT_EQ(cache.Open(first.c_str()), doc);
+    EXPECT_EQ(cache.Map(first.c_str())->size(), cache.Map(first.c_str())->size());
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_EQ(cache.Misses(), 2u);
+    EXPECT_EQ(cache.Hits(), 3u);
+    EXPECT_EQ(cache.FileOf(doc), cache.Map(first.c_str()));
+}
+
+TEST_F(DocumentCacheTest, ReloadsRewrittenFiles) {
+    std::string path = WriteDocument(1);
+    DocumentCache cache;
+    EXPECT_EQ(FPDF_GetPageCount(cache.Open(path.c_str())), 1);
+    WriteDocument(3, path);
+    EXPECT_EQ(FPDF_GetPageCount(cache.Open(path.c_str())), 3);
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_EQ(cache.Misses(), 2u);
+}
+
+TEST_F(DocumentCacheTest, EvictsTheLeastRecentlyUsedFile) {
+    std::string first = WriteDocument(1);
+    std::string second = WriteDocument(1);
+    std::string third = WriteDocument(1);
+    DocumentCache cache(2);
+    FPDF_DOCUMENT doc = cache.Open(first.c_str());
+    cache.Open(second.c_str());
+    cache.Open(first.c_str());
+    cache.Open(third.c_str());  // evicts `second`
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_TRUE(cache.Owns(doc));
+    cache.Open(second.c_str());
+    EXPECT_EQ(cache.Misses(), 4u);
+    EXPECT_EQ(cache.Evictions(), 2u);
+}
+
+TEST_F(DocumentCacheTest, StaysWithinTheByteBudget) {
+    std::string first = WriteDocument(1);
+    std::string second = WriteDocument(1);
+    DocumentCache cache;
+    ASSERT_NE(cache.Map(first.c_str()), nullptr);
+    uint64_t size = cache.Bytes();
+    cache.SetBudget(DocumentCache::kDefaultMaxDocuments, size + 1);
+    cache.Open(second.c_str());
+    EXPECT_EQ(cache.Size(), 1u);
+    EXPECT_LE(cache.Bytes(), size + 1);
+    EXPECT_EQ(cache.Evictions(), 1u);
+}
+
+TEST_F(DocumentCacheTest, IsDisabledWithoutDocuments) {
+    std::string path = WriteDocument(1);
+    DocumentCache cache;
+    ASSERT_NE(cache.Open(path.c_str()), nullptr);
+    cache.SetBudget(0, DocumentCache::kDefaultMaxBytes);
+    EXPECT_FALSE(cache.Enabled());
+    EXPECT_EQ(cache.Size(), 0u);
+    EXPECT_EQ(cache.Bytes(), 0u);
+    EXPECT_EQ(cache.Open(path.c_str()), nullptr);
+}
+
+TEST_F(DocumentCacheTest, FailsOnMissingFilesAndNonPdfs) {
+    std::string path = testing::TempDir() + "document_cache_not_a_pdf_" + std::to_string(getpid());
+    paths_.push_back(path);
+    FILE* file = fopen(path.c_str(), "w");
+    fputs("not a pdf", file);
+    fclose(file);
+    DocumentCache cache;
+    EXPECT_EQ(cache.Open(path.c_str()), nullptr);
+    EXPECT_NE(cache.Map(path.c_str()), nullptr);
+    EXPECT_EQ(cache.Open((path + ".missing").c_str()), nullptr);
+    EXPECT_FALSE(cache.Owns(nullptr));
+    EXPECT_EQ(cache.FileOf(nullptr), nullptr);
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
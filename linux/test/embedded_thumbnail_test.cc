@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/embedded_thumbnail.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class EmbeddedThumbnailTest : public PdfiumTest {
+protected:
+    // A one page PDF whose page has a `width` x `height` red /Thumb image, or
+    // none if `width` is 0.
+    static std::string MakeDocument(int width, int height) {
+        std::vector<std::string> objects = {
+                "<</Type/Catalog/Pages 2 0 R>>",
+                "<</Type/Pages/Kids[3 0 R]/Count 1>>",
+                "<</Type/Page/Parent 2 0 R/MediaBox[0 0 300 200]>>",
+        };
+        if (width > 0) {
+            std::string pixels;
+            for (int i = 0; i < width * height; ++i) pixels += std::string("\xff\x00\x00", 3);
+            objects[2] = "<</Type/Page/Parent 2 0 R/MediaBox[0 0 300 200]/Thumb 4 0 R>>";
+            objects.push_back("<</Width " + std::to_string(width) + "/Height " + std::to_string(height) +
+                              "/ColorSpace/DeviceRGB/BitsPerComponent 8/Length " + std::to_string(pixels.size()) +
+                              ">>stream\n" + pixels + "\nendstream");
+        }
+        return write_pdf(objects);
+    }
+
+    // Reads the thumbnail of the page of `pdf`
+    static bool Read(const std::string& pdf, int max_size, int& width, int& height, std::vector<uint8_t>& bgra) {
+        FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr);
+        EXPECT_NE(doc, nullptr);
+        if (!doc) return false;
+        FPDF_PAGE page = FPDF_LoadPage(doc, 0);
+        bool read = page && read_embedded_thumbnail(page, max_size, width, height, bgra);
+        if (page) FPDF_ClosePage(page);
+        FPDF_CloseDocument(doc);
+        return read;
+    }
+};
+
+}  // namespace
+
+TEST_F(EmbeddedThumbnailTest, ReadsTheStoredThumbnail) {
+    int width = 0, height = 0;
+    std::vector<uint8_t> bgra;
+    ASSERT_TRUE(Read(MakeDocument(4, 3), 128, width, height, bgra));
+    EXPECT_EQ(width, 4);
+    EXPECT_EQ(height, 3);
+    ASSERT_EQ(bgra.size(), 4u * 3 * 4);
+    EXPECT_EQ(std::vector<uint8_t>(bgra.begin(), bgra.begin() + 4), std::vector<uint8_t>({0, 0, 255, 255}));
+}
+
+TEST_F(EmbeddedThumbnailTest, ScalesDownLargeThumbnails) {
+    int width = 0, height = 0;
+    std::vector<uint8_t> bgra;
+    ASSERT_TRUE(Read(MakeDocument(40, 20), 10, width, height, bgra));
+    EXPECT_EQ(width, 10);
+    EXPECT_EQ(height, 5);
+    ASSERT_EQ(bgra.size(), 10u * 5 * 4);
+    EXPECT_EQ(bgra[2], 255);
+    EXPECT_EQ(bgra[3], 255);
+}
+
+TEST_F(EmbeddedThumbnailTest, FailsWithoutThumbnail) {
+    int width = 0, height = 0;
+    std::vector<uint8_t> bgra;
+    EXPECT_FALSE(Read(MakeDocument(0, 0), 128, width, height, bgra));
+}
+
+TEST_F(EmbeddedThumbnailTest, FitsPagesInTheMaxSize) {
+    int width = 0, height = 0;
+    fit_thumbnail_size(612, 792, 128, width, height);
+    EXPECT_EQ(width, 99);
+    EXPECT_EQ(height, 128);
+    fit_thumbnail_size(792, 612, 128, width, height);
+    EXPECT_EQ(width, 128);
+    EXPECT_EQ(height, 99);
+    fit_thumbnail_size(10000, 1, 128, width, height);
+    EXPECT_EQ(height, 1);
+    fit_thumbnail_size(0, 0, 128, width, height);
+    EXPECT_EQ(width, 1);
+    EXPECT_EQ(height, 1);
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
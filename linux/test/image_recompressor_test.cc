@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/image_recompressor.h"
+#include "include/pdf_combiner/my_file_write.h"
+#include "include/pdf_combiner/pdf_stream_merger.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class ImageRecompressorTest : public PdfiumTest {
+protected:
+    // A document with one page per entry of `alphas`, each showing the same
+    // `pixels` square photo-like image drawn `points` wide; where an alpha is
+    // below 255, the left half of that page's image has it.
+    static std::string MakeDocument(int pixels, int points, const std::vector<int>& alphas) {
+        FPDF_DOCUMENT doc = FPDF_CreateNewDocument();
+        for (size_t i = 0; i < alphas.size(); ++i) {
+            FPDF_PAGE page = FPDFPage_New(doc, (int)i, 612, 792);
+            FPDF_BITMAP bitmap = FPDFBitmap_Create(pixels, pixels, alphas[i] < 255 ? 1 : 0);
+            uint8_t* buffer = static_cast<uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+            int stride = FPDFBitmap_GetStride(bitmap);
+            for (int y = 0; y < pixels; ++y) {
+                for (int x = 0; x < pixels; ++x) {
+                    uint8_t* pixel = buffer + y * stride + x * 4;
+                    pixel[0] = (uint8_t)(x * 255 / pixels);
+                    pixel[1] = (uint8_t)(y * 255 / pixels);
+                    pixel[2] = (uint8_t)(128 + 127 * std::sin(x / 7.0 + y / 11.0));
+                    pixel[3] = x < pixels / 2 ? (uint8_t)alphas[i] : 255;
+                }
+            }
+            FPDF_PAGEOBJECT image = FPDFPageObj_NewImageObj(doc);
+            FPDFImageObj_SetBitmap(&page, 1, image, bitmap);
+            FPDFBitmap_Destroy(bitmap);
+            FPDFImageObj_SetMatrix(image, points, 0, 0, points, 100, 100);
+            FPDFPage_InsertObject(page, image);
+            FPDFPage_GenerateContent(page);
+            FPDF_ClosePage(page);
+        }
+        return save_document(doc);
+    }
+
+    // A one page document showing a `pixels` square DeviceGray image, stored
+    // uncompressed, drawn over the whole `points` wide page.
+    static std::string MakeGrayDocument(int pixels, int points) {
+        std::string data;
+        for (int y = 0; y < pixels; ++y) {
+            for (int x = 0; x < pixels; ++x) data += (char)(128 + 127 * std::sin(x / 7.0 + y / 11.0));
+        }
+        std::string size = std::to_string(pixels);
+        std::string draw = "q " + std::to_string(points) + " 0 0 " + std::to_string(points) + " 0 0 cm /Im0 Do Q";
+        return write_pdf({
+                "<</Type/Catalog/Pages 2 0 R>>",
+                "<</Type/Pages/Kids[3 0 R]/Count 1>>",
+                "<</Type/Page/Parent 2 0 R/MediaBox[0 0 " + std::to_string(points) + " " + std::to_string(points) +
+                        "]/Contents 4 0 R"
+                "/Resources<</XObject<</Im0 5 0 R>>>>>>",
+                "<</Length " + std::to_string(draw.size()) + ">>stream\n" + draw + "\nendstream",
+                "<</Type/XObject/Subtype/Image/Width " + size + "/Height " + size +
+                        "/ColorSpace/DeviceGray/BitsPerComponent 8/Length " + std::to_string(data.size()) +
+                        ">>stream\n" + data + "\nendstream",
+        });
+    }
+
+    // The first page of `pdf` rendered in gray at 72 dpi
+    static std::vector<uint8_t> RenderGray(const void* pdf, size_t size) {
+        std::vector<uint8_t> gray;
+        FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(pdf, size, nullptr);
+        if (!doc) return gray;
+        FPDF_PAGE page = FPDF_LoadPage(doc, 0);
+        int width = (int)FPDF_GetPageWidthF(page);
+        int height = (int)FPDF_GetPageHeightF(page);
+        FPDF_BITMAP bitmap = FPDFBitmap_Create(width, height, 0);
+        FPDFBitmap_FillRect(bitmap, 0, 0, width, height, 0xFFFFFFFF);
+        FPDF_RenderPageBitmap(bitmap, page, 0, 0, width, height, 0, 0);
+        const uint8_t* buffer = static_cast<const uint8_t*>(FPDFBitmap_GetBuffer(bitmap));
+        for (int y = 0; y < height; ++y) {
+            const uint8_t* row = buffer + (size_t)y * FPDFBitmap_GetStride(bitmap);
+            for (int x = 0; x < width; ++x) gray.push_back((uint8_t)((row[x * 4] + row[x * 4 + 1] + row[x * 4 + 2]) / 3));
+        }
+        FPDFBitmap_Destroy(bitmap);
+        FPDF_ClosePage(page);
+        FPDF_CloseDocument(doc);
+        return gray;
+    }
+
+    // Runs every pass of `images` over `pdf`, then merges it through them.
+    static std::vector<uint8_t> Recompress(ImageRecompressor& images, const std::string& pdf) {
+        FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr);
+        do {
+            EXPECT_TRUE(images.AddDocument(doc, {}, pdf.size()));
+        } while (images.NextPass());
+        FPDF_CloseDocument(doc);
+
+        MyMemoryWrite output;
+        PdfStreamMerger merger(&output);
+        merger.images = &images;
+        EXPECT_GT(merger.OpenInput((const uint8_t*)pdf.data(), pdf.size()), 0);
+        EXPECT_TRUE(merger.CopyPages({}));
+        EXPECT_TRUE(merger.Finish());
+        return output.data;
+    }
+
+    // The pixel width of the image on each page
+    static std::vector<int> ImageWidths(const std::vector<uint8_t>& pdf) {
+        std::vector<int> widths;
+        FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(pdf.data(), pdf.size(), nullptr);
+        if (!doc) return widths;
+        for (int i = 0; i < FPDF_GetPageCount(doc); ++i) {
+            FPDF_PAGE page = FPDF_LoadPage(doc, i);
+            FPDF_IMAGEOBJ_METADATA metadata;
+            FPDFImageObj_GetImageMetadata(FPDFPage_GetObject(page, 0), page, &metadata);
+            widths.push_back((int)metadata.width);
+            FPDF_ClosePage(page);
+        }
+        FPDF_CloseDocument(doc);
+        return widths;
+    }
+};
+
+}  // namespace
+
+TEST_F(ImageRecompressorTest, DownsamplesImagesAboveMaxDpi) {
+    // 400 pixels drawn 200 points wide is 144 dpi
+    std::string pdf = MakeDocument(400, 200, {255, 255});
+    ImageRecompressor images;
+    images.max_dpi = 72;
+    std::vector<uint8_t> output = Recompress(images, pdf);
+    EXPECT_EQ(ImageWidths(output), std::vector<int>({200, 200}));
+    EXPECT_EQ(images.ReplacedCount(), 2);
+    EXPECT_LT(images.BytesAfter(), images.BytesBefore());
+    EXPECT_LT(output.size(), pdf.size());
+}
+
+TEST_F(ImageRecompressorTest, KeepsImagesBelowMaxDpi) {
+    std::string pdf = MakeDocument(400, 200, {255});
+    ImageRecompressor images;
+    images.max_dpi = 150;
+    EXPECT_EQ(ImageWidths(Recompress(images, pdf)), std::vector<int>({400}));
+    EXPECT_EQ(images.ReplacedCount(), 0);
+}
+
+TEST_F(ImageRecompressorTest, KeepsTransparentImages) {
+    std::string pdf = MakeDocument(400, 200, {255, 0});
+    ImageRecompressor images;
+    images.max_dpi = 72;
+    EXPECT_EQ(ImageWidths(Recompress(images, pdf)), std::vector<int>({200, 400}));
+}
+
+TEST_F(ImageRecompressorTest, KeepsGrayImagesGray) {
+    std::string pdf = MakeGrayDocument(400, 200);
+    ImageRecompressor images;
+    images.max_dpi = 72;
+    std::vector<uint8_t> output = Recompress(images, pdf);
+    EXPECT_EQ(ImageWidths(output), std::vector<int>({200}));
+
+    std::vector<uint8_t> before = RenderGray(pdf.data(), pdf.size());
+    std::vector<uint8_t> after = RenderGray(output.data(), output.size());
+    ASSERT_EQ(before.size(), after.size());
+    ASSERT_FALSE(before.empty());
+    uint64_t error = 0;
+    for (size_t i = 0; i < before.size(); ++i) error += std::abs(before[i] - after[i]);
+    EXPECT_LT(error / before.size(), 4u);
+}
+
+TEST_F(ImageRecompressorTest, WritesTheLengthOfNewImages) {
+    std::string pdf = MakeGrayDocument(400, 200);
+    ImageRecompressor images;
+    images.max_dpi = 72;
+    std::vector<uint8_t> output = Recompress(images, pdf);
+    ASSERT_EQ(images.ReplacedCount(), 1);
+    std::string written(output.begin(), output.end());
+    EXPECT_NE(written.find("/Length " + std::to_string(images.BytesAfter())), std::string::npos);
+}
+
+TEST_F(ImageRecompressorTest, ShrinksImagesToTheTargetSize) {
+    std::string pdf = MakeDocument(800, 200, {255});
+    ImageRecompressor images;
+    images.target_bytes = 20000;
+    std::vector<uint8_t> output = Recompress(images, pdf);
+    EXPECT_LE(output.size(), 20000u);
+    std::vector<int> widths = ImageWidths(output);
+    ASSERT_EQ(widths.size(), 1u);
+    EXPECT_LT(widths[0], 800);
+    EXPECT_GE(widths[0], 200);  // not below 72 dpi
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "include/pdf_combiner/image_writer.h"
+#include "include/pdf_combiner/stb_image.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class ImageWriterTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (const std::string& path : paths_) remove(path.c_str());
+    }
+
+    std::string TempPath(const std::string& name) {
+        std::string path = testing::TempDir() + "image_writer_" + std::to_string(getpid()) + "_" + name;
+        paths_.push_back(path);
+        return path;
+    }
+
+    static std::string ReadFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    // A 2x2 BGRA image: opaque red, opaque blue, transparent, half-transparent black
+    static std::vector<uint8_t> Pixels() {
+        return {0, 0, 255, 255, 255, 0, 0, 255, 0, 0, 0, 0, 0, 0, 0, 128};
+    }
+
+private:
+    std::vector<std::string> paths_;
+};
+
+}  // namespace
+
+TEST_F(ImageWriterTest, NamesFilesByFormat) {
+    EXPECT_EQ(image_file_name("out/image_1", ImageFormat::kPng, 10, 20), "out/image_1.png");
+    EXPECT_EQ(image_file_name("out/image_1", ImageFormat::kJpeg, 10, 20), "out/image_1.jpg");
+    EXPECT_EQ(image_file_name("out/image_1", ImageFormat::kBgra, 10, 20), "out/image_1_10x20.bgra");
+    ImageFormat format;
+    EXPECT_TRUE(parse_image_format("pgm", format));
+    EXPECT_EQ(format, ImageFormat::kPgm);
+    EXPECT_FALSE(parse_image_format("webp", format));
+    EXPECT_STREQ(image_format_name(ImageFormat::kJpeg), "jpeg");
+}
+
+TEST_F(ImageWriterTest, WritesRawPixelsAsTheyAre) {
+    std::vector<uint8_t> pixels = Pixels();
+    std::string path = TempPath("raw.bgra");
+    ASSERT_TRUE(save_bgra_image(pixels.data(), 2, 2, 8, path, ImageFormat::kBgra, 0));
+    EXPECT_EQ(ReadFile(path), std::string(pixels.begin(), pixels.end()));
+}
+
+TEST_F(ImageWriterTest, WritesPortableFormatsOverWhite) {
+    std::vector<uint8_t> pixels = Pixels();
+    std::string ppm = TempPath("image.ppm");
+    ASSERT_TRUE(save_bgra_image(pixels.data(), 2, 2, 8, ppm, ImageFormat::kPpm, 0));
+    std::string expected = "P6\n2 2\n255\n";
+    expected += std::string("\xff\x00\x00\x00\x00\xff\xff\xff\xff\x7f\x7f\x7f", 12);
+    EXPECT_EQ(ReadFile(ppm), expected);
+
+    std::string pgm = TempPath("image.pgm");
+    ASSERT_TRUE(save_bgra_image(pixels.data(), 2, 2, 8, pgm, ImageFormat::kPgm, 0));
+    std::string gray = ReadFile(pgm);
+    ASSERT_EQ(gray.size(), 11u + 4);
+    EXPECT_EQ(gray.substr(0, 11), "P5\n2 2\n255\n");
+    EXPECT_EQ((uint8_t)gray[11], 76);   // red
+    EXPECT_EQ((uint8_t)gray[12], 28);   // blue
+    EXPECT_EQ((uint8_t)gray[13], 255);  // transparent is white
+}
+
+TEST_F(ImageWriterTest, WritesJpegWithQualityFromCompression) {
+    // A gradient large enough for the quality to change the size
+    int size = 128;
+    std::vector<uint8_t> pixels((size_t)size * size * 4);
+    for (int i = 0; i < size * size; ++i) {
+        pixels[i * 4] = (uint8_t)(i % size * 2);
+        pixels[i * 4 + 1] = (uint8_t)(i / size * 2);
+        pixels[i * 4 + 2] = (uint8_t)((i * 7) % 255);
+        pixels[i * 4 + 3] = 255;
+    }
+    std::string best = TempPath("best.jpg");
+    std::string smallest = TempPath("smallest.jpg");
+    uint64_t best_bytes = 0, smallest_bytes = 0;
+    ASSERT_TRUE(save_bgra_image(pixels.data(), size, size, size * 4, best, ImageFormat::kJpeg, 0, &best_bytes));
+    ASSERT_TRUE(save_bgra_image(pixels.data(), size, size, size * 4, smallest, ImageFormat::kJpeg, 100, &smallest_bytes));
+    EXPECT_LT(smallest_bytes, best_bytes);
+
+    int width, height, channels;
+    stbi_uc* decoded = stbi_load(best.c_str(), &width, &height, &channels, 3);
+    ASSERT_NE(decoded, nullptr);
+    EXPECT_EQ(width, size);
+    EXPECT_EQ(height, size);
+    EXPECT_EQ(channels, 3);
+    stbi_image_free(decoded);
+    EXPECT_EQ((uint64_t)ReadFile(best).size(), best_bytes);
+}
+
+TEST_F(ImageWriterTest, EncodesToMemory) {
+    std::vector<uint8_t> pixels = Pixels();
+    std::string path = TempPath("file.png");
+    ASSERT_TRUE(save_bgra_image(pixels.data(), 2, 2, 8, path, ImageFormat::kPng, 0));
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(encode_bgra_image(pixels.data(), 2, 2, 8, ImageFormat::kPng, 0, png));
+    EXPECT_EQ(std::string(png.begin(), png.end()), ReadFile(path));
+
+    std::vector<uint8_t> ppm;
+    ASSERT_TRUE(encode_bgra_image(pixels.data(), 2, 2, 8, ImageFormat::kPpm, 0, ppm));
+    EXPECT_EQ(ppm.size(), 11u + 12);
+}
+
+TEST_F(ImageWriterTest, StreamsRowsAndChecksTheirCount) {
+    std::vector<uint8_t> pixels = Pixels();
+    std::string path = TempPath("rows.png");
+    ImageWriter writer(path, 2, 2, ImageFormat::kPng, 0);
+    ASSERT_TRUE(writer.ok());
+    ASSERT_TRUE(writer.WriteRows(pixels.data(), 1, 8));
+    EXPECT_FALSE(writer.Finish());  // one row missing
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
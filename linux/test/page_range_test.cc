@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "include/pdf_combiner/page_range.h"
+
+namespace pdf_combiner {
+namespace test {
+
+TEST(PageRange, ParsesPagesAndRangesInOrder) {
+    std::vector<int> indices;
+    ASSERT_TRUE(parse_page_range("1-3,7,10-", 12, indices));
+    EXPECT_EQ(indices, (std::vector<int>{0, 1, 2, 6, 9, 10, 11}));
+}
+
+TEST(PageRange, AcceptsOpenStartSpacesAndRepeats) {
+    std::vector<int> indices;
+    ASSERT_TRUE(parse_page_range(" -2 , 5, 2 ", 5, indices));
+    EXPECT_EQ(indices, (std::vector<int>{0, 1, 4, 1}));
+}
+
+TEST(PageRange, RejectsPagesOutsideTheDocument) {
+    std::vector<int> indices;
+    EXPECT_FALSE(parse_page_range("0", 5, indices));
+    EXPECT_FALSE(parse_page_range("6", 5, indices));
+    EXPECT_FALSE(parse_page_range("4-9", 5, indices));
+}
+
+TEST(PageRange, RejectsMalformedSelections) {
+    std::vector<int> indices;
+    EXPECT_FALSE(parse_page_range("", 5, indices));
+    EXPECT_FALSE(parse_page_range("3-1", 5, indices));
+    EXPECT_FALSE(parse_page_range("1,,2", 5, indices));
+    EXPECT_FALSE(parse_page_range("a", 5, indices));
+    EXPECT_FALSE(parse_page_range("1-2-3", 5, indices));
+    EXPECT_FALSE(parse_page_range("99999999999", 5, indices));
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
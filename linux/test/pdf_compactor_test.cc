@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/my_file_write.h"
+#include "include/pdf_combiner/pdf_compactor.h"
+#include "include/pdf_combiner/pdf_reader.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class PdfCompactorTest : public PdfiumTest {};
+
+}  // namespace
+
+TEST_F(PdfCompactorTest, KeepsOnlyReachableObjectsInObjectStreams) {
+    std::string pdf =
+            "%PDF-1.4\n"
+            "1 0 obj <</Type/Catalog/Pages 2 0 R>> endobj\n"
+            "2 0 obj <</Type/Pages/Kids[3 0 R]/Count 1>> endobj\n"
+            "3 0 obj <</Type/Page/Parent 2 0 R/MediaBox[0 0 300 200]/Contents 4 0 R>> endobj\n"
+            "4 0 obj <</Length 17>> stream\n0 0 100 100 re f\nendstream endobj\n"
+            "5 0 obj <</Unused true>> endobj\n"
+            "6 0 obj <</Length 3>> stream\nabc\nendstream endobj\n"
+            "startxref\n0\n%%EOF\n";
+    MyMemoryWrite output;
+    ASSERT_TRUE(compact_pdf((const uint8_t*)pdf.data(), pdf.size(), &output));
+
+    // Catalog, page tree, page and contents, then the object and xref streams
+    PdfReader reader(output.data.data(), output.data.size());
+    ASSERT_TRUE(reader.Open());
+    EXPECT_EQ(reader.Version(), "1.5");
+    EXPECT_EQ(reader.Size(), 7);
+    std::string text(output.data.begin(), output.data.end());
+    EXPECT_NE(text.find("/Type/XRef"), std::string::npos);
+    EXPECT_EQ(text.find("Unused"), std::string::npos);
+    EXPECT_EQ(text.find("/Type/Page"), std::string::npos);
+
+    FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(output.data.data(), output.data.size(), nullptr);
+    ASSERT_NE(doc, nullptr);
+    ASSERT_EQ(FPDF_GetPageCount(doc), 1);
+    FPDF_PAGE page = FPDF_LoadPage(doc, 0);
+    ASSERT_NE(page, nullptr);
+    EXPECT_EQ((int)FPDF_GetPageWidthF(page), 300);
+    EXPECT_EQ(FPDFPage_CountObjects(page), 1);
+    FPDF_ClosePage(page);
+    FPDF_CloseDocument(doc);
+}
+
+TEST_F(PdfCompactorTest, RefusesInputsThatAreNotPdfs) {
+    MyMemoryWrite output;
+    std::string garbage = "not a pdf";
+    EXPECT_FALSE(compact_pdf((const uint8_t*)garbage.data(), garbage.size(), &output));
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
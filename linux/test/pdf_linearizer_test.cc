@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "include/pdfium/fpdf_dataavail.h"
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/pdf_linearizer.h"
+#include "include/pdf_combiner/pdf_reader.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class PdfLinearizerTest : public PdfiumTest {
+protected:
+    static FPDF_BOOL IsDataAvail(FX_FILEAVAIL*, size_t, size_t) { return 1; }
+    static void AddSegment(FX_DOWNLOADHINTS*, size_t, size_t) {}
+
+    static int GetBlock(void* param, unsigned long position, unsigned char* buffer, unsigned long size) {
+        const std::string* data = static_cast<const std::string*>(param);
+        if (position + size > data->size()) return 0;
+        memcpy(buffer, data->data() + position, size);
+        return 1;
+    }
+};
+
+}  // namespace
+
+TEST_F(PdfLinearizerTest, WritesALinearizedFileWithEveryPage) {
+    std::string source = make_text_document(7);
+    std::string linearized;
+    ASSERT_TRUE(linearize_pdf((const uint8_t*)source.data(), source.size(), linearized));
+
+    FX_FILEAVAIL file_avail = {};
+    file_avail.version = 1;
+    file_avail.IsDataAvail = IsDataAvail;
+    FPDF_FILEACCESS access = {};
+    access.m_FileLen = linearized.size();
+    access.m_GetBlock = GetBlock;
+    access.m_Param = &linearized;
+    FX_DOWNLOADHINTS hints = {};
+    hints.version = 1;
+    hints.AddSegment = AddSegment;
+    FPDF_AVAIL avail = FPDFAvail_Create(&file_avail, &access);
+    EXPECT_EQ(FPDFAvail_IsLinearized(avail), PDF_LINEARIZED);
+    ASSERT_EQ(FPDFAvail_IsDocAvail(avail, &hints), PDF_DATA_AVAIL);
+
+    // PDFium reads the pages through the hint tables
+    FPDF_DOCUMENT doc = FPDFAvail_GetDocument(avail, nullptr);
+    ASSERT_NE(doc, nullptr);
+    EXPECT_EQ(FPDF_GetPageCount(doc), 7);
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(FPDFAvail_IsPageAvail(avail, i, &hints), PDF_DATA_AVAIL);
+        FPDF_PAGE page = FPDF_LoadPage(doc, i);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(FPDFPage_CountObjects(page), i + 1);
+        FPDF_ClosePage(page);
+    }
+    FPDF_CloseDocument(doc);
+    FPDFAvail_Destroy(avail);
+}
+
+TEST_F(PdfLinearizerTest, RefusesInputsThatAreNotPdfs) {
+    std::string linearized;
+    std::string garbage = "not a pdf";
+    EXPECT_FALSE(linearize_pdf((const uint8_t*)garbage.data(), garbage.size(), linearized));
+}
+
+TEST(PdfReader, RecoversObjectsWithoutCrossReferences) {
+    std::string pdf =
+            "%PDF-1.4\n"
+            "1 0 obj <</Type/Catalog/Pages 2 0 R>> endobj\n"
+            "2 0 obj <</Type/Pages/Kids[3 0 R]/Count 1>> endobj\n"
+            "3 0 obj <</Type/Page/Parent 2 0 R/MediaBox[0 0 612 792]/Contents 4 0 R>> endobj\n"
+            "4 0 obj <</Length 99>> stream\n0 0 m\nendstream endobj\n"
+            "startxref\n999\n%%EOF\n";
+    PdfReader reader((const uint8_t*)pdf.data(), pdf.size());
+    ASSERT_TRUE(reader.Open());
+    EXPECT_EQ(reader.Version(), "1.4");
+    EXPECT_EQ(reader.Trailer().Find("Root")->integer, 1);
+
+    PdfIndirectObject page;
+    ASSERT_TRUE(reader.ReadObject(3, page));
+    EXPECT_TRUE(page.value.Find("Type")->IsName("Page"));
+    EXPECT_EQ(page.value.Find("MediaBox")->items[3].integer, 792);
+
+    // The wrong /Length is replaced by the real one
+    PdfIndirectObject contents;
+    ASSERT_TRUE(reader.ReadObject(4, contents));
+    EXPECT_EQ(contents.stream, "0 0 m");
+    EXPECT_EQ(contents.value.Find("Length")->integer, 5);
+}
+
+TEST(PdfReader, ReadsObjectStreamsAndIndirectLengths) {
+    std::string pdf = write_pdf(one_page_objects(), XrefLayout::kStream, {2, 3, 5, 6});
+    PdfReader reader((const uint8_t*)pdf.data(), pdf.size());
+    ASSERT_TRUE(reader.Open());
+    EXPECT_EQ(reader.Size(), 9);
+
+    PdfIndirectObject page;
+    ASSERT_TRUE(reader.ReadObject(3, page));
+    EXPECT_TRUE(page.value.Find("Type")->IsName("Page"));
+
+    // The /Length of the contents is read from the object stream
+    PdfIndirectObject contents;
+    ASSERT_TRUE(reader.ReadObject(4, contents));
+    EXPECT_EQ(contents.stream, "BT /F1 24 Tf 20 100 Td (Hybrid) Tj ET");
+    EXPECT_EQ(contents.value.Find("Length")->type, PdfValue::kInteger);
+}
+
+TEST(PdfReader, ReadsObjectStreamsOfHybridFiles) {
+    // The table marks the compressed objects free, /XRefStm lists them
+    std::string pdf = write_pdf(one_page_objects(), XrefLayout::kHybrid, {2, 3, 5, 6});
+    PdfReader reader((const uint8_t*)pdf.data(), pdf.size());
+    ASSERT_TRUE(reader.Open());
+    PdfIndirectObject page;
+    ASSERT_TRUE(reader.ReadObject(3, page));
+    EXPECT_TRUE(page.value.Find("Type")->IsName("Page"));
+    PdfIndirectObject contents;
+    ASSERT_TRUE(reader.ReadObject(4, contents));
+    EXPECT_EQ(contents.stream, "BT /F1 24 Tf 20 100 Td (Hybrid) Tj ET");
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
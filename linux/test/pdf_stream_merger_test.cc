@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/my_file_write.h"
+#include "include/pdf_combiner/pdf_reader.h"
+#include "include/pdf_combiner/pdf_stream_merger.h"
+#include "test/test_documents.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+class PdfStreamMergerTest : public PdfiumTest {
+protected:
+    static int OpenInput(PdfStreamMerger& merger, const std::string& pdf) {
+        return merger.OpenInput((const uint8_t*)pdf.data(), pdf.size());
+    }
+
+    // The page objects of a merged PDF, read back with PdfReader
+    static std::vector<PdfValue> ReadPages(const std::vector<uint8_t>& pdf) {
+        std::vector<PdfValue> pages;
+        PdfReader reader(pdf.data(), pdf.size());
+        if (!reader.Open()) return pages;
+        PdfValue catalog = reader.Resolve(*reader.Trailer().Find("Root"));
+        PdfValue tree = reader.Resolve(*catalog.Find("Pages"));
+        for (const PdfValue& kid : tree.Find("Kids")->items) pages.push_back(reader.Resolve(kid));
+        return pages;
+    }
+};
+
+}  // namespace
+
+TEST_F(PdfStreamMergerTest, CopiesTheSelectedPagesInOrder) {
+    std::string first = make_text_document(3, 100);
+    std::string second = make_text_document(2, 300);
+    MyMemoryWrite output;
+    PdfStreamMerger merger(&output);
+    ASSERT_EQ(OpenInput(merger, first), 3);
+    ASSERT_TRUE(merger.CopyPages({2, 0, 2}));
+    ASSERT_EQ(OpenInput(merger, second), 2);
+    ASSERT_TRUE(merger.CopyPages({}));
+    ASSERT_TRUE(merger.Finish());
+    EXPECT_EQ(merger.PageCount(), 5);
+    EXPECT_EQ(merger.BytesWritten(), output.data.size());
+
+    FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(output.data.data(), output.data.size(), nullptr);
+    ASSERT_NE(doc, nullptr);
+    ASSERT_EQ(FPDF_GetPageCount(doc), 5);
+    const int expected_widths[] = {102, 100, 102, 300, 301};
+    const int expected_objects[] = {3, 1, 3, 1, 2};
+    for (int i = 0; i < 5; ++i) {
+        FPDF_PAGE page = FPDF_LoadPage(doc, i);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ((int)FPDF_GetPageWidthF(page), expected_widths[i]);
+        EXPECT_EQ(FPDFPage_CountObjects(page), expected_objects[i]);
+        FPDF_ClosePage(page);
+    }
+    FPDF_CloseDocument(doc);
+}
+
+TEST_F(PdfStreamMergerTest, SharesIdenticalStreamsWhenDeduplicating) {
+    std::string pdf = make_text_document(2, 100);
+    for (bool deduplicate : {false, true}) {
+        MyMemoryWrite output;
+        PdfStreamMerger merger(&output);
+        merger.deduplicate = deduplicate;
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_EQ(OpenInput(merger, pdf), 2);
+            ASSERT_TRUE(merger.CopyPages({}));
+        }
+        ASSERT_TRUE(merger.Finish());
+
+        // The content streams of the second copy are the first ones
+        std::vector<PdfValue> pages = ReadPages(output.data);
+        ASSERT_EQ(pages.size(), 4u);
+        for (int i = 0; i < 2; ++i) {
+            const PdfValue* first = pages[i].Find("Contents");
+            const PdfValue* second = pages[i + 2].Find("Contents");
+            ASSERT_TRUE(first && second && first->IsReference() && second->IsReference());
+            EXPECT_EQ(first->integer == second->integer, deduplicate);
+        }
+        EXPECT_EQ(merger.DuplicateCount(), deduplicate ? 2 : 0);
+    }
+}
+
+TEST_F(PdfStreamMergerTest, KeepsReferenceCycles) {
+    std::string pdf =
+            "%PDF-1.4\n"
+            "1 0 obj <</Type/Catalog/Pages 2 0 R>> endobj\n"
+            "2 0 obj <</Type/Pages/Kids[3 0 R]/Count 1/MediaBox[0 0 200 200]>> endobj\n"
+            "3 0 obj <</Type/Page/Parent 2 0 R/Annots[4 0 R]>> endobj\n"
+            "4 0 obj <</Type/Annot/Subtype/Text/Rect[0 0 20 20]/P 3 0 R/Popup 5 0 R>> endobj\n"
+            "5 0 obj <</Type/Annot/Subtype/Popup/Rect[20 20 90 90]/Parent 4 0 R>> endobj\n"
+            "startxref\n0\n%%EOF\n";
+    MyMemoryWrite output;
+    PdfStreamMerger merger(&output);
+    merger.deduplicate = true;
+    ASSERT_EQ(OpenInput(merger, pdf), 1);
+    ASSERT_TRUE(merger.CopyPages({0, 0}));
+    ASSERT_TRUE(merger.Finish());
+
+    PdfReader reader(output.data.data(), output.data.size());
+    ASSERT_TRUE(reader.Open());
+    std::vector<PdfValue> pages = ReadPages(output.data);
+    ASSERT_EQ(pages.size(), 2u);
+    const PdfValue& annot_ref = pages[0].Find("Annots")->items[0];
+    PdfValue annot = reader.Resolve(annot_ref);
+    PdfValue popup = reader.Resolve(*annot.Find("Popup"));
+    EXPECT_EQ(popup.Find("Parent")->integer, annot_ref.integer);
+    EXPECT_EQ(reader.Resolve(*annot.Find("P")).Find("Type")->text, "Page");
+    EXPECT_TRUE(pages[0].Find("MediaBox") != nullptr);
+}
+
+TEST_F(PdfStreamMergerTest, CopiesFilesPdfiumDidNotWrite) {
+    for (XrefLayout layout : {XrefLayout::kTable, XrefLayout::kStream, XrefLayout::kHybrid}) {
+        std::string pdf = write_pdf(one_page_objects(), layout, {2, 3, 5, 6});
+        MyMemoryWrite output;
+        PdfStreamMerger merger(&output);
+        ASSERT_EQ(OpenInput(merger, pdf), 1);
+        ASSERT_TRUE(merger.CopyPages({0}));
+        ASSERT_TRUE(merger.Finish());
+
+        FPDF_DOCUMENT doc = FPDF_LoadMemDocument64(output.data.data(), output.data.size(), nullptr);
+        ASSERT_NE(doc, nullptr);
+        ASSERT_EQ(FPDF_GetPageCount(doc), 1);
+        FPDF_PAGE page = FPDF_LoadPage(doc, 0);
+        ASSERT_NE(page, nullptr);
+        EXPECT_EQ(FPDFPage_CountObjects(page), 1);
+        FPDF_ClosePage(page);
+        FPDF_CloseDocument(doc);
+    }
+}
+
+TEST_F(PdfStreamMergerTest, RejectsInputsItCannotRead) {
+    MyMemoryWrite output;
+    PdfStreamMerger merger(&output);
+    EXPECT_EQ(OpenInput(merger, "not a pdf"), -1);
+    EXPECT_FALSE(merger.CopyPages({}));
+
+    std::string pdf = make_text_document(1, 100);
+    ASSERT_EQ(OpenInput(merger, pdf), 1);
+    EXPECT_FALSE(merger.CopyPages({1}));
+
+    // No page found, PDFium has to rewrite it
+    std::vector<std::string> objects = one_page_objects();
+    objects[0] = "<</Type/Catalog/Pages 9 0 R>>";
+    EXPECT_EQ(OpenInput(merger, write_pdf(objects)), -1);
+}
+
+TEST_F(PdfStreamMergerTest, FailsToCopyPagesUsingObjectsItCannotRead) {
+    // The font is listed, but where object 7 is
+    std::string pdf = write_pdf(one_page_objects());
+    pdf.replace(pdf.find("6 0 obj"), 7, "7 0 obj");
+    MyMemoryWrite output;
+    PdfStreamMerger merger(&output);
+    ASSERT_EQ(OpenInput(merger, make_text_document(1)), 1);
+    ASSERT_TRUE(merger.CopyPages({}));
+    ASSERT_EQ(OpenInput(merger, pdf), 1);
+    EXPECT_FALSE(merger.CopyPages({}));
+    EXPECT_EQ(merger.PageCount(), 1);
+
+    // A reference to a free object is a reference to null
+    std::vector<std::string> objects = one_page_objects();
+    objects[2] = "<</Type/Page/Parent 2 0 R/MediaBox[0 0 300 200]/Annots[9 0 R]>>";
+    ASSERT_EQ(OpenInput(merger, write_pdf(objects)), 1);
+    EXPECT_TRUE(merger.CopyPages({}));
+    EXPECT_EQ(merger.PageCount(), 2);
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
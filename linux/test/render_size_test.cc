@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include "include/pdf_combiner/render_size.h"
+
+namespace pdf_combiner {
+namespace test {
+
+TEST(RenderSizeTest, UsesPointsByDefault) {
+    RenderSize size;
+    int width, height;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(width, 612);
+    EXPECT_EQ(height, 792);
+}
+
+TEST(RenderSizeTest, ScalesByDpi) {
+    RenderSize size;
+    size.scale = 150 / 72.0;
+    int width, height;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(width, 1275);
+    EXPECT_EQ(height, 1650);
+}
+
+TEST(RenderSizeTest, KeepsTheAspectRatioWithinTheMaxSize) {
+    RenderSize size;
+    size.scale = 4;
+    size.max_width = 1000;
+    size.max_height = 1000;
+    int width, height;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(height, 1000);
+    EXPECT_EQ(width, 772);
+
+    // Limits only shrink pages
+    size.scale = 1;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(width, 612);
+}
+
+TEST(RenderSizeTest, StaysWithinMaxPixels) {
+    RenderSize size;
+    size.scale = 10;
+    size.max_pixels = 1000000;
+    int width, height;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_LE((int64_t)width * height, 1000000);
+    EXPECT_GT((int64_t)width * height, 990000);
+    EXPECT_NEAR((double)width / height, 612.0 / 792, 0.01);
+}
+
+TEST(RenderSizeTest, FixedSizeWins) {
+    RenderSize size;
+    size.scale = 3;
+    size.max_width = 10;
+    size.fixed_width = 300;
+    size.fixed_height = 300;
+    int width, height;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(width, 300);
+    EXPECT_EQ(height, 300);
+
+    // A single fixed side keeps the aspect ratio
+    size.fixed_height = 0;
+    ASSERT_TRUE(size.PageSize(612, 792, width, height));
+    EXPECT_EQ(width, 300);
+    EXPECT_EQ(height, 388);
+}
+
+TEST(RenderSizeTest, RejectsEmptyAndHugePages) {
+    RenderSize size;
+    int width, height;
+    EXPECT_FALSE(size.PageSize(0, 792, width, height));
+    size.scale = 1e9;
+    EXPECT_FALSE(size.PageSize(612, 792, width, height));
+}
+
+TEST(RenderSizeTest, ChecksBitmapsAgainstMemory) {
+    EXPECT_TRUE(bitmaps_fit_in_memory(1000, 1000, 2, 8000000));
+    EXPECT_FALSE(bitmaps_fit_in_memory(1000, 1000, 3, 8000000));
+    EXPECT_TRUE(bitmaps_fit_in_memory(100000, 100000, 1, 0));
+    EXPECT_GT(available_memory(), 0u);
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
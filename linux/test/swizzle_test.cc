@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "include/pdf_combiner/swizzle.h"
+
+namespace pdf_combiner {
+namespace test {
+
+namespace {
+
+std::vector<uint8_t> make_image(int width, int height, size_t stride) {
+    std::vector<uint8_t> image(stride * height);
+    for (size_t i = 0; i < image.size(); i++) image[i] = (uint8_t)(i * 7 + 3);
+    return image;
+}
+
+// Reference conversion, pixel by pixel.
+std::vector<uint8_t> reference(const std::vector<uint8_t>& src, size_t stride, int width, int height, bool flip) {
+    std::vector<uint8_t> dst((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+        const uint8_t* s = src.data() + y * stride;
+        uint8_t* d = dst.data() + (size_t)(flip ? height - 1 - y : y) * width * 4;
+        for (int x = 0; x < width; x++) {
+            d[x * 4 + 0] = s[x * 4 + 2];
+            d[x * 4 + 1] = s[x * 4 + 1];
+            d[x * 4 + 2] = s[x * 4 + 0];
+            d[x * 4 + 3] = s[x * 4 + 3];
+        }
+    }
+    return dst;
+}
+
+}  // namespace
+
+TEST(Swizzle, MatchesReferenceForOddWidths) {
+    for (int width : {1, 3, 7, 8, 15, 16, 17, 33, 255}) {
+        std::vector<uint8_t> src = make_image(width, 3, (size_t)width * 4);
+        std::vector<uint8_t> dst((size_t)width * 3 * 4);
+        swizzle_rgba_bgra(src.data(), (size_t)width * 4, dst.data(), (size_t)width * 4, width, 3, false);
+        EXPECT_EQ(dst, reference(src, (size_t)width * 4, width, 3, false)) << "width " << width;
+    }
+}
+
+TEST(Swizzle, FlipsVerticallyAndHonorsStride) {
+    const int width = 37, height = 5;
+    const size_t stride = width * 4 + 12;
+    std::vector<uint8_t> src = make_image(width, height, stride);
+    std::vector<uint8_t> dst((size_t)width * height * 4);
+    swizzle_rgba_bgra(src.data(), stride, dst.data(), (size_t)width * 4, width, height, true);
+    EXPECT_EQ(dst, reference(src, stride, width, height, true));
+}
+
+TEST(Swizzle, ConvertsInPlace) {
+    const int width = 41, height = 2;
+    std::vector<uint8_t> image = make_image(width, height, (size_t)width * 4);
+    std::vector<uint8_t> expected = reference(image, (size_t)width * 4, width, height, false);
+    swizzle_rgba_bgra(image.data(), (size_t)width * 4, image.data(), (size_t)width * 4, width, height, false);
+    EXPECT_EQ(image, expected);
+}
+
+TEST(Swizzle, RoundTripRestoresInput) {
+    const int width = 64, height = 4;
+    std::vector<uint8_t> src = make_image(width, height, (size_t)width * 4);
+    std::vector<uint8_t> once((size_t)width * height * 4), twice(once.size());
+    swizzle_rgba_bgra(src.data(), (size_t)width * 4, once.data(), (size_t)width * 4, width, height, true);
+    swizzle_rgba_bgra(once.data(), (size_t)width * 4, twice.data(), (size_t)width * 4, width, height, true);
+    EXPECT_EQ(twice, src);
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
@@ -0,0 +1,167 @@
+#ifndef PDF_COMBINER_TEST_TEST_DOCUMENTS_H_
+#define PDF_COMBINER_TEST_TEST_DOCUMENTS_H_
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "include/pdfium/fpdf_edit.h"
+#include "include/pdfium/fpdf_save.h"
+#include "include/pdfium/fpdfview.h"
+#include "include/pdf_combiner/my_file_write.h"
+
+// The PDF documents the unit tests work on: documents built and saved by
+// PDFium, and documents written by hand with the layouts PDFium never writes
+// itself but other producers do.
+
+namespace pdf_combiner {
+namespace test {
+
+// Base of the tests that call PDFium
+class PdfiumTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() { FPDF_InitLibrary(); }
+};
+
+// Saves `doc` with FPDF_SaveAsCopy, and closes it.
+inline std::string save_document(FPDF_DOCUMENT doc) {
+    MyMemoryWrite saved;
+    FPDF_SaveAsCopy(doc, &saved, FPDF_INCREMENTAL);
+    FPDF_CloseDocument(doc);
+    return std::string(saved.data.begin(), saved.data.end());
+}
+
+// A document whose page i is `width` + i points wide and has i + 1 text
+// objects in a shared font, saved by PDFium.
+inline std::string make_text_document(int page_count, int width = 200) {
+    FPDF_DOCUMENT doc = FPDF_CreateNewDocument();
+    FPDF_FONT font = FPDFText_LoadStandardFont(doc, "Helvetica");
+    for (int i = 0; i < page_count; ++i) {
+        FPDF_PAGE page = FPDFPage_New(doc, i, width + i, 200);
+        for (int j = 0; j <= i; ++j) {
+            FPDF_PAGEOBJECT text = FPDFPageObj_CreateTextObj(doc, font, 12);
+            const unsigned short label[] = {(unsigned short)('A' + j % 26), 0};
+            FPDFText_SetText(text, label);
+            FPDFPage_InsertObject(page, text);
+        }
+        FPDFPage_GenerateContent(page);
+        FPDF_ClosePage(page);
+    }
+    FPDFFont_Close(font);
+    return save_document(doc);
+}
+
+// How write_pdf() lists the objects
+enum class XrefLayout {
+    kTable,   // an xref table
+    kStream,  // an xref stream, with the `compressed` objects in an object stream
+    kHybrid,  // an xref table where the `compressed` objects are free, and an
+              // xref stream listing them in an object stream, found through the
+              // /XRefStm of the trailer, as Microsoft Office writes
+};
+
+// Writes `objects`, numbered from 1, as a PDF whose catalog is object 1. With
+// an xref stream, the object stream and the xref stream are the next two
+// objects. Objects with a stream cannot be `compressed`.
+inline std::string write_pdf(const std::vector<std::string>& objects, XrefLayout layout = XrefLayout::kTable,
+                             const std::set<int>& compressed = {}) {
+    const int count = (int)objects.size();
+    const int object_stream = count + 1;
+    const int xref_stream = count + 2;
+    const int size = layout == XrefLayout::kTable ? count + 1 : count + 3;
+    bool use_object_stream = layout != XrefLayout::kTable && !compressed.empty();
+
+    std::string pdf = "%PDF-1.5\n%\xe2\xe3\xcf\xd3\n";
+    std::vector<size_t> offsets(size, 0);
+    std::vector<int> indices(size, -1);  // index in the object stream
+    std::string header, body;
+    int compressed_count = 0;
+    for (int number = 1; number <= count; ++number) {
+        const std::string& object = objects[number - 1];
+        if (use_object_stream && compressed.count(number)) {
+            header += std::to_string(number) + " " + std::to_string(body.size()) + " ";
+            body += object + "\n";
+            indices[number] = compressed_count++;
+            continue;
+        }
+        offsets[number] = pdf.size();
+        pdf += std::to_string(number) + " 0 obj\n" + object + "\nendobj\n";
+    }
+    if (use_object_stream) {
+        std::string data = header + body;
+        offsets[object_stream] = pdf.size();
+        pdf += std::to_string(object_stream) + " 0 obj\n<</Type/ObjStm/N " + std::to_string(compressed_count) +
+               "/First " + std::to_string(header.size()) + "/Length " + std::to_string(data.size()) +
+               ">>stream\n" + data + "\nendstream\nendobj\n";
+    }
+
+    // Rows of 1 + 4 + 2 bytes, see /W
+    std::string rows;
+    std::string index;
+    auto add_row = [&](int number, int type, uint64_t second, int third) {
+        const uint8_t row[] = {(uint8_t)type,          (uint8_t)(second >> 24), (uint8_t)(second >> 16),
+                               (uint8_t)(second >> 8), (uint8_t)second,         (uint8_t)(third >> 8),
+                               (uint8_t)third};
+        rows.append((const char*)row, sizeof(row));
+        index += std::to_string(number) + " 1 ";
+    };
+    size_t xref_stream_offset = 0;
+    if (layout != XrefLayout::kTable) {
+        xref_stream_offset = pdf.size();
+        offsets[xref_stream] = xref_stream_offset;
+        for (int number = 0; number < size; ++number) {
+            if (indices[number] >= 0) {
+                add_row(number, 2, object_stream, indices[number]);
+            } else if (layout == XrefLayout::kStream) {
+                if (offsets[number] > 0) add_row(number, 1, offsets[number], 0);
+                else add_row(number, 0, 0, number == 0 ? 65535 : 0);
+            }
+        }
+        pdf += std::to_string(xref_stream) + " 0 obj\n<</Type/XRef/Size " + std::to_string(size) +
+               "/W[1 4 2]/Index[" + index + "]/Root 1 0 R/Length " + std::to_string(rows.size()) + ">>stream\n" +
+               rows + "\nendstream\nendobj\n";
+        if (layout == XrefLayout::kStream) {
+            return pdf + "startxref\n" + std::to_string(xref_stream_offset) + "\n%%EOF\n";
+        }
+    }
+
+    size_t start = pdf.size();
+    pdf += "xref\n0 " + std::to_string(size) + "\n";
+    for (int number = 0; number < size; ++number) {
+        char entry[32];
+        if (offsets[number] > 0) {
+            snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offsets[number]);
+        } else {
+            snprintf(entry, sizeof(entry), "0000000000 %05d f \n", number == 0 ? 65535 : 0);
+        }
+        pdf += entry;
+    }
+    pdf += "trailer\n<</Size " + std::to_string(size) + "/Root 1 0 R";
+    if (layout == XrefLayout::kHybrid) pdf += "/XRefStm " + std::to_string(xref_stream_offset);
+    return pdf + ">>\nstartxref\n" + std::to_string(start) + "\n%%EOF\n";
+}
+
+// A one page document with a text content stream, for write_pdf(). The page
+// tree and the page are objects 2 and 3, and the stream /Length is the
+// indirect object 5, as streaming producers write it.
+inline std::vector<std::string> one_page_objects() {
+    std::string contents = "BT /F1 24 Tf 20 100 Td (Hybrid) Tj ET";
+    return {
+            "<</Type/Catalog/Pages 2 0 R>>",
+            "<</Type/Pages/Kids[3 0 R]/Count 1>>",
+            "<</Type/Page/Parent 2 0 R/MediaBox[0 0 300 200]/Contents 4 0 R"
+            "/Resources<</Font<</F1 6 0 R>>>>>>",
+            "<</Length 5 0 R>>stream\n" + contents + "\nendstream",
+            std::to_string(contents.size()),
+            "<</Type/Font/Subtype/Type1/BaseFont/Helvetica>>",
+    };
+}
+
+}  // namespace test
+}  // namespace pdf_combiner
+
+#endif  // PDF_COMBINER_TEST_TEST_DOCUMENTS_H_
@@ -36,6 +36,14 @@ void main() {
       expect(input.type == MergeInputType.url, isTrue);
     });
 
+    test('pages defaults to null and is kept by every constructor', () {
+      expect(MergeInput.path('/path/to/file.pdf').pages, isNull);
+      expect(MergeInput.path('/path/to/file.pdf', pages: '1-3').pages, '1-3');
+      expect(MergeInput.bytes(Uint8List(0), pages: '7').pages, '7');
+      expect(MergeInput.url('https://example.com/file.pdf', pages: '10-').pages,
+          '10-');
+    });
+
     test('toString returns path for path type', () {
       final input = MergeInput.path('/path/to/file.pdf');
 
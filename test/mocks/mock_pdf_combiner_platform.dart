@@ -1,7 +1,16 @@
+import 'dart:typed_data';
+
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
+import 'package:pdf_combiner/models/image_format.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
 /// A mock implementation of the [PdfCombinerPlatform] interface for testing purposes.
@@ -13,6 +22,12 @@ import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 class MockPdfCombinerPlatform
     with MockPlatformInterfaceMixin
     implements PdfCombinerPlatform {
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => true;
+
   /// Mocks the `mergeMultiplePDF` method.
   ///
   /// Simulates combining multiple PDFs into a single PDF. It returns a mock result
@@ -24,10 +39,23 @@ class MockPdfCombinerPlatform
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) {
     return Future.value(outputPath);
   }
 
+  /// Mocks the `mergeMultiplePDFToBytes` method.
+  ///
+  /// Simulates combining multiple PDFs in memory. It returns the PDF header
+  /// bytes as the merged document.
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    return Future.value(Uint8List.fromList([0x25, 0x50, 0x44, 0x46]));
+  }
+
   /// Mocks the `createPDFFromMultipleImage` method.
   ///
   /// Simulates the creation of a PDF from multiple image files. It returns a mock result
@@ -63,4 +91,103 @@ class MockPdfCombinerPlatform
       return Future.value(['$outputPath/image1.png', '$outputPath/image2.png']);
     }
   }
+
+  /// Mocks the `createImageFromPDFToBytes` method.
+  ///
+  /// Simulates the rendering of two pages to PNG images in memory.
+  ///
+  /// [input] The path to the PDF file.
+  /// [config] The configuration for the images.
+  /// [pages] The pages to render.
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    return Future.value([
+      for (final page in [1, 2])
+        RenderedPage(
+          page: page,
+          width: 10,
+          height: 20,
+          format: ImageFormat.png,
+          bytes: Uint8List.fromList([137, 80, 78, 71]),
+        ),
+    ]);
+  }
+
+  /// Mocks the `createThumbnailsFromPDF` method.
+  ///
+  /// Simulates the creation of one thumbnail for each of two pages.
+  ///
+  /// [input] The path to the PDF file.
+  /// [outputPath] The path where the thumbnails should be saved.
+  /// [config] The configuration for the thumbnails.
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    return Future.value(
+        ['$outputPath/thumbnail_1.png', '$outputPath/thumbnail_2.png']);
+  }
+
+  /// Mocks the `progressStream` getter.
+  ///
+  /// Simulates a two page render reporting its progress.
+  @override
+  Stream<PdfCombinerProgress> get progressStream => Stream.fromIterable(const [
+        PdfCombinerProgress(
+            method: 'createImageFromPDF', pagesDone: 1, totalPages: 2),
+        PdfCombinerProgress(
+            method: 'createImageFromPDF',
+            pagesDone: 2,
+            totalPages: 2,
+            finished: true),
+      ]);
+
+  /// Mocks the `cancel` method.
+  ///
+  /// Simulates a running operation for any `jobId` except `unknown`.
+  @override
+  Future<bool> cancel(String jobId) {
+    return Future.value(jobId != 'unknown');
+  }
+
+  /// Mocks the `getNativeStats` method.
+  ///
+  /// Simulates an idle native worker pool.
+  @override
+  Future<Map<String, Object?>?> getNativeStats() {
+    return Future.value({'queueDepth': 0, 'runningJobs': 0});
+  }
+
+  /// Mocks the `runBatch` method.
+  ///
+  /// Simulates every job succeeding with the output path it was given.
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) {
+    return Future.value(jobs
+        .map((job) => BatchJobResult.success(switch (job) {
+              MergeBatchJob(:final outputPath) => outputPath,
+              MergeToBytesBatchJob() =>
+                Uint8List.fromList([0x25, 0x50, 0x44, 0x46]),
+              PdfFromImagesBatchJob(:final outputPath) => outputPath,
+              ImagesFromPdfBatchJob(:final outputDirPath) => [
+                  '$outputDirPath/image1.png'
+                ],
+            }))
+        .toList());
+  }
+
+  /// Mocks the `configureDocumentCache` method.
+  ///
+  /// Simulates a platform with a document cache.
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) {
+    return Future.value(true);
+  }
 }
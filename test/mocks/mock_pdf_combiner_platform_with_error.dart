@@ -1,18 +1,41 @@
+import 'dart:typed_data';
+
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
 import 'package:pdf_combiner/models/image_scale.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
 class MockPdfCombinerPlatformWithError
     with MockPlatformInterfaceMixin
     implements PdfCombinerPlatform {
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => false;
+
   @override
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
   }) {
     throw PdfCombinerException('error');
   }
@@ -37,4 +60,47 @@ class MockPdfCombinerPlatformWithError
     }
     return Future.value([]);
   }
+
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Stream<PdfCombinerProgress> get progressStream =>
+      Stream.error(PdfCombinerException('error'));
+
+  @override
+  Future<bool> cancel(String jobId) {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Future<Map<String, Object?>?> getNativeStats() {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) {
+    throw PdfCombinerException('error');
+  }
+
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) {
+    throw PdfCombinerException('error');
+  }
 }
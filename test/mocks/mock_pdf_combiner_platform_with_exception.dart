@@ -1,13 +1,27 @@
+import 'dart:typed_data';
+
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 
 class MockPdfCombinerPlatformWithException
     with MockPlatformInterfaceMixin
     implements PdfCombinerPlatform {
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => false;
+
   /// Mocks the `mergeMultiplePDF` method.
   ///
   /// Simulates combining multiple PDFs into a single PDF. It returns a mock result
@@ -19,6 +33,18 @@ class MockPdfCombinerPlatformWithException
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `mergeMultiplePDFToBytes` method.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
   }) {
     throw PdfCombinerException("Mocked Exception");
   }
@@ -58,4 +84,68 @@ class MockPdfCombinerPlatformWithException
   }) {
     throw PdfCombinerException("Mocked Exception");
   }
+
+  /// Mocks the `createImageFromPDFToBytes` method.
+  ///
+  /// Simulates an exception thrown while rendering the pages.
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `createThumbnailsFromPDF` method.
+  ///
+  /// Simulates an exception thrown while creating the thumbnails.
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `progressStream` getter.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Stream<PdfCombinerProgress> get progressStream =>
+      Stream.error(PdfCombinerException("Mocked Exception"));
+
+  /// Mocks the `cancel` method.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Future<bool> cancel(String jobId) {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `getNativeStats` method.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Future<Map<String, Object?>?> getNativeStats() {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `runBatch` method.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) {
+    throw PdfCombinerException("Mocked Exception");
+  }
+
+  /// Mocks the `configureDocumentCache` method.
+  ///
+  /// Simulates an exception thrown by the native platform.
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) {
+    throw PdfCombinerException("Mocked Exception");
+  }
 }
@@ -6,6 +6,7 @@ import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart'
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
 import 'package:pdf_combiner/pdf_combiner.dart';
+import 'package:pdf_combiner/responses/pdf_combiner_messages.dart';
 
 import 'mocks/mock_pdf_combiner_platform.dart';
 import 'mocks/mock_pdf_combiner_platform_with_error.dart';
@@ -87,6 +88,42 @@ void main() {
       );
     });
 
+    test('mergeMultiplePDFs with page selections', () async {
+      PdfCombinerPlatform.instance = MockPdfCombinerPlatform();
+
+      final result = await PdfCombiner.mergeMultiplePDFs(
+        inputs: [
+          MergeInput.path('example/assets/document_1.pdf', pages: '1-3,7,10-'),
+          MergeInput.path('example/assets/document_2.pdf'),
+        ],
+        outputPath: 'output/path.pdf',
+      );
+
+      expect(result, 'output/path.pdf');
+    });
+
+    test('mergeMultiplePDFs rejects page selections the platform ignores',
+        () async {
+      PdfCombinerPlatform.instance = MockPdfCombinerPlatformWithError();
+
+      expect(
+        () => PdfCombiner.mergeMultiplePDFs(
+          inputs: [
+            MergeInput.path('example/assets/document_1.pdf', pages: '2'),
+          ],
+          outputPath: 'output/path.pdf',
+        ),
+        throwsA(
+          predicate(
+            (e) =>
+                e is PdfCombinerException &&
+                e.message ==
+                    PdfCombinerMessages.errorMessagePageRangesUnsupported,
+          ),
+        ),
+      );
+    });
+
     test('combine - Error empty inputPaths', () async {
       MockPdfCombinerPlatformWithError fakePlatformWithError =
           MockPdfCombinerPlatformWithError();
@@ -169,6 +206,54 @@ void main() {
       );
     });
 
+    test('mergeMultiplePDFsToBytes returns the merged bytes', () async {
+      MockPdfCombinerPlatform fakePlatform = MockPdfCombinerPlatform();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      final result = await PdfCombiner.mergeMultiplePDFsToBytes(
+        inputs: [
+          MergeInput.path('example/assets/document_1.pdf'),
+          MergeInput.bytes(
+              File('example/assets/document_2.pdf').readAsBytesSync()),
+        ],
+      );
+
+      expect(result, [0x25, 0x50, 0x44, 0x46]);
+    });
+
+    test('mergeMultiplePDFsToBytes - Error empty inputs', () async {
+      MockPdfCombinerPlatform fakePlatform = MockPdfCombinerPlatform();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      expect(
+        () => PdfCombiner.mergeMultiplePDFsToBytes(inputs: []),
+        throwsA(
+          predicate(
+            (e) =>
+                e is PdfCombinerException &&
+                e.message == 'The parameter (inputPaths) cannot be empty',
+          ),
+        ),
+      );
+    });
+
+    test('mergeMultiplePDFsToBytes - Error in processing', () async {
+      MockPdfCombinerPlatformWithError fakePlatform =
+          MockPdfCombinerPlatformWithError();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      expect(
+        () => PdfCombiner.mergeMultiplePDFsToBytes(
+          inputs: [MergeInput.path('example/assets/document_1.pdf')],
+        ),
+        throwsA(
+          predicate(
+            (e) => e is PdfCombinerException && e.message == 'error',
+          ),
+        ),
+      );
+    });
+
     test('combine - Error in processing (duplicate case)', () async {
       MockPdfCombinerPlatformWithError fakePlatformWithError =
           MockPdfCombinerPlatformWithError();
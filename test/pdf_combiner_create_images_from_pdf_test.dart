@@ -1,9 +1,11 @@
 import 'package:flutter_test/flutter_test.dart';
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/image_format.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
 import 'package:pdf_combiner/models/image_scale.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:pdf_combiner/pdf_combiner.dart';
 
 import 'mocks/mock_pdf_combiner_platform.dart';
@@ -119,5 +121,79 @@ void main() {
       expect(
           result, ['$outputDirPath/image1.png', '$outputDirPath/image2.png']);
     });
+
+    test('createImageFromPDFToBytes - Error in processing', () async {
+      MockPdfCombinerPlatformWithError fakePlatform =
+          MockPdfCombinerPlatformWithError();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      expect(
+        () => PdfCombiner.createImageFromPDFToBytes(
+          input: MergeInput.path('example/assets/document_1.pdf'),
+        ),
+        throwsA(
+          predicate(
+            (e) => e is PdfCombinerException && e.message == 'error',
+          ),
+        ),
+      );
+    });
+
+    test('createImageFromPDFToBytes - success', () async {
+      MockPdfCombinerPlatform fakePlatform = MockPdfCombinerPlatform();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      final result = await PdfCombiner.createImageFromPDFToBytes(
+        input: MergeInput.path('example/assets/document_1.pdf'),
+      );
+
+      expect(result.map((page) => page.page), [1, 2]);
+      expect(result.first.format, ImageFormat.png);
+      expect(result.first.bytes, isNotEmpty);
+    });
+
+    test('createThumbnailsFromPDF - Error in processing', () async {
+      MockPdfCombinerPlatformWithError fakePlatform =
+          MockPdfCombinerPlatformWithError();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      expect(
+        () => PdfCombiner.createThumbnailsFromPDF(
+          input: MergeInput.path('example/assets/document_1.pdf'),
+          outputDirPath: 'output/path',
+        ),
+        throwsA(
+          predicate(
+            (e) => e is PdfCombinerException && e.message == 'error',
+          ),
+        ),
+      );
+    });
+
+    test('createThumbnailsFromPDF - success', () async {
+      MockPdfCombinerPlatform fakePlatform = MockPdfCombinerPlatform();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      final outputDirPath = 'output/path';
+
+      final result = await PdfCombiner.createThumbnailsFromPDF(
+        input: MergeInput.path('example/assets/document_1.pdf'),
+        outputDirPath: outputDirPath,
+        config: const ThumbnailConfig(maxSize: 128),
+      );
+
+      expect(result, [
+        '$outputDirPath/thumbnail_1.png',
+        '$outputDirPath/thumbnail_2.png',
+      ]);
+    });
+
+    test('cancel - reports whether a running job was found', () async {
+      MockPdfCombinerPlatform fakePlatform = MockPdfCombinerPlatform();
+      PdfCombinerPlatform.instance = fakePlatform;
+
+      expect(await PdfCombiner.cancel('render-1'), isTrue);
+      expect(await PdfCombiner.cancel('unknown'), isFalse);
+    });
   });
 }
@@ -1,13 +1,20 @@
 import 'package:flutter_test/flutter_test.dart';
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:pdf_combiner/pdf_combiner.dart';
 import 'package:pdf_combiner/responses/pdf_combiner_messages.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
 import 'dart:io' as java;
+import 'dart:typed_data';
 
 class MockPdfCombinerPlatformCustomError
     with MockPlatformInterfaceMixin
@@ -16,10 +23,17 @@ class MockPdfCombinerPlatformCustomError
 
   MockPdfCombinerPlatformCustomError(this.errorMessage);
 
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => false;
+
   @override
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) {
     return Future.value(errorMessage);
   }
@@ -41,15 +55,66 @@ class MockPdfCombinerPlatformCustomError
   }) {
     return Future.value([errorMessage]);
   }
+
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    return Future.value(const []);
+  }
+
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    return Future.value([errorMessage]);
+  }
+
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    return Future.value(Uint8List.fromList(errorMessage.codeUnits));
+  }
+
+  @override
+  Stream<PdfCombinerProgress> get progressStream => const Stream.empty();
+
+  @override
+  Future<bool> cancel(String jobId) => Future.value(false);
+
+  @override
+  Future<Map<String, Object?>?> getNativeStats() => Future.value(null);
+
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) =>
+      Future.value([]);
+
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) =>
+      Future.value(false);
 }
 
 class MockPdfCombinerPlatformNullResponse
     with MockPlatformInterfaceMixin
     implements PdfCombinerPlatform {
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => false;
+
   @override
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) {
     return Future.value(null);
   }
@@ -71,6 +136,50 @@ class MockPdfCombinerPlatformNullResponse
   }) {
     return Future.value(null);
   }
+
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    return Future.value(const []);
+  }
+
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    return Future.value(null);
+  }
+
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    return Future.value(null);
+  }
+
+  @override
+  Stream<PdfCombinerProgress> get progressStream => const Stream.empty();
+
+  @override
+  Future<bool> cancel(String jobId) => Future.value(false);
+
+  @override
+  Future<Map<String, Object?>?> getNativeStats() => Future.value(null);
+
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) =>
+      Future.value([]);
+
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) =>
+      Future.value(false);
 }
 
 void main() {
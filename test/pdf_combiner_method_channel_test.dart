@@ -1,9 +1,17 @@
+import 'dart:typed_data';
+
 import 'package:flutter/services.dart';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:pdf_combiner/communication/pdf_combiner_method_channel.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/image_compression.dart';
+import 'package:pdf_combiner/models/image_format.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
 import 'package:pdf_combiner/models/image_scale.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/render_config.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 
 void main() {
   TestWidgetsFlutterBinding.ensureInitialized();
@@ -43,6 +51,29 @@ void main() {
     expect(result, 'merged.pdf');
   });
 
+  test('mergeMultiplePDFsToBytes sends paths and bytes', () async {
+    final pdfBytes = Uint8List.fromList([0x25, 0x50, 0x44, 0x46]);
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDFToBytes') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf', pdfBytes],
+        });
+        return pdfBytes;
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFsToBytes(
+      inputs: [
+        MergeInput.path('file1.pdf'),
+        MergeInput.bytes(pdfBytes),
+      ],
+    );
+
+    expect(result, pdfBytes);
+  });
+
   test('createPDFFromMultipleImages calls method channel correctly', () async {
     TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
         .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
@@ -96,4 +127,470 @@ void main() {
 
     expect(result, ['image1.png', 'image2.png']);
   });
+
+  test('createImageFromPDF sends the render size that is set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'createImageFromPDF') {
+        expect(methodCall.arguments['dpi'], 150.0);
+        expect(methodCall.arguments['maxPixels'], 4000000);
+        expect(methodCall.arguments.containsKey('scale'), isFalse);
+        expect(methodCall.arguments.containsKey('maxWidth'), isFalse);
+        return ['image1.png'];
+      }
+      return null;
+    });
+
+    final result = await platform.createImageFromPDF(
+      input: MergeInput.path('file.pdf'),
+      outputPath: '/output/path',
+      config: const ImageFromPdfConfig(
+          render: RenderConfig(dpi: 150, maxPixels: 4000000)),
+    );
+
+    expect(result, ['image1.png']);
+  });
+
+  test('createImageFromPDF sends the output format when not PNG', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'createImageFromPDF') {
+        expect(methodCall.arguments['outputFormat'], 'jpeg');
+        expect(methodCall.arguments['compression'], 60);
+        return ['/output/path/image_1.jpg'];
+      }
+      return null;
+    });
+
+    final result = await platform.createImageFromPDF(
+      input: MergeInput.path('file.pdf'),
+      outputPath: '/output/path',
+      config: const ImageFromPdfConfig(
+          outputFormat: ImageFormat.jpeg,
+          compression: ImageCompression.medium),
+    );
+
+    expect(result, ['/output/path/image_1.jpg']);
+  });
+
+  test('mergeMultiplePDFs sends the page selections when any is set',
+      () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDF') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf', 'file2.pdf'],
+          'outputDirPath': '/output/path',
+          'pageRanges': ['1-3,7,10-', null],
+        });
+        return 'merged.pdf';
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFs(
+      inputs: [
+        MergeInput.path('file1.pdf', pages: '1-3,7,10-'),
+        MergeInput.path('file2.pdf'),
+      ],
+      outputPath: '/output/path',
+    );
+
+    expect(result, 'merged.pdf');
+  });
+
+  test('mergeMultiplePDFsToBytes sends linearize when set', () async {
+    final pdfBytes = Uint8List.fromList([0x25, 0x50, 0x44, 0x46]);
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDFToBytes') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf'],
+          'linearize': true,
+        });
+        return pdfBytes;
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFsToBytes(
+      inputs: [MergeInput.path('file1.pdf')],
+      config: const MergeConfig(linearize: true),
+    );
+
+    expect(result, pdfBytes);
+  });
+
+  test('mergeMultiplePDFs sends streaming when set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDF') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf', 'file2.pdf'],
+          'outputDirPath': 'merged.pdf',
+          'streaming': true,
+        });
+        return 'merged.pdf';
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFs(
+      inputs: [MergeInput.path('file1.pdf'), MergeInput.path('file2.pdf')],
+      outputPath: 'merged.pdf',
+      config: const MergeConfig(streaming: true),
+    );
+
+    expect(result, 'merged.pdf');
+  });
+
+  test('mergeMultiplePDFsToBytes sends deduplicate when set', () async {
+    final pdfBytes = Uint8List.fromList([0x25, 0x50, 0x44, 0x46]);
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDFToBytes') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf'],
+          'deduplicate': true,
+        });
+        return pdfBytes;
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFsToBytes(
+      inputs: [MergeInput.path('file1.pdf')],
+      config: const MergeConfig(deduplicate: true),
+    );
+
+    expect(result, pdfBytes);
+  });
+
+  test('mergeMultiplePDFs sends compact when set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDF') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf'],
+          'outputDirPath': 'merged.pdf',
+          'compact': true,
+        });
+        return 'merged.pdf';
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFs(
+      inputs: [MergeInput.path('file1.pdf')],
+      outputPath: 'merged.pdf',
+      config: const MergeConfig(compact: true),
+    );
+
+    expect(result, 'merged.pdf');
+  });
+
+  test('mergeMultiplePDFs sends the image options when set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'mergeMultiplePDF') {
+        expect(methodCall.arguments, {
+          'paths': ['file1.pdf'],
+          'outputDirPath': 'merged.pdf',
+          'targetBytes': 20000000,
+          'imageQuality': 60,
+        });
+        return 'merged.pdf';
+      }
+      return null;
+    });
+
+    final result = await platform.mergeMultiplePDFs(
+      inputs: [MergeInput.path('file1.pdf')],
+      outputPath: 'merged.pdf',
+      config: const MergeConfig(targetBytes: 20000000, imageQuality: 60),
+    );
+
+    expect(result, 'merged.pdf');
+  });
+
+  test('createImageFromPDF sends the jobId when set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'createImageFromPDF') {
+        expect(methodCall.arguments['jobId'], 'render-1');
+        return ['image1.png'];
+      }
+      return null;
+    });
+
+    final result = await platform.createImageFromPDF(
+      input: MergeInput.path('file.pdf'),
+      outputPath: '/output/path',
+      config: const ImageFromPdfConfig(jobId: 'render-1'),
+    );
+
+    expect(result, ['image1.png']);
+  });
+
+  test('createThumbnailsFromPDF calls method channel correctly', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'createThumbnailsFromPDF') {
+        expect(methodCall.arguments, {
+          'path': 'file.pdf',
+          'outputDirPath': '/output/path',
+          'maxSize': 128,
+          'compression': 0,
+          'pages': '1-2',
+        });
+        return ['/output/path/thumbnail_1.png', '/output/path/thumbnail_2.png'];
+      }
+      return null;
+    });
+
+    final result = await platform.createThumbnailsFromPDF(
+      input: MergeInput.path('file.pdf'),
+      outputPath: '/output/path',
+      config: const ThumbnailConfig(maxSize: 128, pages: '1-2'),
+    );
+
+    expect(result,
+        ['/output/path/thumbnail_1.png', '/output/path/thumbnail_2.png']);
+  });
+
+  test('createImageFromPDFToBytes calls method channel correctly', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'createImageFromPDFToBytes') {
+        expect(methodCall.arguments, {
+          'path': 'file.pdf',
+          'height': 0,
+          'width': 0,
+          'compression': 0,
+          'outputFormat': 'bgra',
+          'pages': '2',
+        });
+        return [
+          {
+            'page': 2,
+            'width': 1,
+            'height': 2,
+            'format': 'bgra',
+            'stride': 4,
+            'bytes': Uint8List.fromList([1, 2, 3, 255, 4, 5, 6, 255]),
+          },
+        ];
+      }
+      return null;
+    });
+
+    final result = await platform.createImageFromPDFToBytes(
+      input: MergeInput.path('file.pdf'),
+      config: const ImageFromPdfConfig(outputFormat: ImageFormat.bgra),
+      pages: '2',
+    );
+
+    expect(result, hasLength(1));
+    expect(result.first.page, 2);
+    expect(result.first.width, 1);
+    expect(result.first.height, 2);
+    expect(result.first.format, ImageFormat.bgra);
+    expect(result.first.stride, 4);
+    expect(result.first.bytes, [1, 2, 3, 255, 4, 5, 6, 255]);
+  });
+
+  test('cancel calls method channel correctly', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'cancel') {
+        expect(methodCall.arguments, {'jobId': 'render-1'});
+        return true;
+      }
+      return null;
+    });
+
+    expect(await platform.cancel('render-1'), isTrue);
+  });
+
+  test('cancel returns false when the platform does not support it', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      throw MissingPluginException();
+    });
+
+    expect(await platform.cancel('render-1'), isFalse);
+  });
+
+  test('progressStream decodes the events of the progress channel', () async {
+    const EventChannel progressChannel = EventChannel('pdf_combiner/progress');
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockStreamHandler(
+      progressChannel,
+      MockStreamHandler.inline(onListen: (arguments, events) {
+        events.success({
+          'method': 'createImageFromPDF',
+          'pagesDone': 3,
+          'totalPages': 4,
+          'finished': true,
+        });
+        events.endOfStream();
+      }),
+    );
+
+    final events = await platform.progressStream.toList();
+
+    expect(events, hasLength(1));
+    expect(events.single.method, 'createImageFromPDF');
+    expect(events.single.fraction, 0.75);
+    expect(events.single.finished, isTrue);
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockStreamHandler(progressChannel, null);
+  });
+
+  test('getNativeStats calls method channel correctly', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'getNativeStats') {
+        return {'queueDepth': 3, 'runningJobs': 1};
+      }
+      return null;
+    });
+
+    final result = await platform.getNativeStats();
+
+    expect(result, {'queueDepth': 3, 'runningJobs': 1});
+  });
+
+  test('getNativeStats returns null when the platform has no stats', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      throw MissingPluginException();
+    });
+
+    final result = await platform.getNativeStats();
+
+    expect(result, isNull);
+  });
+
+  test('configureDocumentCache sends the budget that is set', () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      if (methodCall.method == 'configureDocumentCache') {
+        expect(methodCall.arguments, {'maxDocuments': 4});
+        return true;
+      }
+      return null;
+    });
+
+    expect(await platform.configureDocumentCache(maxDocuments: 4), isTrue);
+  });
+
+  test('configureDocumentCache returns false without a document cache',
+      () async {
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      throw MissingPluginException();
+    });
+
+    expect(await platform.configureDocumentCache(maxBytes: 1 << 20), isFalse);
+  });
+
+  test('runBatch sends every job in one call', () async {
+    final calls = <MethodCall>[];
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      calls.add(methodCall);
+      return [
+        {'success': true, 'result': '/out/merged.pdf'},
+        {'success': true, 'result': ['/out/image_1.png']},
+        {
+          'success': false,
+          'code': 'document_loading_failed',
+          'message': 'Failed to load document: missing.pdf',
+        },
+      ];
+    });
+
+    final results = await platform.runBatch([
+      BatchJob.merge(
+        inputs: [MergeInput.path('a.pdf'), MergeInput.path('b.pdf')],
+        outputPath: '/out/merged.pdf',
+        config: const MergeConfig(compact: true),
+      ),
+      BatchJob.createImageFromPDF(
+        input: MergeInput.path('a.pdf'),
+        outputDirPath: '/out',
+      ),
+      BatchJob.merge(
+        inputs: [MergeInput.path('missing.pdf')],
+        outputPath: '/out/other.pdf',
+      ),
+    ], jobId: 'nightly');
+
+    expect(calls, hasLength(1));
+    expect(calls.single.method, 'runBatch');
+    expect(calls.single.arguments, {
+      'jobs': [
+        {
+          'method': 'mergeMultiplePDF',
+          'arguments': {
+            'paths': ['a.pdf', 'b.pdf'],
+            'outputDirPath': '/out/merged.pdf',
+            'compact': true,
+          },
+        },
+        {
+          'method': 'createImageFromPDF',
+          'arguments': {
+            'path': 'a.pdf',
+            'outputDirPath': '/out',
+            'height': 0,
+            'width': 0,
+            'compression': 0,
+            'createOneImage': false,
+          },
+        },
+        {
+          'method': 'mergeMultiplePDF',
+          'arguments': {
+            'paths': ['missing.pdf'],
+            'outputDirPath': '/out/other.pdf',
+          },
+        },
+      ],
+      'jobId': 'nightly',
+    });
+    expect(results.map((result) => result.success), [true, true, false]);
+    expect(results[0].result, '/out/merged.pdf');
+    expect(results[1].result, ['/out/image_1.png']);
+    expect(results[2].errorCode, 'document_loading_failed');
+  });
+
+  test('runBatch runs the jobs one by one without native support', () async {
+    final methods = <String>[];
+    TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger
+        .setMockMethodCallHandler(testChannel, (MethodCall methodCall) async {
+      methods.add(methodCall.method);
+      switch (methodCall.method) {
+        case 'runBatch':
+          throw MissingPluginException();
+        case 'mergeMultiplePDF':
+          return '/out/merged.pdf';
+        default:
+          throw PlatformException(code: 'image_save_failed');
+      }
+    });
+
+    final results = await platform.runBatch([
+      BatchJob.merge(
+          inputs: [MergeInput.path('a.pdf')], outputPath: '/out/merged.pdf'),
+      BatchJob.createImageFromPDF(
+          input: MergeInput.path('a.pdf'), outputDirPath: '/out'),
+    ]);
+
+    expect(methods, ['runBatch', 'mergeMultiplePDF', 'createImageFromPDF']);
+    expect(results[0].result, '/out/merged.pdf');
+    expect(results[1].success, isFalse);
+    expect(results[1].errorCode, 'image_save_failed');
+  });
 }
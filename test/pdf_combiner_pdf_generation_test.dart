@@ -4,9 +4,16 @@ import 'dart:typed_data';
 import 'package:flutter_test/flutter_test.dart';
 import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
 import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/batch_job.dart';
+import 'package:pdf_combiner/models/batch_job_result.dart';
+import 'package:pdf_combiner/models/image_format.dart';
 import 'package:pdf_combiner/models/image_from_pdf_config.dart';
+import 'package:pdf_combiner/models/merge_config.dart';
 import 'package:pdf_combiner/models/merge_input.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
 import 'package:pdf_combiner/models/pdf_from_multiple_image_config.dart';
+import 'package:pdf_combiner/models/rendered_page.dart';
+import 'package:pdf_combiner/models/thumbnail_config.dart';
 import 'package:pdf_combiner/pdf_combiner.dart';
 import 'package:pdf_combiner/utils/document_utils.dart';
 import 'package:plugin_platform_interface/plugin_platform_interface.dart';
@@ -14,10 +21,17 @@ import 'package:plugin_platform_interface/plugin_platform_interface.dart';
 class MockPdfCombinerPlatformSuccess
     with MockPlatformInterfaceMixin
     implements PdfCombinerPlatform {
+  @override
+  bool get supportsInMemoryInputs => false;
+
+  @override
+  bool get supportsPageRanges => false;
+
   @override
   Future<String?> mergeMultiplePDFs({
     required List<MergeInput> inputs,
     required String outputPath,
+    MergeConfig config = const MergeConfig(),
   }) {
     return Future.value(outputPath);
   }
@@ -42,6 +56,58 @@ class MockPdfCombinerPlatformSuccess
   }) {
     return Future.value(['$outputPath/image1.png']);
   }
+
+  @override
+  Future<List<RenderedPage>> createImageFromPDFToBytes({
+    required MergeInput input,
+    ImageFromPdfConfig config = const ImageFromPdfConfig(),
+    String? pages,
+  }) {
+    return Future.value([
+      RenderedPage(
+        page: 1,
+        width: 10,
+        height: 20,
+        format: ImageFormat.png,
+        bytes: Uint8List.fromList([137, 80, 78, 71]),
+      ),
+    ]);
+  }
+
+  @override
+  Future<List<String>?> createThumbnailsFromPDF({
+    required MergeInput input,
+    required String outputPath,
+    ThumbnailConfig config = const ThumbnailConfig(),
+  }) {
+    return Future.value(['$outputPath/thumbnail_1.png']);
+  }
+
+  @override
+  Future<Uint8List?> mergeMultiplePDFsToBytes({
+    required List<MergeInput> inputs,
+    MergeConfig config = const MergeConfig(),
+  }) {
+    return Future.value(Uint8List.fromList([0x25, 0x50, 0x44, 0x46]));
+  }
+
+  @override
+  Stream<PdfCombinerProgress> get progressStream => const Stream.empty();
+
+  @override
+  Future<bool> cancel(String jobId) => Future.value(false);
+
+  @override
+  Future<Map<String, Object?>?> getNativeStats() => Future.value(null);
+
+  @override
+  Future<List<BatchJobResult>> runBatch(List<BatchJob> jobs,
+      {String? jobId}) =>
+      Future.value([]);
+
+  @override
+  Future<bool> configureDocumentCache({int? maxDocuments, int? maxBytes}) =>
+      Future.value(false);
 }
 
 void main() {
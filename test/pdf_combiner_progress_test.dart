@@ -0,0 +1,66 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:pdf_combiner/communication/pdf_combiner_platform_interface.dart';
+import 'package:pdf_combiner/exception/pdf_combiner_exception.dart';
+import 'package:pdf_combiner/models/pdf_combiner_progress.dart';
+import 'package:pdf_combiner/pdf_combiner.dart';
+
+import 'mocks/mock_pdf_combiner_platform.dart';
+import 'mocks/mock_pdf_combiner_platform_with_exception.dart';
+
+void main() {
+  group('PdfCombinerProgress', () {
+    test('fromMap reads every field of a platform event', () {
+      final progress = PdfCombinerProgress.fromMap({
+        'method': 'mergeMultiplePDF',
+        'jobId': 'merge-1',
+        'documentsDone': 1,
+        'documentCount': 3,
+        'pagesDone': 10,
+        'totalPages': 40,
+        'bytesWritten': 2048,
+        'elapsedMicros': 1500,
+        'finished': false,
+      });
+
+      expect(progress.method, 'mergeMultiplePDF');
+      expect(progress.jobId, 'merge-1');
+      expect(progress.documentsDone, 1);
+      expect(progress.documentCount, 3);
+      expect(progress.pagesDone, 10);
+      expect(progress.totalPages, 40);
+      expect(progress.bytesWritten, 2048);
+      expect(progress.elapsed, const Duration(microseconds: 1500));
+      expect(progress.finished, isFalse);
+      expect(progress.fraction, 0.25);
+    });
+
+    test('fromMap uses defaults for missing fields', () {
+      final progress = PdfCombinerProgress.fromMap({'method': 'x'});
+
+      expect(progress.jobId, isNull);
+      expect(progress.totalPages, 0);
+      expect(progress.elapsed, Duration.zero);
+      expect(progress.fraction, isNull);
+    });
+  });
+
+  group('PdfCombiner progressStream', () {
+    test('progressStream forwards the platform events', () async {
+      PdfCombinerPlatform.instance = MockPdfCombinerPlatform();
+
+      final events = await PdfCombiner.progressStream.toList();
+
+      expect(events.map((e) => e.pagesDone), [1, 2]);
+      expect(events.last.finished, isTrue);
+    });
+
+    test('progressStream forwards platform errors', () async {
+      PdfCombinerPlatform.instance = MockPdfCombinerPlatformWithException();
+
+      expect(
+        PdfCombiner.progressStream.toList(),
+        throwsA(isA<PdfCombinerException>()),
+      );
+    });
+  });
+}
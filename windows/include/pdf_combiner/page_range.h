@@ -0,0 +1,55 @@
+#ifndef PDF_COMBINER_PAGE_RANGE_H_
+#define PDF_COMBINER_PAGE_RANGE_H_
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace pdf_combiner {
+    // Parses a page selection such as "1-3,7,10-" into zero-based page indices,
+    // in the order written, for FPDF_ImportPagesByIndex.
+    //
+    // Pages are numbered from 1. Each comma separated item is a page ("7"), a
+    // range ("1-3"), or an open range running to the last ("10-") or from the
+    // first page ("-3"). Spaces are ignored and pages may repeat. Returns false if
+    // the selection is malformed, empty, or names a page outside 1..page_count.
+    inline bool parse_page_range(const std::string& range, int page_count, std::vector<int>& indices) {
+        indices.clear();
+        std::string text;
+        for (char c : range) {
+            if (!isspace((unsigned char)c)) text += c;
+        }
+
+        // Reads a page number at `pos`, 0 if there is none
+        auto read_number = [&text](size_t& pos) {
+            long value = 0;
+            while (pos < text.size() && isdigit((unsigned char)text[pos])) {
+                value = value * 10 + (text[pos++] - '0');
+                if (value > 1000000000L) return -1L;
+            }
+            return value;
+        };
+
+        size_t pos = 0;
+        while (pos < text.size()) {
+            long first = read_number(pos);
+            long last = first;
+            if (pos < text.size() && text[pos] == '-') {
+                pos++;
+                last = read_number(pos);
+                if (first == 0) first = 1;
+                if (last == 0) last = page_count;
+            }
+            if (pos < text.size() && text[pos] != ',') return false;
+            pos++;  // skip the comma
+
+            if (first < 1 || last < first || last > page_count) return false;
+            for (long page = first; page <= last; ++page) {
+                indices.push_back((int)(page - 1));
+            }
+        }
+        return !indices.empty();
+    }
+}
+
+#endif  // PDF_COMBINER_PAGE_RANGE_H_
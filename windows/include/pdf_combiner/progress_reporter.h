@@ -0,0 +1,60 @@
+#ifndef PDF_COMBINER_PROGRESS_REPORTER_H_
+#define PDF_COMBINER_PROGRESS_REPORTER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace pdf_combiner {
+    // Progress of a running method call, sent on the pdf_combiner/progress
+    // event channel.
+    struct ProgressEvent {
+        std::string method;
+        std::string job_id;  // empty when the call has no jobId
+        int documents_done = 0;
+        int document_count = 0;
+        int pages_done = 0;
+        int total_pages = 0;
+        uint64_t bytes_written = 0;
+        uint64_t elapsed_micros = 0;
+        bool finished = false;
+    };
+
+    typedef std::function<void(const ProgressEvent&)> ProgressListener;
+
+    // Counts the work done by one method call and forwards it to `listener`
+    // at most every kIntervalMillis. The last event, sent when the reporter
+    // is destroyed, is never throttled and has `finished` set. An empty
+    // listener turns reporting into a few counter updates.
+    class ProgressReporter {
+    public:
+        static constexpr int kIntervalMillis = 100;
+
+        ProgressReporter(const std::string& method, const std::string& job_id, int document_count,
+                         ProgressListener listener);
+        ~ProgressReporter();
+
+        ProgressReporter(const ProgressReporter&) = delete;
+        ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+        // Adds pages to the total, as inputs are opened.
+        void AddPages(int pages);
+
+        // Records finished pages and the output bytes they produced.
+        void Advance(int pages, uint64_t bytes = 0);
+
+        void DocumentDone();
+
+    private:
+        void MaybeSend();
+        void Send(std::chrono::steady_clock::time_point now);
+
+        ProgressListener listener_;
+        std::chrono::steady_clock::time_point start_;
+        std::chrono::steady_clock::time_point last_sent_;
+        ProgressEvent event_;
+    };
+}
+
+#endif  // PDF_COMBINER_PROGRESS_REPORTER_H_
@@ -0,0 +1,18 @@
+#ifndef PDF_COMBINER_SWIZZLE_H_
+#define PDF_COMBINER_SWIZZLE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pdf_combiner {
+    // Converts between BGRA and RGBA by swapping the first and third byte of
+    // every pixel, optionally flipping the image vertically in the same pass.
+    // Strides are in bytes. Uses AVX2, SSSE3 or NEON when the CPU has them.
+    void swizzle_rgba_bgra(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                           int width, int height, bool flip_vertically);
+
+    // Name of the kernel picked for this CPU, for diagnostics.
+    const char* swizzle_kernel_name();
+}
+
+#endif  // PDF_COMBINER_SWIZZLE_H_
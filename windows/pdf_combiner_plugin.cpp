@@ -8,11 +8,14 @@
 #include <windows.h>
 #include <objbase.h>
 
+#include <flutter/event_channel.h>
+#include <flutter/event_stream_handler_functions.h>
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar_windows.h>
 #include <flutter/standard_method_codec.h>
 
 #include <memory>
+#include <filesystem>
 #include <sstream>
 #include <algorithm>
 #include <vector>
@@ -27,6 +30,7 @@
 #include "include/pdfium/fpdf_ppo.h"
 
 #include "include/pdf_combiner/my_file_write.h"
+#include "include/pdf_combiner/page_range.h"
 #include "include/pdf_combiner/save_bitmap_to_png.h"
 
 #include "include/pdf_combiner/stb_image.h"
@@ -49,7 +53,8 @@ namespace pdf_combiner {
         return (written == size) ? 1 : 0;
     }
 
-    std::string ProcessHeic(const std::string& path) {
+    // Decodes a HEIC/HEIF file into tightly packed RGB pixels.
+    bool ProcessHeic(const std::string& path, int& width, int& height, std::vector<unsigned char>& rgb) {
 #ifdef HAS_HEIF
         // Suppress stderr during HEIF initialization to hide "LoadLibraryA error: 193"
         // This error usually happens because libheif scans for plugins and finds incompatible (32-bit) DLLs,
@@ -72,37 +77,77 @@ namespace pdf_combiner {
         }
         _close(saved_stderr);
 
-        if (err.code != heif_error_Ok) { heif_context_free(ctx); return ""; }
+        if (err.code != heif_error_Ok) { heif_context_free(ctx); return false; }
 
         heif_image_handle* handle = nullptr;
         err = heif_context_get_primary_image_handle(ctx, &handle);
-        if (err.code != heif_error_Ok) { heif_context_free(ctx); return ""; }
+        if (err.code != heif_error_Ok) { heif_context_free(ctx); return false; }
 
         heif_image* img = nullptr;
         err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, nullptr);
         if (err.code != heif_error_Ok) {
             heif_image_handle_release(handle);
             heif_context_free(ctx);
-            return "";
+            return false;
         }
 
-        int width = heif_image_get_width(img, heif_channel_interleaved);
-        int height = heif_image_get_height(img, heif_channel_interleaved);
+        width = heif_image_get_width(img, heif_channel_interleaved);
+        height = heif_image_get_height(img, heif_channel_interleaved);
         int stride;
         const uint8_t* data = heif_image_get_plane_readonly(img, heif_channel_interleaved, &stride);
 
-        std::string out_jpg = path + ".tmp.jpg";
-        int success = stbi_write_jpg(out_jpg.c_str(), width, height, 3, data, 85);
+        // Copy row by row, the plane stride can be padded
+        bool success = data && width > 0 && height > 0;
+        if (success) {
+            size_t row_size = (size_t)width * 3;
+            rgb.resize(row_size * height);
+            for (int y = 0; y < height; y++) {
+                memcpy(rgb.data() + y * row_size, data + (size_t)y * stride, row_size);
+            }
+        }
 
         heif_image_release(img);
         heif_image_handle_release(handle);
         heif_context_free(ctx);
-        return success ? out_jpg : "";
+        return success;
 #else
-        return "";
+        return false;
 #endif
     }
 
+    // Adds a page showing the given JPEG data, embedded as it is.
+    void AppendJpegPage(FPDF_DOCUMENT doc, const unsigned char* data, size_t size, int w, int h) {
+        FPDF_PAGE new_page = FPDFPage_New(doc, FPDF_GetPageCount(doc), (double)w, (double)h);
+        FPDF_PAGEOBJECT image_obj = FPDFPageObj_NewImageObj(doc);
+
+        FPDF_FILEACCESS access;
+        access.m_FileLen = (unsigned long)size;
+        access.m_Param = (void*)data;
+        access.m_GetBlock = [](void* param, unsigned long pos, unsigned char* buf, unsigned long sz) -> int {
+            memcpy(buf, (unsigned char*)param + pos, sz);
+            return 1;
+        };
+        FPDFImageObj_LoadJpegFileInline(nullptr, 0, image_obj, &access);
+        FPDFPageObj_Transform(image_obj, (double)w, 0, 0, (double)h, 0, 0);
+        FPDFPage_InsertObject(new_page, image_obj);
+        FPDFPage_GenerateContent(new_page);
+        FPDF_ClosePage(new_page);
+    }
+
+    // Returns the optional jobId of a call, empty if it has none.
+    std::string JobIdOf(const flutter::EncodableMap& args) {
+        auto it = args.find(flutter::EncodableValue("jobId"));
+        if (it == args.end() || !std::holds_alternative<std::string>(it->second)) return std::string();
+        return std::get<std::string>(it->second);
+    }
+
+    // Size of a written file, 0 if it cannot be read.
+    uint64_t FileSize(const std::string& path) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(std::filesystem::u8path(path), error);
+        return error ? 0 : (uint64_t)size;
+    }
+
     void PdfCombinerPlugin::RegisterWithRegistrar(flutter::PluginRegistrarWindows *registrar) {
         auto channel = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
                 registrar->messenger(), "pdf_combiner", &flutter::StandardMethodCodec::GetInstance());
@@ -110,9 +155,45 @@ namespace pdf_combiner {
         channel->SetMethodCallHandler([plugin_pointer = plugin.get()](const auto &call, auto result) {
             plugin_pointer->HandleMethodCall(call, std::move(result));
         });
+
+        // Progress of the running method calls, see ProgressReporter
+        plugin->progress_channel_ = std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+                registrar->messenger(), "pdf_combiner/progress", &flutter::StandardMethodCodec::GetInstance());
+        plugin->progress_channel_->SetStreamHandler(
+                std::make_unique<flutter::StreamHandlerFunctions<flutter::EncodableValue>>(
+                        [plugin_pointer = plugin.get()](const flutter::EncodableValue* arguments,
+                                                        std::unique_ptr<flutter::EventSink<flutter::EncodableValue>>&& events)
+                                -> std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> {
+                            plugin_pointer->progress_sink_ = std::move(events);
+                            return nullptr;
+                        },
+                        [plugin_pointer = plugin.get()](const flutter::EncodableValue* arguments)
+                                -> std::unique_ptr<flutter::StreamHandlerError<flutter::EncodableValue>> {
+                            plugin_pointer->progress_sink_.reset();
+                            return nullptr;
+                        }));
         registrar->AddPlugin(std::move(plugin));
     }
 
+    ProgressListener PdfCombinerPlugin::progress_listener() {
+        if (!progress_sink_) return ProgressListener();
+        return [this](const ProgressEvent& event) {
+            if (!progress_sink_) return;
+            flutter::EncodableMap value = {
+                {flutter::EncodableValue("method"), flutter::EncodableValue(event.method)},
+                {flutter::EncodableValue("documentsDone"), flutter::EncodableValue(event.documents_done)},
+                {flutter::EncodableValue("documentCount"), flutter::EncodableValue(event.document_count)},
+                {flutter::EncodableValue("pagesDone"), flutter::EncodableValue(event.pages_done)},
+                {flutter::EncodableValue("totalPages"), flutter::EncodableValue(event.total_pages)},
+                {flutter::EncodableValue("bytesWritten"), flutter::EncodableValue((int64_t)event.bytes_written)},
+                {flutter::EncodableValue("elapsedMicros"), flutter::EncodableValue((int64_t)event.elapsed_micros)},
+                {flutter::EncodableValue("finished"), flutter::EncodableValue(event.finished)},
+            };
+            if (!event.job_id.empty()) value[flutter::EncodableValue("jobId")] = flutter::EncodableValue(event.job_id);
+            progress_sink_->Success(flutter::EncodableValue(value));
+        };
+    }
+
     PdfCombinerPlugin::PdfCombinerPlugin() {
         // Prevent libheif from loading incompatible plugins from system path
         // by pointing the plugin path to a non-existent directory.
@@ -149,22 +230,54 @@ namespace pdf_combiner {
                                                 std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
         auto paths_it = args.find(flutter::EncodableValue("paths"));
         auto output_it = args.find(flutter::EncodableValue("outputDirPath"));
+        auto ranges_it = args.find(flutter::EncodableValue("pageRanges"));
         std::vector<std::string> input_paths;
+        std::vector<std::string> page_ranges;  // empty for all the pages
         if (paths_it != args.end() && std::holds_alternative<std::vector<flutter::EncodableValue>>(paths_it->second)) {
-            for (const auto& path_value : std::get<std::vector<flutter::EncodableValue>>(paths_it->second)) {
-                if (std::holds_alternative<std::string>(path_value)) input_paths.push_back(std::get<std::string>(path_value));
+            const auto& path_list = std::get<std::vector<flutter::EncodableValue>>(paths_it->second);
+            const std::vector<flutter::EncodableValue>* range_list = nullptr;
+            if (ranges_it != args.end()) range_list = std::get_if<std::vector<flutter::EncodableValue>>(&ranges_it->second);
+            for (size_t i = 0; i < path_list.size(); ++i) {
+                if (!std::holds_alternative<std::string>(path_list[i])) continue;
+                input_paths.push_back(std::get<std::string>(path_list[i]));
+                const std::string* range = (range_list && i < range_list->size())
+                        ? std::get_if<std::string>(&(*range_list)[i]) : nullptr;
+                page_ranges.push_back(range ? *range : std::string());
             }
         }
         std::string output_path = std::get<std::string>(output_it->second);
+        ProgressReporter progress("mergeMultiplePDF", JobIdOf(args), (int)input_paths.size(), progress_listener());
         FPDF_DOCUMENT new_doc = FPDF_CreateNewDocument();
         int total_pages = 0;
-        for (const auto& input_path : input_paths) {
+        std::vector<int> page_indices;
+        for (size_t i = 0; i < input_paths.size(); ++i) {
+            const std::string& input_path = input_paths[i];
             FPDF_DOCUMENT doc = FPDF_LoadDocument(input_path.c_str(), nullptr);
-            if (!doc) continue;
+            if (!doc) {
+                progress.DocumentDone();
+                continue;
+            }
             int page_count = FPDF_GetPageCount(doc);
-            FPDF_ImportPages(new_doc, doc, nullptr, total_pages);
+            page_indices.clear();
+            if (!page_ranges[i].empty()) {
+                if (!parse_page_range(page_ranges[i], page_count, page_indices)) {
+                    FPDF_CloseDocument(doc);
+                    FPDF_CloseDocument(new_doc);
+                    result->Error("invalid_page_range", "Invalid page range \"" + page_ranges[i] + "\" for document: " + input_path);
+                    return;
+                }
+                page_count = (int)page_indices.size();
+            }
+            progress.AddPages(page_count);
+            if (page_indices.empty()) {
+                FPDF_ImportPages(new_doc, doc, nullptr, total_pages);
+            } else {
+                FPDF_ImportPagesByIndex(new_doc, doc, page_indices.data(), (unsigned long)page_indices.size(), total_pages);
+            }
             total_pages += page_count;
+            progress.Advance(page_count);
             FPDF_CloseDocument(doc);
+            progress.DocumentDone();
         }
         MyFileWrite file_write;
         file_write.version = 1;
@@ -172,7 +285,10 @@ namespace pdf_combiner {
         file_write.filename = output_path.c_str();
         file_write.file = nullptr;
         FPDF_SaveAsCopy(new_doc, (FPDF_FILEWRITE*)&file_write, FPDF_NO_INCREMENTAL);
-        if (file_write.file) fclose(file_write.file);
+        if (file_write.file) {
+            progress.Advance(0, (uint64_t)_ftelli64(file_write.file));
+            fclose(file_write.file);
+        }
         FPDF_CloseDocument(new_doc);
         result->Success(flutter::EncodableValue(output_path));
     }
@@ -194,9 +310,15 @@ namespace pdf_combiner {
         int max_height = std::get<int>(height_it->second);
         bool keep_aspect_ratio = std::get<bool>(keep_aspect_ratio_it->second);
         
+        // Every image is an input document of one page
+        ProgressReporter progress("createPDFFromMultipleImage", JobIdOf(args), (int)input_paths.size(),
+                                  progress_listener());
+        progress.AddPages((int)input_paths.size());
+
         FPDF_DOCUMENT new_doc = FPDF_CreateNewDocument();
 
-        for (const auto& path : input_paths) {
+        // Adds the page of one image, or nothing if it cannot be read
+        auto add_image_page = [&](const std::string& path) {
             std::string current_path = path;
             bool is_temp = false;
             
@@ -206,14 +328,32 @@ namespace pdf_combiner {
             bool is_jpg = (path.find(".jpg") != std::string::npos || path.find(".JPG") != std::string::npos ||
                            path.find(".jpeg") != std::string::npos || path.find(".JPEG") != std::string::npos);
 
+            int w, h, c;
             if (is_heic) {
-                current_path = ProcessHeic(path);
-                if (current_path.empty()) continue;
-                is_temp = true;
-                is_jpg = true;
+                // Decoded in memory and re-encoded once, without temporary files
+                std::vector<unsigned char> pixels;
+                if (!ProcessHeic(path, w, h, pixels)) return;
+                int quality = 85;
+                if (max_width != 0 || max_height != 0) {
+                    int new_width = (max_width != 0) ? max_width : w;
+                    int new_height = (max_height != 0) ? (keep_aspect_ratio ? static_cast<int>(max_width * (static_cast<double>(h) / w)) : max_height) : h;
+                    std::vector<unsigned char> resized_data((size_t)new_width * new_height * 3);
+                    if (!stbir_resize_uint8_linear(pixels.data(), w, h, 0, resized_data.data(), new_width, new_height, 0, STBIR_RGB)) return;
+                    pixels.swap(resized_data);
+                    w = new_width; h = new_height;
+                    quality = 80;
+                }
+                std::vector<unsigned char> jpeg;
+                auto append = [](void* context, void* data, int size) {
+                    auto* out = static_cast<std::vector<unsigned char>*>(context);
+                    out->insert(out->end(), (unsigned char*)data, (unsigned char*)data + size);
+                };
+                if (stbi_write_jpg_to_func(append, &jpeg, w, h, 3, pixels.data(), quality)) {
+                    AppendJpegPage(new_doc, jpeg.data(), jpeg.size(), w, h);
+                }
+                return;
             }
 
-            int w, h, c;
             if (max_width != 0 || max_height != 0) {
                 unsigned char* pixels = stbi_load(current_path.c_str(), &w, &h, &c, 3);
                 if (pixels) {
@@ -250,38 +390,33 @@ namespace pdf_combiner {
             }
 
             if (is_jpg && !current_path.empty()) {
-                FPDF_PAGE new_page = FPDFPage_New(new_doc, FPDF_GetPageCount(new_doc), (double)w, (double)h);
-                FPDF_PAGEOBJECT image_obj = FPDFPageObj_NewImageObj(new_doc);
-                
                 std::ifstream file(current_path, std::ios::binary | std::ios::ate);
                 if (file.is_open()) {
                     std::streamsize size = file.tellg();
                     file.seekg(0, std::ios::beg);
-                    std::vector<char> buffer(size);
-                    if (file.read(buffer.data(), size)) {
-                        FPDF_FILEACCESS access;
-                        access.m_FileLen = (unsigned long)size;
-                        access.m_Param = buffer.data();
-                        access.m_GetBlock = [](void* param, unsigned long pos, unsigned char* buf, unsigned long sz) -> int {
-                            memcpy(buf, (char*)param + pos, sz);
-                            return 1;
-                        };
-                        FPDFImageObj_LoadJpegFileInline(nullptr, 0, image_obj, &access);
-                        FPDFPageObj_Transform(image_obj, (double)w, 0, 0, (double)h, 0, 0);
-                        FPDFPage_InsertObject(new_page, image_obj);
-                        FPDFPage_GenerateContent(new_page);
+                    std::vector<unsigned char> buffer(size);
+                    if (file.read((char*)buffer.data(), size)) {
+                        AppendJpegPage(new_doc, buffer.data(), buffer.size(), w, h);
                     }
                 }
-                FPDF_ClosePage(new_page);
             }
 
             if (is_temp) DeleteFileA(current_path.c_str());
+        };
+
+        for (const auto& path : input_paths) {
+            add_image_page(path);
+            progress.Advance(1);
+            progress.DocumentDone();
         }
 
         MyFileWrite fw;
         fw.version = 1; fw.WriteBlock = MyWriteBlock; fw.filename = output_path.c_str(); fw.file = nullptr;
         FPDF_SaveAsCopy(new_doc, (FPDF_FILEWRITE*)&fw, FPDF_NO_INCREMENTAL);
-        if (fw.file) fclose(fw.file);
+        if (fw.file) {
+            progress.Advance(0, (uint64_t)_ftelli64(fw.file));
+            fclose(fw.file);
+        }
         FPDF_CloseDocument(new_doc);
         result->Success(flutter::EncodableValue(output_path));
     }
@@ -294,6 +429,7 @@ namespace pdf_combiner {
         int max_height = std::get<int>(args.at(flutter::EncodableValue("height")));
         int compression = std::get<int>(args.at(flutter::EncodableValue("compression")));
         bool create_one_image = std::get<bool>(args.at(flutter::EncodableValue("createOneImage")));
+        ProgressReporter progress("createImageFromPDF", JobIdOf(args), 1, progress_listener());
         
         FPDF_DOCUMENT doc = FPDF_LoadDocument(input_path.c_str(), nullptr);
         if (!doc) {
@@ -302,6 +438,7 @@ namespace pdf_combiner {
         }
         
         int page_count = FPDF_GetPageCount(doc);
+        progress.AddPages(page_count);
         std::vector<flutter::EncodableValue> image_paths;
         
         if (create_one_image) {
@@ -324,9 +461,11 @@ namespace pdf_combiner {
                 FPDF_RenderPageBitmap(combined, pages[i], 0, current_y, (int)p_widths[i], (int)p_heights[i], 0, FPDF_ANNOT);
                 current_y += (int)p_heights[i];
                 FPDF_ClosePage(pages[i]);
+                progress.Advance(1);
             }
             std::string out_img = output_path + "/image.png";
             save_bitmap_to_png(combined, out_img, compression);
+            progress.Advance(0, FileSize(out_img));
             image_paths.push_back(flutter::EncodableValue(out_img));
             FPDFBitmap_Destroy(combined);
         } else {
@@ -342,9 +481,11 @@ namespace pdf_combiner {
                 image_paths.push_back(flutter::EncodableValue(out_img));
                 FPDFBitmap_Destroy(bitmap);
                 FPDF_ClosePage(page);
+                progress.Advance(1, FileSize(out_img));
             }
         }
         FPDF_CloseDocument(doc);
+        progress.DocumentDone();
         result->Success(flutter::EncodableValue(image_paths));
     }
 }
@@ -1,6 +1,7 @@
 #ifndef FLUTTER_PLUGIN_PDF_COMBINER_PLUGIN_H_
 #define FLUTTER_PLUGIN_PDF_COMBINER_PLUGIN_H_
 
+#include <flutter/event_channel.h>
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar_windows.h>
 #include <flutter/standard_method_codec.h>
@@ -8,6 +9,8 @@
 #include <memory>
 #include <string>
 
+#include "include/pdf_combiner/progress_reporter.h"
+
 namespace pdf_combiner {
 
 // Helper function declaration - Ahora convierte a PNG usando ImageMagick
@@ -39,6 +42,12 @@ class PdfCombinerPlugin : public flutter::Plugin {
   void create_image_from_pdf(const flutter::EncodableMap& args,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
 
+ private:
+  // Sends events to the progress channel while Dart listens to it.
+  ProgressListener progress_listener();
+
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>> progress_channel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> progress_sink_;
 };
 
 }  // namespace pdf_combiner
@@ -0,0 +1,48 @@
+#include "include/pdf_combiner/progress_reporter.h"
+
+namespace pdf_combiner {
+
+ProgressReporter::ProgressReporter(const std::string& method, const std::string& job_id, int document_count,
+                                   ProgressListener listener)
+    : listener_(std::move(listener)), start_(std::chrono::steady_clock::now()), last_sent_(start_) {
+    event_.method = method;
+    event_.job_id = job_id;
+    event_.document_count = document_count;
+}
+
+ProgressReporter::~ProgressReporter() {
+    event_.finished = true;
+    Send(std::chrono::steady_clock::now());
+}
+
+void ProgressReporter::AddPages(int pages) {
+    event_.total_pages += pages;
+    MaybeSend();
+}
+
+void ProgressReporter::Advance(int pages, uint64_t bytes) {
+    event_.pages_done += pages;
+    event_.bytes_written += bytes;
+    MaybeSend();
+}
+
+void ProgressReporter::DocumentDone() {
+    event_.documents_done++;
+    MaybeSend();
+}
+
+void ProgressReporter::MaybeSend() {
+    if (!listener_) return;
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_sent_ < std::chrono::milliseconds(kIntervalMillis)) return;
+    Send(now);
+}
+
+void ProgressReporter::Send(std::chrono::steady_clock::time_point now) {
+    if (!listener_) return;
+    last_sent_ = now;
+    event_.elapsed_micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+    listener_(event_);
+}
+
+} // namespace pdf_combiner
@@ -1,5 +1,6 @@
 #include "include/pdf_combiner/save_bitmap_to_png.h"
 #include <vector>
+#include "include/pdf_combiner/swizzle.h"
 #include "include/pdf_combiner/stb_image_write.h"
 
 namespace pdf_combiner {
@@ -13,18 +14,17 @@ bool save_bitmap_to_png(FPDF_BITMAP bitmap, const std::string& output_path, int
         return false;
     }
 
-    std::vector<uint8_t> rgba_buffer(width * height * 4);
-    uint8_t* src = static_cast<uint8_t*>(buffer);
-    uint8_t* dst = rgba_buffer.data();
+    std::vector<uint8_t> rgba_buffer((size_t)width * height * 4);
+    swizzle_rgba_bgra(static_cast<const uint8_t*>(buffer), (size_t)FPDFBitmap_GetStride(bitmap),
+                      rgba_buffer.data(), (size_t)width * 4, width, height, false);
 
-    for (int i = 0; i < width * height; i++) {
-        dst[0] = src[2];
-        dst[1] = src[1];
-        dst[2] = src[0];
-        dst[3] = src[3];
-        src += 4;
-        dst += 4;
-    }
+    // Map the ImageCompression value (0-100) to encoder effort: level 1 and
+    // the cheap Up filter for low values, up to level 9 and per-row adaptive
+    // filtering for the smallest files. Method calls run one at a time on the
+    // platform thread, so setting stb's globals here is safe.
+    int value = compression < 0 ? 0 : (compression > 100 ? 100 : compression);
+    stbi_write_png_compression_level = 1 + value * 8 / 100;
+    stbi_write_force_png_filter = value < 50 ? 2 : -1;
 
     return stbi_write_png(output_path.c_str(), width, height, 4, rgba_buffer.data(), width * 4) != 0;
 }
@@ -0,0 +1,126 @@
+#include "include/pdf_combiner/swizzle.h"
+
+#if defined(_M_X64) || defined(_M_IX86)
+#define PDF_COMBINER_SWIZZLE_X86 1
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#define PDF_COMBINER_SWIZZLE_NEON 1
+#include <arm64_neon.h>
+#endif
+
+namespace pdf_combiner {
+
+namespace {
+
+typedef void (*SwizzleRowFunction)(const uint8_t* src, uint8_t* dst, size_t pixels);
+
+void swizzle_row_scalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++) {
+        uint8_t r = src[0];
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = r;
+        dst[3] = src[3];
+        src += 4;
+        dst += 4;
+    }
+}
+
+#ifdef PDF_COMBINER_SWIZZLE_X86
+// MSVC accepts these intrinsics without /arch flags; they only run once the
+// CPU has been checked below.
+void swizzle_row_ssse3(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, mask));
+    }
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void swizzle_row_avx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i mask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, mask));
+    }
+    _mm256_zeroupper();
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+bool cpu_has_avx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;  // YMM state saved by the OS
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+
+bool cpu_has_ssse3() {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+}
+#endif
+
+#ifdef PDF_COMBINER_SWIZZLE_NEON
+void swizzle_row_neon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t r = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = r;
+        vst4q_u8(dst + i * 4, v);
+    }
+    swizzle_row_scalar(src + i * 4, dst + i * 4, pixels - i);
+}
+#endif
+
+SwizzleRowFunction swizzle_row_function() {
+    static const SwizzleRowFunction function = [] {
+#ifdef PDF_COMBINER_SWIZZLE_X86
+        if (cpu_has_avx2()) return &swizzle_row_avx2;
+        if (cpu_has_ssse3()) return &swizzle_row_ssse3;
+        return &swizzle_row_scalar;
+#elif defined(PDF_COMBINER_SWIZZLE_NEON)
+        return &swizzle_row_neon;
+#else
+        return &swizzle_row_scalar;
+#endif
+    }();
+    return function;
+}
+
+}  // namespace
+
+void swizzle_rgba_bgra(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+                       int width, int height, bool flip_vertically) {
+    if (width <= 0 || height <= 0) return;
+    SwizzleRowFunction swizzle_row = swizzle_row_function();
+    for (int y = 0; y < height; y++) {
+        int dst_y = flip_vertically ? height - 1 - y : y;
+        swizzle_row(src + (size_t)y * src_stride, dst + (size_t)dst_y * dst_stride, (size_t)width);
+    }
+}
+
+const char* swizzle_kernel_name() {
+    SwizzleRowFunction function = swizzle_row_function();
+#ifdef PDF_COMBINER_SWIZZLE_X86
+    if (function == &swizzle_row_avx2) return "avx2";
+    if (function == &swizzle_row_ssse3) return "ssse3";
+#elif defined(PDF_COMBINER_SWIZZLE_NEON)
+    if (function == &swizzle_row_neon) return "neon";
+#endif
+    return "scalar";
+}
+
+}  // namespace pdf_combiner